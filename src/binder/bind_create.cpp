@@ -112,7 +112,27 @@ auto Binder::BindCreate(duckdb_libpgquery::PGCreateStmt *pg_stmt) -> std::unique
     throw bustub::Exception("should have at least 1 column");
   }
 
-  return std::make_unique<CreateStatement>(std::move(table), std::move(columns));
+  // WITH (format = pax) or WITH (format = 'pax')
+  std::string format = "row";
+  if (pg_stmt->options != nullptr) {
+    for (auto c = pg_stmt->options->head; c != nullptr; c = lnext(c)) {
+      auto option = reinterpret_cast<duckdb_libpgquery::PGDefElem *>(c->data.ptr_value);
+      if (StringUtil::Lower(option->defname) != "format" || option->arg == nullptr) {
+        throw NotImplementedException(fmt::format("table option {} not supported", option->defname));
+      }
+      if (option->arg->type == duckdb_libpgquery::T_PGString) {
+        format = reinterpret_cast<duckdb_libpgquery::PGValue *>(option->arg)->val.str;
+      } else if (option->arg->type == duckdb_libpgquery::T_PGTypeName) {
+        auto type_name = reinterpret_cast<duckdb_libpgquery::PGTypeName *>(option->arg);
+        format = reinterpret_cast<duckdb_libpgquery::PGValue *>(type_name->names->tail->data.ptr_value)->val.str;
+      } else {
+        throw NotImplementedException("table format must be a name");
+      }
+      format = StringUtil::Lower(format);
+    }
+  }
+
+  return std::make_unique<CreateStatement>(std::move(table), std::move(columns), std::move(format));
 }
 
 auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<IndexStatement> {
@@ -129,7 +149,8 @@ auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<
     }
   }
 
-  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols));
+  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols),
+                                          stmt->accessMethod == nullptr ? "" : stmt->accessMethod);
 }
 
 }  // namespace bustub
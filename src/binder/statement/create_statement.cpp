@@ -5,11 +5,14 @@
 
 namespace bustub {
 
-CreateStatement::CreateStatement(std::string table, std::vector<Column> columns)
-    : BoundStatement(StatementType::CREATE_STATEMENT), table_(std::move(table)), columns_(std::move(columns)) {}
+CreateStatement::CreateStatement(std::string table, std::vector<Column> columns, std::string format)
+    : BoundStatement(StatementType::CREATE_STATEMENT),
+      table_(std::move(table)),
+      columns_(std::move(columns)),
+      format_(std::move(format)) {}
 
 auto CreateStatement::ToString() const -> std::string {
-  return fmt::format("BoundCreate {{\n  table={}\n  columns={}\n}}", table_, columns_);
+  return fmt::format("BoundCreate {{\n  table={}\n  columns={}\n  format={}\n}}", table_, columns_, format_);
 }
 
 }  // namespace bustub
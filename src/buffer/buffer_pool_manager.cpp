@@ -120,6 +120,37 @@ auto BufferPoolManager::FetchPage(page_id_t page_id, [[maybe_unused]] AccessType
   return ans;
 }
 
+auto BufferPoolManager::PrefetchPage(page_id_t page_id) -> bool {
+  std::lock_guard<std::mutex> lock(latch_);
+  if (page_table_.find(page_id) != page_table_.end()) {
+    return true;
+  }
+  if (free_list_.empty() && replacer_->Size() == 0) {
+    return false;
+  }
+  frame_id_t frame_id = 0;
+  if (!free_list_.empty()) {
+    frame_id = free_list_.front();
+    free_list_.pop_front();
+  } else {
+    replacer_->Evict(&frame_id);
+    if (pages_[frame_id].IsDirty()) {
+      disk_manager_->WritePage(pages_[frame_id].page_id_, pages_[frame_id].data_);
+    }
+    page_table_.erase(pages_[frame_id].page_id_);
+    pages_[frame_id].ResetMemory();
+  }
+  disk_manager_->ReadPage(page_id, pages_[frame_id].data_);
+  pages_[frame_id].page_id_ = page_id;
+  pages_[frame_id].pin_count_ = 0;
+  pages_[frame_id].is_dirty_ = false;
+  page_table_[page_id] = frame_id;
+  // not pinned, the page stays evictable until someone fetches it
+  replacer_->RecordAccess(frame_id, AccessType::Scan);
+  replacer_->SetEvictable(frame_id, true);
+  return true;
+}
+
 auto BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty, [[maybe_unused]] AccessType access_type) -> bool {
   std::lock_guard<std::mutex> lock(latch_);
   if (page_table_.find(page_id) == page_table_.end() || pages_[page_table_[page_id]].pin_count_ <= 0) {
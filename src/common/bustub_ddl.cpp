@@ -41,8 +41,17 @@
 namespace bustub {
 
 void BustubInstance::HandleCreateStatement(Transaction *txn, const CreateStatement &stmt, ResultWriter &writer) {
+  TableFormat format;
+  if (stmt.format_ == "row") {
+    format = TableFormat::Row;
+  } else if (stmt.format_ == "pax") {
+    format = TableFormat::Pax;
+  } else {
+    throw NotImplementedException(fmt::format("table format {} not supported", stmt.format_));
+  }
+
   std::unique_lock<std::shared_mutex> l(catalog_lock_);
-  auto info = catalog_->CreateTable(txn, stmt.table_, Schema(stmt.columns_));
+  auto info = catalog_->CreateTable(txn, stmt.table_, Schema(stmt.columns_), true, format);
   l.unlock();
 
   if (info == nullptr) {
@@ -53,12 +62,11 @@ void BustubInstance::HandleCreateStatement(Transaction *txn, const CreateStateme
 
 void BustubInstance::HandleIndexStatement(Transaction *txn, const IndexStatement &stmt, ResultWriter &writer) {
   std::vector<uint32_t> col_ids;
+  bool integer_key = true;
   for (const auto &col : stmt.cols_) {
     auto idx = stmt.table_->schema_.GetColIdx(col->col_name_.back());
     col_ids.push_back(idx);
-    if (stmt.table_->schema_.GetColumn(idx).GetType() != TypeId::INTEGER) {
-      throw NotImplementedException("only support creating index on integer column");
-    }
+    integer_key = integer_key && stmt.table_->schema_.GetColumn(idx).GetType() == TypeId::INTEGER;
   }
   auto key_schema = Schema::CopySchema(&stmt.table_->schema_, col_ids);
 
@@ -67,14 +75,50 @@ void BustubInstance::HandleIndexStatement(Transaction *txn, const IndexStatement
   //
   // You can also create clustered index that directly stores value inside the index by modifying the value type.
 
-  if (col_ids.empty() || col_ids.size() > 2) {
-    throw NotImplementedException("only support creating index with exactly one or two columns");
+  if (col_ids.empty()) {
+    throw NotImplementedException("index must have at least one column");
+  }
+
+  // A key tuple holds the inlined columns followed by the data of the variable-length ones
+  // (length, characters and terminator). Pick the narrowest key type that holds the longest key.
+  // Unused key bytes are zero and cost nothing in the B+ tree pages.
+  size_t key_size = key_schema.GetLength();
+  for (auto col_idx : key_schema.GetUnlinedColumns()) {
+    key_size += sizeof(uint32_t) + key_schema.GetColumn(col_idx).GetLength() + 1;
+  }
+
+  // `USING betree` asks for the write-optimized buffered tree, `USING hash` for the extendible hash table, anything
+  // else gets the B+ tree
+  IndexType index_type = IndexType::BPlusTreeIndex;
+  if (stmt.index_type_ == "betree" || stmt.index_type_ == "buffered") {
+    index_type = IndexType::BufferedTreeIndex;
+  } else if (stmt.index_type_ == "hash") {
+    index_type = IndexType::HashTableIndex;
+  } else if (!stmt.index_type_.empty() && stmt.index_type_ != "art" && stmt.index_type_ != "btree") {
+    throw NotImplementedException(fmt::format("index type {} is not supported", stmt.index_type_));
   }
 
   std::unique_lock<std::shared_mutex> l(catalog_lock_);
-  auto info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
-      txn, stmt.index_name_, stmt.table_->table_, stmt.table_->schema_, key_schema, col_ids, TWO_INTEGER_SIZE,
-      IntegerHashFunctionType{});
+  IndexInfo *info;
+  if (integer_key && col_ids.size() <= 2) {
+    info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
+        txn, stmt.index_name_, stmt.table_->table_, stmt.table_->schema_, key_schema, col_ids, TWO_INTEGER_SIZE,
+        IntegerHashFunctionType{}, index_type);
+  } else if (key_size <= 32) {
+    info = catalog_->CreateIndex<GenericKey<32>, RID, GenericComparator<32>>(
+        txn, stmt.index_name_, stmt.table_->table_, stmt.table_->schema_, key_schema, col_ids, 32,
+        HashFunction<GenericKey<32>>{}, index_type);
+  } else if (key_size <= 64) {
+    info = catalog_->CreateIndex<GenericKey<64>, RID, GenericComparator<64>>(
+        txn, stmt.index_name_, stmt.table_->table_, stmt.table_->schema_, key_schema, col_ids, 64,
+        HashFunction<GenericKey<64>>{}, index_type);
+  } else if (key_size <= 128) {
+    info = catalog_->CreateIndex<GenericKey<128>, RID, GenericComparator<128>>(
+        txn, stmt.index_name_, stmt.table_->table_, stmt.table_->schema_, key_schema, col_ids, 128,
+        HashFunction<GenericKey<128>>{}, index_type);
+  } else {
+    throw NotImplementedException("index key is longer than 128 bytes");
+  }
   l.unlock();
 
   if (info == nullptr) {
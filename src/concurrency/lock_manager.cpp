@@ -26,6 +26,11 @@ auto LockManager::LockRow(Transaction *txn, LockMode lock_mode, const table_oid_
   return true;
 }
 
+auto LockManager::LockRows(Transaction *txn, LockMode lock_mode, const table_oid_t &oid, const std::vector<RID> &rids)
+    -> bool {
+  return std::all_of(rids.begin(), rids.end(), [&](const RID &rid) { return LockRow(txn, lock_mode, oid, rid); });
+}
+
 auto LockManager::UnlockRow(Transaction *txn, const table_oid_t &oid, const RID &rid, bool force) -> bool {
   return true;
 }
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <utility>
@@ -26,7 +27,16 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::DiskExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                          const KeyComparator &comparator, HashFunction<KeyType> hash_fn)
     : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
-  //  implement me!
+  // a single empty bucket of local depth 0
+  BasicPageGuard dir_guard = buffer_pool_manager_->NewPageGuarded(&directory_page_id_);
+  page_id_t bucket_page_id;
+  BasicPageGuard bucket_guard = buffer_pool_manager_->NewPageGuarded(&bucket_page_id);
+  auto dir_page = dir_guard.AsMut<HashTableDirectoryPage>();
+  bucket_guard.AsMut<HASH_TABLE_BUCKET_TYPE>()->Init();
+  dir_page->SetPageId(directory_page_id_);
+  dir_page->SetLSN(INVALID_LSN);
+  dir_page->SetBucketPageId(0, bucket_page_id);
+  dir_page->SetLocalDepth(0, 0);
 }
 
 /*****************************************************************************
@@ -45,31 +55,82 @@ auto HASH_TABLE_TYPE::Hash(KeyType key) -> uint32_t {
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-inline auto HASH_TABLE_TYPE::KeyToDirectoryIndex(KeyType key, HashTableDirectoryPage *dir_page) -> uint32_t {
-  return 0;
+inline auto HASH_TABLE_TYPE::KeyToDirectoryIndex(KeyType key, const HashTableDirectoryPage *dir_page) -> uint32_t {
+  return Hash(key) & dir_page->GetGlobalDepthMask();
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-inline auto HASH_TABLE_TYPE::KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page) -> page_id_t {
-  return 0;
+inline auto HASH_TABLE_TYPE::KeyToPageId(KeyType key, const HashTableDirectoryPage *dir_page) -> page_id_t {
+  return dir_page->GetBucketPageId(KeyToDirectoryIndex(key, dir_page));
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::FetchDirectoryPage() -> HashTableDirectoryPage * {
-  return nullptr;
+  return reinterpret_cast<HashTableDirectoryPage *>(buffer_pool_manager_->FetchPage(directory_page_id_)->GetData());
 }
 
+/*
+ * The directory page is only latched while the mapping is read. A split of the
+ * bucket may move key elsewhere before the bucket is latched, so the mapping is
+ * read again once it is: the bucket latch keeps it from changing after that.
+ */
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BUCKET_TYPE * {
-  return nullptr;
+auto HASH_TABLE_TYPE::FetchBucketRead(const KeyType &key) -> ReadPageGuard {
+  page_id_t bucket_page_id = KeyToPageId(key, buffer_pool_manager_->FetchPageRead(directory_page_id_)
+                                                  .template As<HashTableDirectoryPage>());
+  while (true) {
+    ReadPageGuard bucket_guard = buffer_pool_manager_->FetchPageRead(bucket_page_id);
+    page_id_t page_id = KeyToPageId(key, buffer_pool_manager_->FetchPageRead(directory_page_id_)
+                                             .template As<HashTableDirectoryPage>());
+    if (page_id == bucket_page_id) {
+      return bucket_guard;
+    }
+    bucket_page_id = page_id;
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::FetchBucketWrite(const KeyType &key, uint32_t *bucket_idx) -> WritePageGuard {
+  page_id_t bucket_page_id = KeyToPageId(key, buffer_pool_manager_->FetchPageRead(directory_page_id_)
+                                                  .template As<HashTableDirectoryPage>());
+  while (true) {
+    WritePageGuard bucket_guard = buffer_pool_manager_->FetchPageWrite(bucket_page_id);
+    ReadPageGuard dir_guard = buffer_pool_manager_->FetchPageRead(directory_page_id_);
+    auto dir_page = dir_guard.As<HashTableDirectoryPage>();
+    uint32_t idx = KeyToDirectoryIndex(key, dir_page);
+    if (dir_page->GetBucketPageId(idx) == bucket_page_id) {
+      if (bucket_idx != nullptr) {
+        *bucket_idx = idx;
+      }
+      return bucket_guard;
+    }
+    bucket_page_id = dir_page->GetBucketPageId(idx);
+  }
 }
 
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
+/*
+ * Two page accesses: the directory page and a single bucket, unless the bucket
+ * continues on overflow pages. Those are only reached through the bucket, so
+ * its latch protects them.
+ */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool {
-  return false;
+  table_latch_.RLock();
+  ReadPageGuard bucket_guard = FetchBucketRead(key);
+  auto bucket = bucket_guard.As<HASH_TABLE_BUCKET_TYPE>();
+  bool found = bucket->GetValue(key, comparator_, result);
+  for (page_id_t page_id = bucket->GetOverflowPageId(); page_id != INVALID_PAGE_ID;) {
+    ReadPageGuard overflow_guard = buffer_pool_manager_->FetchPageRead(page_id);
+    auto overflow = overflow_guard.As<HASH_TABLE_BUCKET_TYPE>();
+    found = overflow->GetValue(key, comparator_, result) || found;
+    page_id = overflow->GetOverflowPageId();
+  }
+  bucket_guard.Drop();
+  table_latch_.RUnlock();
+  return found;
 }
 
 /*****************************************************************************
@@ -77,12 +138,203 @@ auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
+  table_latch_.RLock();
+  WritePageGuard bucket_guard = FetchBucketWrite(key);
+  auto result = ChainInsert(bucket_guard.AsMut<HASH_TABLE_BUCKET_TYPE>(), key, value, false);
+  bucket_guard.Drop();
+  table_latch_.RUnlock();
+  if (result != ChainInsertResult::Full) {
+    return result == ChainInsertResult::Inserted;
+  }
+  return SplitInsert(transaction, key, value);
+}
+
+/*
+ * The whole chain is checked for the pair before any page of it takes it.
+ * Overflow pages are latched in chain order, after the bucket page.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::ChainInsert(HASH_TABLE_BUCKET_TYPE *bucket, const KeyType &key, const ValueType &value,
+                                  bool append_overflow) -> ChainInsertResult {
+  std::vector<ValueType> values;
+  bucket->GetValue(key, comparator_, &values);
+  for (page_id_t page_id = bucket->GetOverflowPageId(); page_id != INVALID_PAGE_ID;) {
+    ReadPageGuard overflow_guard = buffer_pool_manager_->FetchPageRead(page_id);
+    auto overflow = overflow_guard.As<HASH_TABLE_BUCKET_TYPE>();
+    overflow->GetValue(key, comparator_, &values);
+    page_id = overflow->GetOverflowPageId();
+  }
+  if (std::find(values.begin(), values.end(), value) != values.end()) {
+    return ChainInsertResult::Duplicate;
+  }
+
+  if (!bucket->IsFull()) {
+    bucket->Insert(key, value, comparator_);
+    return ChainInsertResult::Inserted;
+  }
+  WritePageGuard last_guard;
+  HASH_TABLE_BUCKET_TYPE *last = bucket;
+  while (last->GetOverflowPageId() != INVALID_PAGE_ID) {
+    last_guard = buffer_pool_manager_->FetchPageWrite(last->GetOverflowPageId());
+    last = last_guard.AsMut<HASH_TABLE_BUCKET_TYPE>();
+    if (!last->IsFull()) {
+      last->Insert(key, value, comparator_);
+      return ChainInsertResult::Inserted;
+    }
+  }
+  if (!append_overflow) {
+    return ChainInsertResult::Full;
+  }
+  page_id_t overflow_page_id;
+  BasicPageGuard overflow_guard = buffer_pool_manager_->NewPageGuarded(&overflow_page_id);
+  auto overflow = overflow_guard.AsMut<HASH_TABLE_BUCKET_TYPE>();
+  overflow->Init();
+  overflow->Insert(key, value, comparator_);
+  last->SetOverflowPageId(overflow_page_id);
+  return ChainInsertResult::Inserted;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::PruneOverflow(HASH_TABLE_BUCKET_TYPE *bucket) {
+  WritePageGuard prev_guard;
+  HASH_TABLE_BUCKET_TYPE *prev = bucket;
+  while (prev->GetOverflowPageId() != INVALID_PAGE_ID) {
+    page_id_t page_id = prev->GetOverflowPageId();
+    WritePageGuard overflow_guard = buffer_pool_manager_->FetchPageWrite(page_id);
+    auto overflow = overflow_guard.AsMut<HASH_TABLE_BUCKET_TYPE>();
+    if (overflow->IsEmpty()) {
+      prev->SetOverflowPageId(overflow->GetOverflowPageId());
+      overflow_guard.Drop();
+      buffer_pool_manager_->DeletePage(page_id);
+      continue;
+    }
+    prev_guard = std::move(overflow_guard);
+    prev = overflow;
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::CanSplit(const HASH_TABLE_BUCKET_TYPE *bucket, const KeyType &key) -> bool {
+  const uint32_t addressable = DIRECTORY_ARRAY_SIZE - 1;
+  uint32_t hash = Hash(key);
+  auto differs = [&](const HASH_TABLE_BUCKET_TYPE *page) {
+    for (uint32_t i = 0; i < BUCKET_ARRAY_SIZE && page->IsOccupied(i); i++) {
+      if (page->IsReadable(i) && ((Hash(page->KeyAt(i)) ^ hash) & addressable) != 0) {
+        return true;
+      }
+    }
+    return false;
+  };
+  if (differs(bucket)) {
+    return true;
+  }
+  for (page_id_t page_id = bucket->GetOverflowPageId(); page_id != INVALID_PAGE_ID;) {
+    ReadPageGuard overflow_guard = buffer_pool_manager_->FetchPageRead(page_id);
+    auto overflow = overflow_guard.As<HASH_TABLE_BUCKET_TYPE>();
+    if (differs(overflow)) {
+      return true;
+    }
+    page_id = overflow->GetOverflowPageId();
+  }
   return false;
 }
 
+/*
+ * Split the bucket of key until the pair fits. A bucket below the global depth
+ * is split while table_latch_ is held in shared mode, with only the bucket and,
+ * for the directory update, the directory page write latched. Only a bucket at
+ * the global depth needs the directory to grow first, which takes table_latch_
+ * in exclusive mode. A bucket whose pairs all share the hash bits of key that
+ * the largest directory addresses gains nothing from a split, the pair goes on
+ * an overflow page instead.
+ */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  while (true) {
+    table_latch_.RLock();
+    uint32_t bucket_idx;
+    WritePageGuard bucket_guard = FetchBucketWrite(key, &bucket_idx);
+    auto bucket = bucket_guard.AsMut<HASH_TABLE_BUCKET_TYPE>();
+    auto result = ChainInsert(bucket, key, value, !CanSplit(bucket, key));
+    if (result != ChainInsertResult::Full) {
+      bucket_guard.Drop();
+      table_latch_.RUnlock();
+      return result == ChainInsertResult::Inserted;
+    }
+
+    uint32_t local_depth;
+    uint32_t global_depth;
+    {
+      ReadPageGuard dir_guard = buffer_pool_manager_->FetchPageRead(directory_page_id_);
+      local_depth = dir_guard.As<HashTableDirectoryPage>()->GetLocalDepth(bucket_idx);
+      global_depth = dir_guard.As<HashTableDirectoryPage>()->GetGlobalDepth();
+    }
+    if (local_depth < global_depth) {
+      SplitBucket(bucket_idx, &bucket_guard);
+      bucket_guard.Drop();
+      table_latch_.RUnlock();
+      continue;
+    }
+    bucket_guard.Drop();
+    table_latch_.RUnlock();
+
+    // the directory has to grow, unless someone else grew it in between
+    table_latch_.WLock();
+    {
+      WritePageGuard dir_guard = buffer_pool_manager_->FetchPageWrite(directory_page_id_);
+      auto dir_page = dir_guard.AsMut<HashTableDirectoryPage>();
+      uint32_t idx = KeyToDirectoryIndex(key, dir_page);
+      if (dir_page->GetLocalDepth(idx) == dir_page->GetGlobalDepth()) {
+        // a bucket that can be split does not use every hash bit the directory can address
+        BUSTUB_ASSERT(dir_page->Size() * 2 <= DIRECTORY_ARRAY_SIZE, "the directory cannot grow");
+        dir_page->IncrGlobalDepth();
+      }
+    }
+    table_latch_.WUnlock();
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::SplitBucket(uint32_t bucket_idx, WritePageGuard *bucket_guard) {
+  auto bucket = bucket_guard->AsMut<HASH_TABLE_BUCKET_TYPE>();
+  // bucket_idx is stable: only a split of this bucket changes its local depth
+  uint32_t local_depth =
+      buffer_pool_manager_->FetchPageRead(directory_page_id_).template As<HashTableDirectoryPage>()->GetLocalDepth(
+          bucket_idx);
+  uint32_t high_bit = 1U << local_depth;
+
+  // fill the split image before the directory makes it reachable, it gets overflow pages of its own if need be
+  page_id_t image_page_id;
+  BasicPageGuard image_guard = buffer_pool_manager_->NewPageGuarded(&image_page_id);
+  auto image = image_guard.AsMut<HASH_TABLE_BUCKET_TYPE>();
+  image->Init();
+  auto move_pairs = [&](HASH_TABLE_BUCKET_TYPE *page) {
+    for (uint32_t i = 0; i < BUCKET_ARRAY_SIZE && page->IsOccupied(i); i++) {
+      if (page->IsReadable(i) && (Hash(page->KeyAt(i)) & high_bit) != 0) {
+        ChainInsert(image, page->KeyAt(i), page->ValueAt(i), true);
+        page->RemoveAt(i);
+      }
+    }
+  };
+  move_pairs(bucket);
+  for (page_id_t page_id = bucket->GetOverflowPageId(); page_id != INVALID_PAGE_ID;) {
+    WritePageGuard overflow_guard = buffer_pool_manager_->FetchPageWrite(page_id);
+    auto overflow = overflow_guard.AsMut<HASH_TABLE_BUCKET_TYPE>();
+    move_pairs(overflow);
+    page_id = overflow->GetOverflowPageId();
+  }
+  PruneOverflow(bucket);
+  image_guard.Drop();
+
+  WritePageGuard dir_guard = buffer_pool_manager_->FetchPageWrite(directory_page_id_);
+  auto dir_page = dir_guard.AsMut<HashTableDirectoryPage>();
+  uint32_t low_bits = bucket_idx & (high_bit - 1);
+  for (uint32_t idx = low_bits; idx < dir_page->Size(); idx += high_bit) {
+    dir_page->SetLocalDepth(idx, local_depth + 1);
+    if ((idx & high_bit) != 0) {
+      dir_page->SetBucketPageId(idx, image_page_id);
+    }
+  }
 }
 
 /*****************************************************************************
@@ -90,14 +342,78 @@ auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key,
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  table_latch_.RLock();
+  WritePageGuard bucket_guard = FetchBucketWrite(key);
+  auto bucket = bucket_guard.AsMut<HASH_TABLE_BUCKET_TYPE>();
+  bool removed = bucket->Remove(key, value, comparator_);
+  for (page_id_t page_id = bucket->GetOverflowPageId(); !removed && page_id != INVALID_PAGE_ID;) {
+    WritePageGuard overflow_guard = buffer_pool_manager_->FetchPageWrite(page_id);
+    auto overflow = overflow_guard.AsMut<HASH_TABLE_BUCKET_TYPE>();
+    removed = overflow->Remove(key, value, comparator_);
+    page_id = overflow->GetOverflowPageId();
+  }
+  if (removed) {
+    PruneOverflow(bucket);
+  }
+  bool empty = bucket->IsEmpty() && bucket->GetOverflowPageId() == INVALID_PAGE_ID;
+  bucket_guard.Drop();
+  table_latch_.RUnlock();
+  if (removed && empty) {
+    Merge(transaction, key, value);
+  }
+  return removed;
 }
 
 /*****************************************************************************
  * MERGE
  *****************************************************************************/
+/*
+ * Fold the empty bucket of key into its split image, for as long as the bucket
+ * that is left is empty and has a split image of the same local depth, then
+ * shrink the directory as far as it goes.
+ */
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {}
+void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.WLock();
+  WritePageGuard dir_guard = buffer_pool_manager_->FetchPageWrite(directory_page_id_);
+  auto dir_page = dir_guard.AsMut<HashTableDirectoryPage>();
+  uint32_t bucket_idx = KeyToDirectoryIndex(key, dir_page);
+  while (true) {
+    uint32_t local_depth = dir_page->GetLocalDepth(bucket_idx);
+    if (local_depth == 0) {
+      break;
+    }
+    uint32_t image_idx = dir_page->GetSplitImageIndex(bucket_idx);
+    if (dir_page->GetLocalDepth(image_idx) != local_depth) {
+      break;
+    }
+    page_id_t bucket_page_id = dir_page->GetBucketPageId(bucket_idx);
+    page_id_t image_page_id = dir_page->GetBucketPageId(image_idx);
+    {
+      ReadPageGuard bucket_guard = buffer_pool_manager_->FetchPageRead(bucket_page_id);
+      auto bucket = bucket_guard.As<HASH_TABLE_BUCKET_TYPE>();
+      if (!bucket->IsEmpty() || bucket->GetOverflowPageId() != INVALID_PAGE_ID) {
+        break;
+      }
+    }
+
+    for (uint32_t idx = 0; idx < dir_page->Size(); idx++) {
+      page_id_t page_id = dir_page->GetBucketPageId(idx);
+      if (page_id == bucket_page_id || page_id == image_page_id) {
+        dir_page->SetBucketPageId(idx, image_page_id);
+        dir_page->DecrLocalDepth(idx);
+      }
+    }
+    buffer_pool_manager_->DeletePage(bucket_page_id);
+    // the merged bucket may in turn be empty
+    bucket_idx = image_idx & dir_page->GetLocalDepthMask(image_idx);
+  }
+  while (dir_page->CanShrink()) {
+    dir_page->DecrGlobalDepth();
+  }
+  dir_guard.Drop();
+  table_latch_.WUnlock();
+}
 
 /*****************************************************************************
  * GETGLOBALDEPTH - DO NOT TOUCH
@@ -134,5 +450,6 @@ template class DiskExtendibleHashTable<GenericKey<8>, RID, GenericComparator<8>>
 template class DiskExtendibleHashTable<GenericKey<16>, RID, GenericComparator<16>>;
 template class DiskExtendibleHashTable<GenericKey<32>, RID, GenericComparator<32>>;
 template class DiskExtendibleHashTable<GenericKey<64>, RID, GenericComparator<64>>;
+template class DiskExtendibleHashTable<GenericKey<128>, RID, GenericComparator<128>>;
 
 }  // namespace bustub
@@ -10,7 +10,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -23,31 +25,172 @@
 namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                      const KeyComparator &comparator, size_t num_buckets,
-                                      HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {}
+LINEAR_PROBE_HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                                                   const KeyComparator &comparator, size_t num_buckets,
+                                                   HashFunction<KeyType> hash_fn)
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  BasicPageGuard header_guard = buffer_pool_manager_->NewPageGuarded(&header_page_id_);
+  auto header_page = header_guard.AsMut<HashTableHeaderPage>();
+  header_page->SetPageId(header_page_id_);
+  header_page->SetLSN(INVALID_LSN);
+  CreateNewBlockPages(header_page,
+                      std::min(HASH_TABLE_MAX_BLOCKS, (std::max<size_t>(num_buckets, 1) - 1) / BLOCK_ARRAY_SIZE + 1));
+}
 
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool {
-  return false;
+auto LINEAR_PROBE_HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key,
+                                            std::vector<ValueType> *result) -> bool {
+  table_latch_.RLock();
+  bool found = GetValueLatchFree(transaction, key, result);
+  table_latch_.RUnlock();
+  return found;
+}
+
+/*
+ * Entries that were not migrated yet are found in the old layout, the rest in
+ * the current one. A pair is only ever in one of them.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LINEAR_PROBE_HASH_TABLE_TYPE::GetValueLatchFree(Transaction *transaction, const KeyType &key,
+                                                     std::vector<ValueType> *result) -> bool {
+  size_t found = result->size();
+  auto collect = [&](const HASH_TABLE_BLOCK_TYPE *block, slot_offset_t offset) {
+    if (comparator_(block->KeyAt(offset), key) == 0) {
+      result->push_back(block->ValueAt(offset));
+    }
+    return false;
+  };
+  Probe(header_page_id_, key, collect);
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    Probe(old_header_page_id_, key, collect);
+  }
+  return result->size() > found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename Visitor>
+auto LINEAR_PROBE_HASH_TABLE_TYPE::Probe(page_id_t header_page_id, const KeyType &key, Visitor &&visit) -> size_t {
+  BasicPageGuard header_guard = buffer_pool_manager_->FetchPageBasic(header_page_id);
+  auto header_page = header_guard.As<HashTableHeaderPage>();
+  size_t size = header_page->GetSize();
+  size_t home = hash_fn_.GetHash(key) % size;
+
+  BasicPageGuard block_guard;
+  size_t block_index = SIZE_MAX;
+  for (size_t i = 0; i < size; i++) {
+    size_t slot = (home + i) % size;
+    if (slot / BLOCK_ARRAY_SIZE != block_index) {
+      block_index = slot / BLOCK_ARRAY_SIZE;
+      block_guard = buffer_pool_manager_->FetchPageBasic(GetBlockPageId(header_page, block_index));
+    }
+    auto block = block_guard.template As<HASH_TABLE_BLOCK_TYPE>();
+    slot_offset_t offset = slot % BLOCK_ARRAY_SIZE;
+    if (!block->IsOccupied(offset)) {
+      return slot;
+    }
+    if (block->IsReadable(offset) && visit(block, offset)) {
+      return slot;
+    }
+  }
+  return size;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LINEAR_PROBE_HASH_TABLE_TYPE::GetBlockPageId(const HashTableHeaderPage *header_page, size_t block_index)
+    -> page_id_t {
+  if (header_page->GetSize() / BLOCK_ARRAY_SIZE <= HASH_TABLE_HEADER_MAX_BLOCKS) {
+    return header_page->GetBlockPageId(block_index);
+  }
+  BasicPageGuard directory_guard =
+      buffer_pool_manager_->FetchPageBasic(header_page->GetBlockPageId(block_index / HASH_TABLE_HEADER_MAX_BLOCKS));
+  return directory_guard.As<HashTableHeaderPage>()->GetBlockPageId(block_index % HASH_TABLE_HEADER_MAX_BLOCKS);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LINEAR_PROBE_HASH_TABLE_TYPE::FindPair(page_id_t header_page_id, const KeyType &key, const ValueType &value)
+    -> std::optional<size_t> {
+  bool found = false;
+  size_t slot = Probe(header_page_id, key, [&](const HASH_TABLE_BLOCK_TYPE *block, slot_offset_t offset) {
+    found = comparator_(block->KeyAt(offset), key) == 0 && block->ValueAt(offset) == value;
+    return found;
+  });
+  return found ? std::make_optional(slot) : std::nullopt;
 }
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+auto LINEAR_PROBE_HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value)
+    -> bool {
+  table_latch_.WLock();
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    MigrateBlock();
+  }
+  if (FindPair(header_page_id_, key, value).has_value() ||
+      (old_header_page_id_ != INVALID_PAGE_ID && FindPair(old_header_page_id_, key, value).has_value())) {
+    table_latch_.WUnlock();
+    return false;
+  }
+
+  // probe sequences get long beyond half full
+  size_t size = buffer_pool_manager_->FetchPageBasic(header_page_id_).template As<HashTableHeaderPage>()->GetSize();
+  if ((num_occupied_ + 1) * 2 > size) {
+    StartResize(size);
+  }
+  bool inserted = ResizeInsert(key, value);
+  table_latch_.WUnlock();
+  if (!inserted) {
+    // only a layout of HASH_TABLE_MAX_BLOCKS blocks stops doubling, and fills up
+    throw Exception("linear probe hash table is full");
+  }
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LINEAR_PROBE_HASH_TABLE_TYPE::ResizeInsert(const KeyType &key, const ValueType &value) -> bool {
+  BasicPageGuard header_guard = buffer_pool_manager_->FetchPageBasic(header_page_id_);
+  auto header_page = header_guard.As<HashTableHeaderPage>();
+  size_t slot = Probe(header_page_id_, key, [](const HASH_TABLE_BLOCK_TYPE *block, slot_offset_t offset) {
+    return false;
+  });
+  if (slot == header_page->GetSize()) {
+    return false;
+  }
+  BasicPageGuard block_guard =
+      buffer_pool_manager_->FetchPageBasic(GetBlockPageId(header_page, slot / BLOCK_ARRAY_SIZE));
+  block_guard.AsMut<HASH_TABLE_BLOCK_TYPE>()->Insert(slot % BLOCK_ARRAY_SIZE, key, value);
+  ++num_occupied_;
+  return true;
 }
 
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
+auto LINEAR_PROBE_HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value)
+    -> bool {
+  table_latch_.WLock();
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    MigrateBlock();
+  }
+  for (page_id_t header_page_id : {header_page_id_, old_header_page_id_}) {
+    if (header_page_id == INVALID_PAGE_ID) {
+      continue;
+    }
+    if (auto slot = FindPair(header_page_id, key, value); slot.has_value()) {
+      BasicPageGuard header_guard = buffer_pool_manager_->FetchPageBasic(header_page_id);
+      page_id_t block_page_id = GetBlockPageId(header_guard.As<HashTableHeaderPage>(), *slot / BLOCK_ARRAY_SIZE);
+      buffer_pool_manager_->FetchPageBasic(block_page_id).template AsMut<HASH_TABLE_BLOCK_TYPE>()->Remove(
+          *slot % BLOCK_ARRAY_SIZE);
+      table_latch_.WUnlock();
+      return true;
+    }
+  }
+  table_latch_.WUnlock();
   return false;
 }
 
@@ -55,14 +198,125 @@ auto HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const
  * RESIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Resize(size_t initial_size) {}
+void LINEAR_PROBE_HASH_TABLE_TYPE::Resize(size_t initial_size) {
+  table_latch_.WLock();
+  StartResize(initial_size);
+  table_latch_.WUnlock();
+}
+
+/*
+ * Only one layout can be migrated at a time: a resize that comes before the
+ * last one is done migrates what is left at once.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LINEAR_PROBE_HASH_TABLE_TYPE::StartResize(size_t initial_size) {
+  size_t num_blocks = std::min(HASH_TABLE_MAX_BLOCKS, (2 * initial_size - 1) / BLOCK_ARRAY_SIZE + 1);
+  if (num_blocks * BLOCK_ARRAY_SIZE <=
+      buffer_pool_manager_->FetchPageBasic(header_page_id_).template As<HashTableHeaderPage>()->GetSize()) {
+    return;
+  }
+  while (old_header_page_id_ != INVALID_PAGE_ID) {
+    MigrateBlock();
+  }
+
+  page_id_t new_header_page_id;
+  BasicPageGuard header_guard = buffer_pool_manager_->NewPageGuarded(&new_header_page_id);
+  auto header_page = header_guard.AsMut<HashTableHeaderPage>();
+  header_page->SetPageId(new_header_page_id);
+  header_page->SetLSN(INVALID_LSN);
+  CreateNewBlockPages(header_page, num_blocks);
+
+  old_header_page_id_ = header_page_id_;
+  header_page_id_ = new_header_page_id;
+  next_migrate_block_ = 0;
+  num_occupied_ = 0;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LINEAR_PROBE_HASH_TABLE_TYPE::MigrateBlock() {
+  BasicPageGuard old_header_guard = buffer_pool_manager_->FetchPageBasic(old_header_page_id_);
+  auto old_header_page = old_header_guard.As<HashTableHeaderPage>();
+  {
+    BasicPageGuard block_guard =
+        buffer_pool_manager_->FetchPageBasic(GetBlockPageId(old_header_page, next_migrate_block_));
+    auto block = block_guard.AsMut<HASH_TABLE_BLOCK_TYPE>();
+    for (slot_offset_t offset = 0; offset < BLOCK_ARRAY_SIZE; offset++) {
+      if (block->IsReadable(offset)) {
+        ResizeInsert(block->KeyAt(offset), block->ValueAt(offset));
+        // the tombstone keeps the probe sequences through this slot intact
+        block->Remove(offset);
+      }
+    }
+  }
+  if (++next_migrate_block_ == old_header_page->GetSize() / BLOCK_ARRAY_SIZE) {
+    old_header_guard.Drop();
+    DeleteBlockPages(old_header_page_id_);
+    old_header_page_id_ = INVALID_PAGE_ID;
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LINEAR_PROBE_HASH_TABLE_TYPE::DeleteBlockPages(page_id_t old_header_page_id) {
+  std::vector<page_id_t> block_page_ids;
+  {
+    BasicPageGuard header_guard = buffer_pool_manager_->FetchPageBasic(old_header_page_id);
+    auto header_page = header_guard.As<HashTableHeaderPage>();
+    for (size_t i = 0; i < header_page->GetSize() / BLOCK_ARRAY_SIZE; i++) {
+      block_page_ids.push_back(GetBlockPageId(header_page, i));
+    }
+    if (header_page->GetSize() / BLOCK_ARRAY_SIZE > HASH_TABLE_HEADER_MAX_BLOCKS) {
+      for (size_t i = 0; i < header_page->NumBlocks(); i++) {
+        block_page_ids.push_back(header_page->GetBlockPageId(i));
+      }
+    }
+  }
+  for (page_id_t block_page_id : block_page_ids) {
+    buffer_pool_manager_->DeletePage(block_page_id);
+  }
+  buffer_pool_manager_->DeletePage(old_header_page_id);
+}
+
+/*
+ * A layout with more blocks than one header page lists gets directory pages,
+ * every one of them full but the last.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LINEAR_PROBE_HASH_TABLE_TYPE::CreateNewBlockPages(HashTableHeaderPage *header_page, size_t num_blocks) {
+  BasicPageGuard directory_guard;
+  HashTableHeaderPage *directory_page = header_page;
+  for (size_t i = 0; i < num_blocks; i++) {
+    if (num_blocks > HASH_TABLE_HEADER_MAX_BLOCKS && i % HASH_TABLE_HEADER_MAX_BLOCKS == 0) {
+      page_id_t directory_page_id;
+      directory_guard = buffer_pool_manager_->NewPageGuarded(&directory_page_id);
+      directory_page = directory_guard.AsMut<HashTableHeaderPage>();
+      directory_page->SetPageId(directory_page_id);
+      directory_page->SetLSN(INVALID_LSN);
+      header_page->AddBlockPageId(directory_page_id);
+    }
+    page_id_t block_page_id;
+    buffer_pool_manager_->NewPageGuarded(&block_page_id);
+    directory_page->AddBlockPageId(block_page_id);
+  }
+  header_page->SetSize(num_blocks * BLOCK_ARRAY_SIZE);
+}
 
 /*****************************************************************************
  * GETSIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::GetSize() -> size_t {
-  return 0;
+auto LINEAR_PROBE_HASH_TABLE_TYPE::GetSize() -> size_t {
+  table_latch_.RLock();
+  size_t size = buffer_pool_manager_->FetchPageBasic(header_page_id_).template As<HashTableHeaderPage>()->GetSize();
+  table_latch_.RUnlock();
+  return size;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LINEAR_PROBE_HASH_TABLE_TYPE::IsResizing() -> bool {
+  table_latch_.RLock();
+  bool resizing = old_header_page_id_ != INVALID_PAGE_ID;
+  table_latch_.RUnlock();
+  return resizing;
 }
 
 template class LinearProbeHashTable<int, int, IntComparator>;
@@ -72,5 +326,6 @@ template class LinearProbeHashTable<GenericKey<8>, RID, GenericComparator<8>>;
 template class LinearProbeHashTable<GenericKey<16>, RID, GenericComparator<16>>;
 template class LinearProbeHashTable<GenericKey<32>, RID, GenericComparator<32>>;
 template class LinearProbeHashTable<GenericKey<64>, RID, GenericComparator<64>>;
+template class LinearProbeHashTable<GenericKey<128>, RID, GenericComparator<128>>;
 
 }  // namespace bustub
@@ -1,5 +1,6 @@
 #include "execution/executors/filter_executor.h"
 #include "common/exception.h"
+#include "execution/expressions/column_value_expression.h"
 #include "type/value_factory.h"
 
 namespace bustub {
@@ -31,4 +32,20 @@ auto FilterExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   }
 }
 
+auto FilterExecutor::NextBatch(TupleBatch *batch) -> bool {
+  while (child_executor_->NextBatch(batch)) {
+    batch->Select(plan_->GetPredicate()->EvaluateBatch(*batch));
+    if (batch->GetSize() > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void FilterExecutor::SetColumnsUsed(const std::vector<bool> &used) {
+  auto child_used = used;
+  CollectColumnsUsed(*plan_->GetPredicate(), &child_used);
+  child_executor_->SetColumnsUsed(child_used);
+}
+
 }  // namespace bustub
@@ -13,10 +13,48 @@
 
 namespace bustub {
 IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
 
-void IndexScanExecutor::Init() { throw NotImplementedException("IndexScanExecutor is not implemented"); }
+void IndexScanExecutor::Init() {
+  auto *catalog = exec_ctx_->GetCatalog();
+  index_info_ = catalog->GetIndex(plan_->GetIndexOid());
+  table_info_ = catalog->GetTable(index_info_->table_name_);
+  rids_.clear();
+  cursor_ = 0;
 
-auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+  if (plan_->pred_key_ != nullptr) {
+    // a point lookup, every index kind answers it
+    Value key_value = plan_->pred_key_->Evaluate(nullptr, index_info_->key_schema_);
+    Tuple key({key_value}, &index_info_->key_schema_);
+    index_info_->index_->ScanKey(key, &rids_, exec_ctx_->GetTransaction());
+    return;
+  }
+
+  // a scan of the whole index in key order, which every B+ tree answers whatever its key size
+  if (plan_->reverse_) {
+    index_info_->index_->ReverseScanAll(&rids_, exec_ctx_->GetTransaction());
+  } else {
+    index_info_->index_->ScanAll(&rids_, exec_ctx_->GetTransaction());
+  }
+}
+
+auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (cursor_ < rids_.size()) {
+    auto [meta, fetched] = table_info_->table_->GetTuple(rids_[cursor_++]);
+    if (meta.is_deleted_) {
+      continue;
+    }
+    if (plan_->filter_predicate_ != nullptr) {
+      auto value = plan_->filter_predicate_->Evaluate(&fetched, GetOutputSchema());
+      if (value.IsNull() || !value.GetAs<bool>()) {
+        continue;
+      }
+    }
+    *rid = fetched.GetRid();
+    *tuple = std::move(fetched);
+    return true;
+  }
+  return false;
+}
 
 }  // namespace bustub
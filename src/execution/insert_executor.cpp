@@ -11,6 +11,8 @@
 //===----------------------------------------------------------------------===//
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "execution/executors/insert_executor.h"
 
@@ -18,10 +20,55 @@ namespace bustub {
 
 InsertExecutor::InsertExecutor(ExecutorContext *exec_ctx, const InsertPlanNode *plan,
                                std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
 
-void InsertExecutor::Init() { throw NotImplementedException("InsertExecutor is not implemented"); }
+void InsertExecutor::Init() {
+  child_executor_->Init();
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->TableOid());
+  num_inserted_ = 0;
+  done_ = false;
+}
 
-auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool { return false; }
+void InsertExecutor::InsertBatch(std::vector<Tuple> *tuples) {
+  auto rids = table_info_->table_->InsertTuples(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, *tuples,
+                                                exec_ctx_->GetLockManager(), exec_ctx_->GetTransaction(),
+                                                plan_->TableOid());
+  for (const auto *index_info : exec_ctx_->GetCatalog()->GetTableIndexes(table_info_->name_)) {
+    const auto &key_attrs = index_info->index_->GetKeyAttrs();
+    for (size_t i = 0; i < tuples->size(); i++) {
+      auto key = (*tuples)[i].KeyFromTuple(table_info_->schema_, index_info->key_schema_, key_attrs);
+      if (!index_info->index_->InsertEntry(key, rids[i], exec_ctx_->GetTransaction())) {
+        throw Exception(fmt::format("index {} rejected the entry of tuple {}", index_info->name_, rids[i].ToString()));
+      }
+    }
+  }
+  num_inserted_ += static_cast<int32_t>(tuples->size());
+}
+
+auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
+  if (done_) {
+    return false;
+  }
+
+  // a page takes as many tuples of a batch as fit under one write latch
+  std::vector<Tuple> batch;
+  batch.reserve(INSERT_BATCH_SIZE);
+  Tuple child_tuple;
+  RID child_rid;
+  while (child_executor_->Next(&child_tuple, &child_rid)) {
+    batch.push_back(std::move(child_tuple));
+    if (batch.size() == INSERT_BATCH_SIZE) {
+      InsertBatch(&batch);
+      batch.clear();
+    }
+  }
+  if (!batch.empty()) {
+    InsertBatch(&batch);
+  }
+
+  *tuple = Tuple({Value(TypeId::INTEGER, num_inserted_)}, &GetOutputSchema());
+  done_ = true;
+  return true;
+}
 
 }  // namespace bustub
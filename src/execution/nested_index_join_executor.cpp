@@ -11,20 +11,92 @@
 //===----------------------------------------------------------------------===//
 
 #include "execution/executors/nested_index_join_executor.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
 NestIndexJoinExecutor::NestIndexJoinExecutor(ExecutorContext *exec_ctx, const NestedIndexJoinPlanNode *plan,
                                              std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {
   if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
     // Note for 2023 Spring: You ONLY need to implement left join and inner join.
     throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
   }
 }
 
-void NestIndexJoinExecutor::Init() { throw NotImplementedException("NestIndexJoinExecutor is not implemented"); }
+void NestIndexJoinExecutor::Init() {
+  child_executor_->Init();
+  auto *catalog = exec_ctx_->GetCatalog();
+  index_info_ = catalog->GetIndex(plan_->GetIndexOid());
+  inner_table_info_ = catalog->GetTable(plan_->GetInnerTableOid());
+  matches_.clear();
+  match_cursor_ = 0;
+}
+
+void NestIndexJoinExecutor::ProbeInner() {
+  matches_.clear();
+  match_cursor_ = 0;
+
+  // NULL joins with nothing
+  Value key_value = plan_->KeyPredicate()->Evaluate(&outer_tuple_, child_executor_->GetOutputSchema());
+  if (key_value.IsNull()) {
+    return;
+  }
+  const auto key_type = index_info_->key_schema_.GetColumn(0).GetType();
+  if (key_value.GetTypeId() != key_type) {
+    key_value = key_value.CastAs(key_type);
+  }
+
+  // a hash index finds the rids in a constant number of page accesses, a tree in a root-to-leaf walk
+  std::vector<RID> rids;
+  Tuple key({key_value}, &index_info_->key_schema_);
+  index_info_->index_->ScanKey(key, &rids, exec_ctx_->GetTransaction());
+  for (const auto &inner_rid : rids) {
+    auto [meta, inner_tuple] = inner_table_info_->table_->GetTuple(inner_rid);
+    if (!meta.is_deleted_) {
+      matches_.push_back(std::move(inner_tuple));
+    }
+  }
+}
+
+auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  const auto &outer_schema = child_executor_->GetOutputSchema();
+  const auto &inner_schema = plan_->InnerTableSchema();
+  while (true) {
+    if (match_cursor_ < matches_.size()) {
+      const auto &inner_tuple = matches_[match_cursor_++];
+      std::vector<Value> values;
+      values.reserve(GetOutputSchema().GetColumnCount());
+      for (uint32_t i = 0; i < outer_schema.GetColumnCount(); i++) {
+        values.push_back(outer_tuple_.GetValue(&outer_schema, i));
+      }
+      for (uint32_t i = 0; i < inner_schema.GetColumnCount(); i++) {
+        values.push_back(inner_tuple.GetValue(&inner_schema, i));
+      }
+      *tuple = Tuple(values, &GetOutputSchema());
+      return true;
+    }
 
-auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+    RID outer_rid;
+    if (!child_executor_->Next(&outer_tuple_, &outer_rid)) {
+      return false;
+    }
+    ProbeInner();
+
+    // a left join keeps the outer tuples nothing joins with, padded with NULLs
+    if (matches_.empty() && plan_->GetJoinType() == JoinType::LEFT) {
+      std::vector<Value> values;
+      values.reserve(GetOutputSchema().GetColumnCount());
+      for (uint32_t i = 0; i < outer_schema.GetColumnCount(); i++) {
+        values.push_back(outer_tuple_.GetValue(&outer_schema, i));
+      }
+      for (uint32_t i = 0; i < inner_schema.GetColumnCount(); i++) {
+        values.push_back(ValueFactory::GetNullValueByType(inner_schema.GetColumn(i).GetType()));
+      }
+      *tuple = Tuple(values, &GetOutputSchema());
+      return true;
+    }
+  }
+}
 
 }  // namespace bustub
@@ -1,11 +1,19 @@
 #include "execution/executors/projection_executor.h"
+#include "execution/expressions/column_value_expression.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 ProjectionExecutor::ProjectionExecutor(ExecutorContext *exec_ctx, const ProjectionPlanNode *plan,
                                        std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {
+  // the batches of the child only need the columns the expressions read
+  std::vector<bool> used(plan_->GetChildPlan()->OutputSchema().GetColumnCount());
+  for (const auto &expr : plan_->GetExpressions()) {
+    CollectColumnsUsed(*expr, &used);
+  }
+  child_executor_->SetColumnsUsed(used);
+}
 
 void ProjectionExecutor::Init() {
   // Initialize the child executor
@@ -33,4 +41,22 @@ auto ProjectionExecutor::Next(Tuple *tuple, RID *rid) -> bool {
 
   return true;
 }
+
+auto ProjectionExecutor::NextBatch(TupleBatch *batch) -> bool {
+  if (!child_executor_->NextBatch(&child_batch_)) {
+    return false;
+  }
+
+  // the expressions give the values of the rows selected in the child batch, every row of the output is selected
+  const auto &exprs = plan_->GetExpressions();
+  batch->Reset(exprs.size());
+  for (size_t i = 0; i < exprs.size(); i++) {
+    (*batch->GetColumns())[i] = exprs[i]->EvaluateBatch(child_batch_);
+  }
+  for (size_t i = 0; i < child_batch_.GetSize(); i++) {
+    batch->GetRids()->push_back(child_batch_.GetRid(i));
+  }
+  batch->SelectAll();
+  return true;
+}
 }  // namespace bustub
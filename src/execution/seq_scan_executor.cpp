@@ -10,14 +10,195 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "execution/executors/seq_scan_executor.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
-SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) : AbstractExecutor(exec_ctx) {}
+namespace {
+
+/** @return the comparison with its sides swapped, `a < b` is `b > a` */
+auto FlipComparison(ComparisonType comp_type) -> ComparisonType {
+  switch (comp_type) {
+    case ComparisonType::LessThan:
+      return ComparisonType::GreaterThan;
+    case ComparisonType::LessThanOrEqual:
+      return ComparisonType::GreaterThanOrEqual;
+    case ComparisonType::GreaterThan:
+      return ComparisonType::LessThan;
+    case ComparisonType::GreaterThanOrEqual:
+      return ComparisonType::LessThanOrEqual;
+    default:
+      return comp_type;
+  }
+}
+
+/**
+ * @return false if no tuple the summary covers can satisfy the predicate. Only comparisons of a column with a
+ * constant, and ANDs and ORs of them, are looked at, anything else may match.
+ */
+auto ZoneMayMatch(const AbstractExpression &predicate, const PageZone &zone) -> bool {
+  if (const auto *logic = dynamic_cast<const LogicExpression *>(&predicate); logic != nullptr) {
+    bool left = ZoneMayMatch(*logic->GetChildAt(0), zone);
+    bool right = ZoneMayMatch(*logic->GetChildAt(1), zone);
+    return logic->logic_type_ == LogicType::And ? left && right : left || right;
+  }
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(&predicate);
+  if (comparison == nullptr) {
+    return true;
+  }
+  auto comp_type = comparison->comp_type_;
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0).get());
+  const auto *constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1).get());
+  if (column == nullptr) {
+    column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1).get());
+    constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(0).get());
+    comp_type = FlipComparison(comp_type);
+  }
+  if (column == nullptr || constant == nullptr || !zone.GetColumn(column->GetColIdx()).tracked_) {
+    return true;
+  }
+
+  // a comparison with null is never true
+  const auto &summary = zone.GetColumn(column->GetColIdx());
+  const auto &value = constant->val_;
+  if (value.IsNull() || !summary.min_.has_value()) {
+    return false;
+  }
+  const auto &min = *summary.min_;
+  const auto &max = *summary.max_;
+  switch (comp_type) {
+    case ComparisonType::Equal:
+      return min.CompareLessThanEquals(value) == CmpBool::CmpTrue &&
+             max.CompareGreaterThanEquals(value) == CmpBool::CmpTrue;
+    case ComparisonType::NotEqual:
+      return min.CompareNotEquals(value) == CmpBool::CmpTrue || max.CompareNotEquals(value) == CmpBool::CmpTrue;
+    case ComparisonType::LessThan:
+      return min.CompareLessThan(value) == CmpBool::CmpTrue;
+    case ComparisonType::LessThanOrEqual:
+      return min.CompareLessThanEquals(value) == CmpBool::CmpTrue;
+    case ComparisonType::GreaterThan:
+      return max.CompareGreaterThan(value) == CmpBool::CmpTrue;
+    case ComparisonType::GreaterThanOrEqual:
+      return max.CompareGreaterThanEquals(value) == CmpBool::CmpTrue;
+  }
+  return true;
+}
+
+/** Append the `column = constant` comparisons the predicate is an AND of, every tuple it accepts satisfies them. */
+void CollectEqualities(const AbstractExpression &predicate, std::vector<std::pair<uint32_t, Value>> *equalities) {
+  if (const auto *logic = dynamic_cast<const LogicExpression *>(&predicate); logic != nullptr) {
+    if (logic->logic_type_ == LogicType::And) {
+      CollectEqualities(*logic->GetChildAt(0), equalities);
+      CollectEqualities(*logic->GetChildAt(1), equalities);
+    }
+    return;
+  }
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(&predicate);
+  if (comparison == nullptr || comparison->comp_type_ != ComparisonType::Equal) {
+    return;
+  }
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0).get());
+  const auto *constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1).get());
+  if (column == nullptr) {
+    column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1).get());
+    constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(0).get());
+  }
+  if (column != nullptr && constant != nullptr) {
+    equalities->emplace_back(column->GetColIdx(), constant->val_);
+  }
+}
+
+}  // namespace
+
+SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+void SeqScanExecutor::Init() {
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid());
+  iter_ = std::make_unique<TableIterator>(table_info_->table_->MakeIterator());
+  if (plan_->filter_predicate_ != nullptr) {
+    // pages whose zone maps rule the filter out are not read
+    iter_->SetPageFilter(
+        [predicate = plan_->filter_predicate_](const PageZone &zone) { return ZoneMayMatch(*predicate, zone); });
+    // and equality conjuncts are matched on the encoded values of PAX pages
+    std::vector<std::pair<uint32_t, Value>> equalities;
+    CollectEqualities(*plan_->filter_predicate_, &equalities);
+    iter_->SetEqualityFilter(std::move(equalities));
+  }
+  page_tuples_.clear();
+  cursor_ = 0;
+  auto used = columns_used_;
+  used.resize(table_info_->schema_.GetColumnCount(), columns_used_.empty());
+  if (plan_->filter_predicate_ != nullptr) {
+    CollectColumnsUsed(*plan_->filter_predicate_, &used);
+  }
+  column_ids_.clear();
+  for (uint32_t i = 0; i < used.size(); i++) {
+    if (used[i]) {
+      column_ids_.push_back(i);
+    }
+  }
+  batch_columns_.assign(column_ids_.size(), {});
+}
 
-void SeqScanExecutor::Init() { throw NotImplementedException("SeqScanExecutor is not implemented"); }
+auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (true) {
+    if (cursor_ < page_tuples_.size()) {
+      Tuple &scanned = page_tuples_[cursor_++];
+      *rid = scanned.GetRid();
+      *tuple = std::move(scanned);
+      return true;
+    }
+    page_tuples_.clear();
+    cursor_ = 0;
+    // the filter looks at the tuples in place, only those that pass it are copied out of the page
+    bool more = plan_->filter_predicate_ == nullptr
+                    ? iter_->NextPage(&page_tuples_)
+                    : iter_->NextPage(&page_tuples_, &table_info_->schema_, [&](const TupleView &view) {
+                        auto value = plan_->filter_predicate_->EvaluateView(view);
+                        return !value.IsNull() && value.GetAs<bool>();
+                      });
+    if (!more) {
+      return false;
+    }
+  }
+}
 
-auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto SeqScanExecutor::NextBatch(TupleBatch *batch) -> bool {
+  while (true) {
+    const auto &schema = table_info_->schema_;
+    batch->Reset(schema.GetColumnCount());
+    bool more = true;
+    while (more && batch->GetNumRows() < BATCH_SIZE) {
+      more = iter_->NextPageColumns(schema, column_ids_, &batch_columns_, batch->GetRids());
+    }
+    // the columns read take their place in the batch, the others are left null
+    auto &columns = *batch->GetColumns();
+    for (size_t i = 0; i < column_ids_.size(); i++) {
+      std::swap(columns[column_ids_[i]], batch_columns_[i]);
+    }
+    for (uint32_t i = 0; i < columns.size(); i++) {
+      if (columns[i].size() < batch->GetNumRows()) {
+        columns[i].resize(batch->GetNumRows(), ValueFactory::GetNullValueByType(schema.GetColumn(i).GetType()));
+      }
+    }
+    batch->SelectAll();
+    if (plan_->filter_predicate_ != nullptr) {
+      batch->Select(plan_->filter_predicate_->EvaluateBatch(*batch));
+    }
+    if (batch->GetSize() > 0 || !more) {
+      return batch->GetSize() > 0;
+    }
+  }
+}
 
 }  // namespace bustub
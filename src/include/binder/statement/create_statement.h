@@ -21,10 +21,12 @@ namespace bustub {
 
 class CreateStatement : public BoundStatement {
  public:
-  explicit CreateStatement(std::string table, std::vector<Column> columns);
+  explicit CreateStatement(std::string table, std::vector<Column> columns, std::string format = "row");
 
   std::string table_;
   std::vector<Column> columns_;
+  /** The page format from `WITH (format = ...)`, lower case */
+  std::string format_;
 
   auto ToString() const -> std::string override;
 };
@@ -117,6 +117,17 @@ class BufferPoolManager {
    * @param page_id, the id of the page to fetch
    * @return PageGuard holding the fetched page
    */
+  /**
+   * @brief Bring a page into the buffer pool ahead of its use, without pinning it.
+   *
+   * The page is read into a free frame, or into a frame the replacer can evict, and is left evictable. Nothing
+   * happens if the page is already resident or no frame can be made available.
+   *
+   * @param page_id id of page to be prefetched
+   * @return true if the page is resident after this call
+   */
+  auto PrefetchPage(page_id_t page_id) -> bool;
+
   auto FetchPageBasic(page_id_t page_id) -> BasicPageGuard;
   auto FetchPageRead(page_id_t page_id) -> ReadPageGuard;
   auto FetchPageWrite(page_id_t page_id) -> WritePageGuard;
@@ -20,10 +20,13 @@
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
+#include "common/exception.h"
 #include "container/hash/hash_function.h"
 #include "storage/index/b_plus_tree_index.h"
+#include "storage/index/buffered_tree_index.h"
 #include "storage/index/extendible_hash_table_index.h"
 #include "storage/index/index.h"
+#include "storage/index/linear_probe_hash_table_index.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
@@ -58,6 +61,28 @@ struct TableInfo {
   const table_oid_t oid_;
 };
 
+/** The data structures an index can be built on. */
+enum class IndexType {
+  /** A B+ tree, supports point queries and range scans */
+  BPlusTreeIndex,
+  /** A buffered tree (B-epsilon tree), supports point queries, takes inserts at a fraction of the page writes */
+  BufferedTreeIndex,
+  /** An extendible hash table, supports point queries in a directory and a bucket page access */
+  HashTableIndex,
+  /** A linear probing hash table, supports point queries in a block page access while it is not resizing */
+  LinearProbeHashTableIndex
+};
+
+/** Number of slots a linear probing hash table index starts with, it doubles as it fills up. */
+static constexpr size_t LINEAR_PROBE_HASH_TABLE_INDEX_INITIAL_SIZE = 1024;
+
+/** @return true if indexes of this type only answer point queries, and answer them in a constant number of page
+ * accesses. The linear probing hash table is left out, it reaches a key in a constant number of page accesses only
+ * while it is not resizing. */
+inline auto IsHashIndex(IndexType index_type) -> bool {
+  return index_type == IndexType::HashTableIndex;
+}
+
 /**
  * The IndexInfo class maintains metadata about a index.
  */
@@ -70,15 +95,17 @@ struct IndexInfo {
    * @param index_oid The unique OID for the index
    * @param table_name The name of the table on which the index is created
    * @param key_size The size of the index key, in bytes
+   * @param index_type The data structure of the index
    */
   IndexInfo(Schema key_schema, std::string name, std::unique_ptr<Index> &&index, index_oid_t index_oid,
-            std::string table_name, size_t key_size)
+            std::string table_name, size_t key_size, IndexType index_type = IndexType::BPlusTreeIndex)
       : key_schema_{std::move(key_schema)},
         name_{std::move(name)},
         index_{std::move(index)},
         index_oid_{index_oid},
         table_name_{std::move(table_name)},
-        key_size_{key_size} {}
+        key_size_{key_size},
+        index_type_{index_type} {}
   /** The schema for the index key */
   Schema key_schema_;
   /** The name of the index */
@@ -91,6 +118,8 @@ struct IndexInfo {
   std::string table_name_;
   /** The size of the index key, in bytes */
   const size_t key_size_;
+  /** The data structure of the index */
+  const IndexType index_type_;
 };
 
 /**
@@ -121,10 +150,11 @@ class Catalog {
    * @param table_name The name of the new table, note that all tables beginning with `__` are reserved for the system.
    * @param schema The schema of the new table
    * @param create_table_heap whether to create a table heap for the new table
+   * @param format the page format of the table heap
    * @return A (non-owning) pointer to the metadata for the table
    */
-  auto CreateTable(Transaction *txn, const std::string &table_name, const Schema &schema, bool create_table_heap = true)
-      -> TableInfo * {
+  auto CreateTable(Transaction *txn, const std::string &table_name, const Schema &schema, bool create_table_heap = true,
+                   TableFormat format = TableFormat::Row) -> TableInfo * {
     if (table_names_.count(table_name) != 0) {
       return NULL_TABLE_INFO;
     }
@@ -136,7 +166,9 @@ class Catalog {
     // When create_table_heap == false, it means that we're running binder tests (where no txn will be provided) or
     // we are running shell without buffer pool. We don't need to create TableHeap in this case.
     if (create_table_heap) {
-      table = std::make_unique<TableHeap>(bpm_);
+      table = std::make_unique<TableHeap>(bpm_, format, &schema);
+      // like index compaction, deleted tuples are vacuumed in the background for as long as the table lives
+      table->StartVacuum();
     }
 
     // Fetch the table OID for the new table
@@ -196,12 +228,14 @@ class Catalog {
    * @param key_attrs Key attributes
    * @param keysize Size of the key
    * @param hash_function The hash function for the index
+   * @param index_type The data structure of the index
    * @return A (non-owning) pointer to the metadata of the new table
    */
   template <class KeyType, class ValueType, class KeyComparator>
   auto CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name, const Schema &schema,
                    const Schema &key_schema, const std::vector<uint32_t> &key_attrs, std::size_t keysize,
-                   HashFunction<KeyType> hash_function) -> IndexInfo * {
+                   HashFunction<KeyType> hash_function, IndexType index_type = IndexType::BPlusTreeIndex)
+      -> IndexInfo * {
     // Reject the creation request for nonexistent table
     if (table_names_.find(table_name) == table_names_.end()) {
       return NULL_INDEX_INFO;
@@ -221,26 +255,35 @@ class Catalog {
     auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs);
 
     // Construct the index, take ownership of metadata
-    // TODO(Kyle): We should update the API for CreateIndex
-    // to allow specification of the index type itself, not
-    // just the key, value, and comparator types
-
-    // TODO(chi): support both hash index and btree index
-    auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
+    std::unique_ptr<Index> index;
+    if (index_type == IndexType::BufferedTreeIndex) {
+      index = std::make_unique<BufferedTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
+    } else if (index_type == IndexType::HashTableIndex) {
+      index = std::make_unique<ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_,
+                                                                                             hash_function);
+    } else if (index_type == IndexType::LinearProbeHashTableIndex) {
+      index = std::make_unique<LinearProbeHashTableIndex<KeyType, ValueType, KeyComparator>>(
+          std::move(meta), bpm_, LINEAR_PROBE_HASH_TABLE_INDEX_INITIAL_SIZE, hash_function);
+    } else {
+      index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
+    }
 
     // Populate the index with all tuples in table heap
     auto *table_meta = GetTable(table_name);
     for (auto iter = table_meta->table_->MakeIterator(); !iter.IsEnd(); ++iter) {
       auto [meta, tuple] = iter.GetTuple();
-      index->InsertEntry(tuple.KeyFromTuple(schema, key_schema, key_attrs), tuple.GetRid(), txn);
+      if (!index->InsertEntry(tuple.KeyFromTuple(schema, key_schema, key_attrs), tuple.GetRid(), txn)) {
+        // an index missing a row would silently drop it from every scan planned over the index
+        throw Exception(fmt::format("index {} rejected the entry of tuple {}", index_name, tuple.GetRid().ToString()));
+      }
     }
 
     // Get the next OID for the new index
     const auto index_oid = next_index_oid_.fetch_add(1);
 
     // Construct index information; IndexInfo takes ownership of the Index itself
-    auto index_info =
-        std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name, keysize);
+    auto index_info = std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name,
+                                                  keysize, index_type);
     auto *tmp = index_info.get();
 
     // Update internal tracking
@@ -21,6 +21,12 @@ namespace bustub {
 /** Cycle detection is performed every CYCLE_DETECTION_INTERVAL milliseconds. */
 extern std::chrono::milliseconds cycle_detection_interval;
 
+/** Background B+ tree compaction looks for underfull pages every BTREE_COMPACTION_INTERVAL milliseconds. */
+extern std::chrono::milliseconds btree_compaction_interval;
+
+/** Background table vacuum compacts pages with deleted tuples every TABLE_VACUUM_INTERVAL milliseconds. */
+extern std::chrono::milliseconds table_vacuum_interval;
+
 /** True if logging should be enabled, false otherwise. */
 extern std::atomic<bool> enable_logging;
 
@@ -258,6 +258,18 @@ class LockManager {
    */
   auto LockRow(Transaction *txn, LockMode lock_mode, const table_oid_t &oid, const RID &rid) -> bool;
 
+  /**
+   * Acquire a lock on every row of a batch, e.g. the rows one insert put into a page. Same as calling LockRow()
+   * on each of them, and stops at the first that fails.
+   *
+   * @param txn the transaction requesting the locks
+   * @param lock_mode the lock mode for the requested locks
+   * @param oid the table_oid_t of the table the rows belong to
+   * @param rids the RIDs of the rows to be locked
+   * @return true if every lock is granted, false otherwise
+   */
+  auto LockRows(Transaction *txn, LockMode lock_mode, const table_oid_t &oid, const std::vector<RID> &rids) -> bool;
+
   /**
    * Release the lock held on a row by the transaction.
    *
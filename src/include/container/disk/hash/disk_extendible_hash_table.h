@@ -29,7 +29,9 @@ namespace bustub {
 /**
  * Implementation of extendible hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
- * table grows/shrinks dynamically as buckets become full/empty.
+ * table grows/shrinks dynamically as buckets become full/empty. A full bucket
+ * that splitting cannot make room in, because its keys all hash alike or the
+ * directory is as large as it gets, continues on overflow pages.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class DiskExtendibleHashTable {
@@ -50,7 +52,7 @@ class DiskExtendibleHashTable {
    * @param transaction the current transaction
    * @param key the key to create
    * @param value the value to be associated with the key
-   * @return true if insert succeeded, false otherwise
+   * @return true if insert succeeded, false if the pair is already in the table
    */
   auto Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool;
 
@@ -110,7 +112,7 @@ class DiskExtendibleHashTable {
    * @param dir_page to use for lookup of global depth
    * @return the directory index
    */
-  auto KeyToDirectoryIndex(KeyType key, HashTableDirectoryPage *dir_page) -> uint32_t;
+  auto KeyToDirectoryIndex(KeyType key, const HashTableDirectoryPage *dir_page) -> uint32_t;
 
   /**
    * Get the bucket page_id corresponding to a key.
@@ -119,7 +121,7 @@ class DiskExtendibleHashTable {
    * @param dir_page a pointer to the hash table's directory page
    * @return the bucket page_id corresponding to the input key
    */
-  auto KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page) -> page_id_t;
+  auto KeyToPageId(KeyType key, const HashTableDirectoryPage *dir_page) -> page_id_t;
 
   /**
    * Fetches the directory page from the buffer pool manager.
@@ -129,12 +131,60 @@ class DiskExtendibleHashTable {
   auto FetchDirectoryPage() -> HashTableDirectoryPage *;
 
   /**
-   * Fetches the a bucket page from the buffer pool manager using the bucket's page_id.
+   * Read latches the bucket that key maps to. The caller must hold table_latch_ in shared mode.
    *
-   * @param bucket_page_id the page_id to fetch
-   * @return a pointer to a bucket page
+   * @param key the key for lookup
+   * @return a guard on the bucket page
+   */
+  auto FetchBucketRead(const KeyType &key) -> ReadPageGuard;
+
+  /**
+   * Write latches the bucket that key maps to. The caller must hold table_latch_ in shared mode.
+   *
+   * @param key the key for lookup
+   * @param[out] bucket_idx if not null, the directory index of key
+   * @return a guard on the bucket page
+   */
+  auto FetchBucketWrite(const KeyType &key, uint32_t *bucket_idx = nullptr) -> WritePageGuard;
+
+  /**
+   * Splits the write latched bucket at bucket_idx into itself and a new split image, and points the
+   * directory entries of the upper half at the split image. The pairs on overflow pages are split too.
+   * The local depth of the bucket must be below the global depth.
+   *
+   * @param bucket_idx the directory index of the bucket
+   * @param bucket_guard the guard of the bucket page
+   */
+  void SplitBucket(uint32_t bucket_idx, WritePageGuard *bucket_guard);
+
+  /** What became of a pair inserted into the chain of a bucket */
+  enum class ChainInsertResult { Inserted, Duplicate, Full };
+
+  /**
+   * Inserts a pair into the first page of the chain of a write latched bucket that has room: the bucket page or one
+   * of its overflow pages. The caller must hold table_latch_ in shared mode, or the bucket must be unreachable.
+   *
+   * @param bucket the bucket page
+   * @param key the key to insert
+   * @param value the value to insert
+   * @param append_overflow whether to append an overflow page to the chain when no page of it has room
+   * @return whether the pair was inserted, was already there, or found no room
+   */
+  auto ChainInsert(HASH_TABLE_BUCKET_TYPE *bucket, const KeyType &key, const ValueType &value, bool append_overflow)
+      -> ChainInsertResult;
+
+  /**
+   * Unlinks and deletes the empty overflow pages of a write latched bucket.
+   *
+   * @param bucket the bucket page
+   */
+  void PruneOverflow(HASH_TABLE_BUCKET_TYPE *bucket);
+
+  /**
+   * @return whether splitting a write latched bucket can move any of its pairs away from key, some pair has to differ
+   * from it in a hash bit the largest directory addresses
    */
-  auto FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BUCKET_TYPE *;
+  auto CanSplit(const HASH_TABLE_BUCKET_TYPE *bucket, const KeyType &key) -> bool;
 
   /**
    * Performs insertion with an optional bucket splitting.
@@ -166,7 +216,9 @@ class DiskExtendibleHashTable {
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
-  // Readers includes inserts and removes, writers are splits and merges
+  // Readers includes inserts, removes and splits that leave the global depth alone, writers are
+  // splits that grow the directory and merges. Readers latch the directory page to read the bucket
+  // mapping, and the bucket page they work on.
   ReaderWriterLatch table_latch_;
   HashFunction<KeyType> hash_fn_;
 };
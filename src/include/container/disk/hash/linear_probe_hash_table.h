@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <optional>
 #include <queue>
 #include <string>
 #include <vector>
@@ -24,12 +25,27 @@
 
 namespace bustub {
 
-#define HASH_TABLE_TYPE LinearProbeHashTable<KeyType, ValueType, KeyComparator>
+#define LINEAR_PROBE_HASH_TABLE_TYPE LinearProbeHashTable<KeyType, ValueType, KeyComparator>
+
+/** The most block pages a layout has, as many as the directory pages one header page lists can hold. */
+#define HASH_TABLE_MAX_BLOCKS (HASH_TABLE_HEADER_MAX_BLOCKS * HASH_TABLE_HEADER_MAX_BLOCKS)
 
 /**
  * Implementation of linear probing hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
- * table dynamically grows once full.
+ * table dynamically grows once half of its slots are taken.
+ *
+ * Growing is incremental: Resize only allocates the blocks of a layout twice
+ * the size, and every later insert and remove moves the entries of one block
+ * of the old layout over. While that goes on, lookups probe both layouts.
+ * Migrated slots stay behind as tombstones, so the probe sequences of the
+ * entries still in the old layout stay intact.
+ *
+ * The header page of a layout lists its block pages directly while they fit.
+ * A larger layout goes through one more level: the header lists directory
+ * pages, header pages themselves, that list HASH_TABLE_HEADER_MAX_BLOCKS
+ * block pages each. That keeps doubling up to HASH_TABLE_MAX_BLOCKS blocks,
+ * beyond that an insert into a full table throws.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class LinearProbeHashTable {
@@ -50,7 +66,8 @@ class LinearProbeHashTable {
    * @param transaction the current transaction
    * @param key the key to create
    * @param value the value to be associated with the key
-   * @return true if insert succeeded, false otherwise
+   * @return true if insert succeeded, false if the pair is already in the table
+   * @throws Exception if the table is at its largest and every slot is occupied
    */
   auto Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool;
 
@@ -73,7 +90,9 @@ class LinearProbeHashTable {
   auto GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
 
   /**
-   * Resizes the table to at least twice the initial size provided.
+   * Resizes the table to at least twice the initial size provided. Only the
+   * new blocks are allocated here, entries are moved over by later inserts
+   * and removes, one block at a time.
    * @param initial_size the initial size of the hash table
    */
   void Resize(size_t initial_size);
@@ -84,20 +103,57 @@ class LinearProbeHashTable {
    */
   auto GetSize() -> size_t;
 
+  /**
+   * @return whether entries of an earlier, smaller layout are still being moved over
+   */
+  auto IsResizing() -> bool;
+
  private:
-  auto GetHeaderPage() -> HashTableHeaderPage *;
-  auto GetBlockPage(page_id_t block_page_id) -> HASH_TABLE_BLOCK_TYPE *;
-  void ResizeInsert(HashTableHeaderPage *header_page, const KeyType &key, const ValueType &value);
-  void DeleteBlockPages(HashTableHeaderPage *old_header_page);
+  /**
+   * Calls visit on every readable slot along the probe sequence of key in the layout of header_page_id, from the
+   * home slot of key up to the first slot that was never occupied, until visit returns true.
+   * @return the slot visit returned true for, or else the first slot that was never occupied, or the size of the
+   * layout if every slot is occupied
+   */
+  template <typename Visitor>
+  auto Probe(page_id_t header_page_id, const KeyType &key, Visitor &&visit) -> size_t;
+
+  /** @return the slot of the pair (key, value) in the layout of header_page_id, or std::nullopt */
+  auto FindPair(page_id_t header_page_id, const KeyType &key, const ValueType &value) -> std::optional<size_t>;
+
+  /**
+   * Inserts a pair that is not in the table into the current layout.
+   * @return false if every slot of the layout is occupied
+   */
+  auto ResizeInsert(const KeyType &key, const ValueType &value) -> bool;
+
+  /** @return the page id of a block of the layout of header_page, through its directory page if it has them */
+  auto GetBlockPageId(const HashTableHeaderPage *header_page, size_t block_index) -> page_id_t;
+
+  /** Allocates a layout of at least twice initial_size slots and makes it the current one. */
+  void StartResize(size_t initial_size);
+
+  /** Moves the entries of the next block of the old layout into the current one, and drops the old layout after
+   * its last block. */
+  void MigrateBlock();
+
+  void DeleteBlockPages(page_id_t old_header_page_id);
   void CreateNewBlockPages(HashTableHeaderPage *header_page, size_t num_blocks);
   auto GetValueLatchFree(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
 
   // member variable
+  // header of the current layout, every new entry goes here
   page_id_t header_page_id_;
+  // header of the layout that is being migrated, INVALID_PAGE_ID if there is none
+  page_id_t old_header_page_id_{INVALID_PAGE_ID};
+  // the next block of the old layout to migrate
+  size_t next_migrate_block_{0};
+  // the number of occupied slots in the current layout, tombstones included
+  size_t num_occupied_{0};
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
-  // Readers includes inserts and removes, writer is only resize
+  // Readers are lookups, writers are inserts and removes, and the resize steps they carry
   ReaderWriterLatch table_latch_;
 
   // Hash function
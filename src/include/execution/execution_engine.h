@@ -23,6 +23,7 @@
 #include "execution/executors/init_check_executor.h"
 #include "execution/plans/abstract_plan.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_batch.h"
 
 namespace bustub {
 
@@ -94,11 +95,13 @@ class ExecutionEngine {
    */
   static void PollExecutor(AbstractExecutor *executor, const AbstractPlanNodeRef &plan,
                            std::vector<Tuple> *result_set) {
-    RID rid{};
-    Tuple tuple{};
-    while (executor->Next(&tuple, &rid)) {
-      if (result_set != nullptr) {
-        result_set->push_back(tuple);
+    TupleBatch batch;
+    while (executor->NextBatch(&batch)) {
+      if (result_set == nullptr) {
+        continue;
+      }
+      for (size_t i = 0; i < batch.GetSize(); i++) {
+        result_set->push_back(batch.GetTuple(i, executor->GetOutputSchema()));
       }
     }
   }
@@ -22,7 +22,7 @@
 #include "concurrency/transaction.h"
 #include "execution/check_options.h"
 #include "execution/executors/abstract_executor.h"
-#include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tmp_file_manager.h"
 
 namespace bustub {
 class AbstractExecutor;
@@ -46,6 +46,7 @@ class ExecutorContext {
         bpm_{bpm},
         txn_mgr_(txn_mgr),
         lock_mgr_(lock_mgr),
+        tmp_file_manager_(bpm),
         is_delete_(is_delete) {
     nlj_check_exec_set_ = std::deque<std::pair<AbstractExecutor *, AbstractExecutor *>>(
         std::deque<std::pair<AbstractExecutor *, AbstractExecutor *>>{});
@@ -74,6 +75,9 @@ class ExecutorContext {
   /** @return the transaction manager */
   auto GetTransactionManager() -> TransactionManager * { return txn_mgr_; }
 
+  /** @return the temporary files of the query, freed when it ends */
+  auto GetTmpFileManager() -> TmpFileManager * { return &tmp_file_manager_; }
+
   /** @return the set of nlj check executors */
   auto GetNLJCheckExecutorSet() -> std::deque<std::pair<AbstractExecutor *, AbstractExecutor *>> & {
     return nlj_check_exec_set_;
@@ -104,6 +108,8 @@ class ExecutorContext {
   TransactionManager *txn_mgr_;
   /** The lock manager associated with this executor context */
   LockManager *lock_mgr_;
+  /** The temporary files operators spill intermediate results to */
+  TmpFileManager tmp_file_manager_;
   /** The set of NLJ check executors associated with this executor context */
   std::deque<std::pair<AbstractExecutor *, AbstractExecutor *>> nlj_check_exec_set_;
   /** The set of check options associated with this executor context */
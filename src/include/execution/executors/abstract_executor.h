@@ -12,8 +12,11 @@
 
 #pragma once
 
+#include <vector>
+
 #include "execution/executor_context.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_batch.h"
 
 namespace bustub {
 class ExecutorContext;
@@ -21,6 +24,9 @@ class ExecutorContext;
  * The AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
  * This is the base class from which all executors in the BustTub execution
  * engine inherit, and defines the minimal interface that all executors support.
+ *
+ * The execution engine polls the root executor a batch at a time. Scans, filters and projections pass batches
+ * up natively, every other executor hands out its tuples in batches of Next.
  */
 class AbstractExecutor {
  public:
@@ -47,6 +53,34 @@ class AbstractExecutor {
    */
   virtual auto Next(Tuple *tuple, RID *rid) -> bool = 0;
 
+  /**
+   * Yield the next batch of tuples from this executor. Executors that work a batch at a time override this, for
+   * the others it collects up to BATCH_SIZE tuples from Next. An executor is polled with Next or with NextBatch,
+   * not both.
+   * @param[out] batch The rows produced, column by column in the output schema
+   * @return `true` if rows were selected in the batch, `false` if there are no more tuples
+   */
+  virtual auto NextBatch(TupleBatch *batch) -> bool {
+    // the output schema is only read once Next produced a tuple, as the engine did before it polled batches
+    batch->Reset(0);
+    Tuple tuple{};
+    RID rid{};
+    while (batch->GetNumRows() < BATCH_SIZE && Next(&tuple, &rid)) {
+      if (batch->GetNumRows() == 0) {
+        batch->Reset(GetOutputSchema().GetColumnCount());
+      }
+      batch->AppendTuple(tuple, GetOutputSchema(), rid);
+    }
+    return batch->GetSize() > 0;
+  }
+
+  /**
+   * Tell the executor which columns of its output its parent reads from the batches of NextBatch, it may leave the
+   * others null. Called before Init, executors that read every column anyway ignore it.
+   * @param used used[i] is whether column i of the output schema is read
+   */
+  virtual void SetColumnsUsed(const std::vector<bool> &used) {}
+
   /** @return The schema of the tuples that this executor produces */
   virtual auto GetOutputSchema() const -> const Schema & = 0;
 
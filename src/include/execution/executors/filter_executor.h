@@ -48,6 +48,17 @@ class FilterExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of the child with the predicate evaluated on it, only the rows it is true for stay
+   * selected. Batches with none of them are passed over.
+   * @param[out] batch The rows produced by the filter
+   * @return `true` if rows were produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
+  /** Pass the columns used on to the child, with those the predicate reads. */
+  void SetColumnsUsed(const std::vector<bool> &used) override;
+
   /** @return The output schema for the filter plan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
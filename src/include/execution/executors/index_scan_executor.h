@@ -14,6 +14,7 @@
 
 #include <vector>
 
+#include "catalog/catalog.h"
 #include "common/rid.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
@@ -44,5 +45,13 @@ class IndexScanExecutor : public AbstractExecutor {
  private:
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
+  /** The index that is scanned */
+  IndexInfo *index_info_{nullptr};
+  /** The table the index is built on */
+  TableInfo *table_info_{nullptr};
+  /** The rids the index handed out, in index order */
+  std::vector<RID> rids_;
+  /** The next entry of rids_ to return */
+  size_t cursor_{0};
 };
 }  // namespace bustub
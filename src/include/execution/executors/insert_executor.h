@@ -14,7 +14,9 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
+#include "catalog/catalog.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/insert_plan.h"
@@ -24,7 +26,7 @@ namespace bustub {
 
 /**
  * InsertExecutor executes an insert on a table.
- * Inserted values are always pulled from a child executor.
+ * Inserted values are always pulled from a child executor, and handed to the table in batches.
  */
 class InsertExecutor : public AbstractExecutor {
  public:
@@ -55,8 +57,22 @@ class InsertExecutor : public AbstractExecutor {
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
  private:
+  /** Insert a batch of tuples into the table and its indexes. */
+  void InsertBatch(std::vector<Tuple> *tuples);
+
+  /** The number of tuples pulled from the child before they are inserted together */
+  static constexpr size_t INSERT_BATCH_SIZE = 256;
+
   /** The insert plan node to be executed*/
   const InsertPlanNode *plan_;
+  /** The child executor from which inserted tuples are pulled */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The table inserted into */
+  TableInfo *table_info_{nullptr};
+  /** The number of rows inserted so far */
+  int32_t num_inserted_{0};
+  /** Whether the number of inserted rows has been produced */
+  bool done_{false};
 };
 
 }  // namespace bustub
@@ -48,7 +48,22 @@ class NestIndexJoinExecutor : public AbstractExecutor {
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
  private:
+  /** Looks up the inner tuples that join with the current outer tuple */
+  void ProbeInner();
+
   /** The nested index join plan node. */
   const NestedIndexJoinPlanNode *plan_;
+  /** The outer table */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The index probed with the outer tuples */
+  IndexInfo *index_info_{nullptr};
+  /** The inner table */
+  TableInfo *inner_table_info_{nullptr};
+  /** The current outer tuple */
+  Tuple outer_tuple_;
+  /** The inner tuples matching the current outer tuple */
+  std::vector<Tuple> matches_;
+  /** The next entry of matches_ to join with */
+  size_t match_cursor_{0};
 };
 }  // namespace bustub
@@ -47,6 +47,13 @@ class ProjectionExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of the projection, every expression is evaluated once on a batch of the child.
+   * @param[out] batch The rows produced by the projection, all of them selected
+   * @return `true` if rows were produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the projection plan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
@@ -56,5 +63,8 @@ class ProjectionExecutor : public AbstractExecutor {
 
   /** The child executor from which tuples are obtained */
   std::unique_ptr<AbstractExecutor> child_executor_;
+
+  /** The batch of the child the expressions are evaluated on */
+  TupleBatch child_batch_;
 };
 }  // namespace bustub
@@ -12,17 +12,24 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
+#include "catalog/catalog.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
- * The SeqScanExecutor executor executes a sequential table scan.
+ * The SeqScanExecutor executor executes a sequential table scan. It takes the tuples of the table a page at a
+ * time, and evaluates its filter on them in place in the page. Pages whose zone maps show that no tuple passes
+ * the filter are skipped, and on PAX pages the equality conjuncts of the filter are matched on the encoded values
+ * of the columns before any tuple is put together. NextBatch reads whole columns of a page instead, only those its
+ * parent and the filter read.
  */
 class SeqScanExecutor : public AbstractExecutor {
  public:
@@ -44,11 +51,36 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch from the sequential scan. The columns are read a page at a time straight into the batch
+   * until it holds BATCH_SIZE rows, and the filter narrows its selection.
+   * @param[out] batch The rows produced by the scan
+   * @return `true` if rows were produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
+  /** Read only the columns used, and those the filter reads, in NextBatch. */
+  void SetColumnsUsed(const std::vector<bool> &used) override { columns_used_ = used; }
+
   /** @return The output schema for the sequential scan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
+  /** The table that is scanned */
+  TableInfo *table_info_{nullptr};
+  /** The iterator over the table */
+  std::unique_ptr<TableIterator> iter_;
+  /** The tuples of the current page that are not deleted and pass the filter */
+  std::vector<Tuple> page_tuples_;
+  /** The next entry of page_tuples_ to return */
+  size_t cursor_{0};
+  /** The columns the parent reads from the batches, every column if it did not say */
+  std::vector<bool> columns_used_;
+  /** The columns NextBatch reads, in order */
+  std::vector<uint32_t> column_ids_;
+  /** The values of column_ids_ read for the current batch */
+  std::vector<std::vector<Value>> batch_columns_;
 };
 }  // namespace bustub
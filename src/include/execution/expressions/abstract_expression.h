@@ -20,6 +20,7 @@
 #include "catalog/schema.h"
 #include "fmt/format.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_batch.h"
 
 #define BUSTUB_EXPR_CLONE_WITH_CHILDREN(cname)                                                                   \
   auto CloneWithChildren(std::vector<AbstractExpressionRef> children) const->std::unique_ptr<AbstractExpression> \
@@ -54,6 +55,12 @@ class AbstractExpression {
   /** @return The value obtained by evaluating the tuple with the given schema */
   virtual auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value = 0;
 
+  /** @return The value obtained by evaluating the tuple a view refers to, in place */
+  virtual auto EvaluateView(const TupleView &view) const -> Value = 0;
+
+  /** @return The values obtained by evaluating the rows selected in a batch, in the order of the selection */
+  virtual auto EvaluateBatch(const TupleBatch &batch) const -> std::vector<Value> = 0;
+
   /**
    * Returns the value obtained by evaluating a JOIN.
    * @param left_tuple The left tuple
@@ -54,6 +54,29 @@ class ArithmeticExpression : public AbstractExpression {
     return ValueFactory::GetIntegerValue(*res);
   }
 
+  auto EvaluateView(const TupleView &view) const -> Value override {
+    Value lhs = GetChildAt(0)->EvaluateView(view);
+    Value rhs = GetChildAt(1)->EvaluateView(view);
+    auto res = PerformComputation(lhs, rhs);
+    if (res == std::nullopt) {
+      return ValueFactory::GetNullValueByType(TypeId::INTEGER);
+    }
+    return ValueFactory::GetIntegerValue(*res);
+  }
+
+  auto EvaluateBatch(const TupleBatch &batch) const -> std::vector<Value> override {
+    auto lhs = GetChildAt(0)->EvaluateBatch(batch);
+    auto rhs = GetChildAt(1)->EvaluateBatch(batch);
+    std::vector<Value> values;
+    values.reserve(lhs.size());
+    for (size_t i = 0; i < lhs.size(); i++) {
+      auto res = PerformComputation(lhs[i], rhs[i]);
+      values.push_back(res == std::nullopt ? ValueFactory::GetNullValueByType(TypeId::INTEGER)
+                                           : ValueFactory::GetIntegerValue(*res));
+    }
+    return values;
+  }
+
   auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
                     const Schema &right_schema) const -> Value override {
     Value lhs = GetChildAt(0)->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema);
@@ -39,6 +39,17 @@ class ColumnValueExpression : public AbstractExpression {
     return tuple->GetValue(&schema, col_idx_);
   }
 
+  auto EvaluateView(const TupleView &view) const -> Value override { return view.GetValue(col_idx_); }
+
+  auto EvaluateBatch(const TupleBatch &batch) const -> std::vector<Value> override {
+    std::vector<Value> values;
+    values.reserve(batch.GetSize());
+    for (size_t i = 0; i < batch.GetSize(); i++) {
+      values.push_back(batch.GetValue(col_idx_, i));
+    }
+    return values;
+  }
+
   auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
                     const Schema &right_schema) const -> Value override {
     return tuple_idx_ == 0 ? left_tuple->GetValue(&left_schema, col_idx_)
@@ -59,4 +70,17 @@ class ColumnValueExpression : public AbstractExpression {
   /** Column index refers to the index within the schema of the tuple, e.g. schema {A,B,C} has indexes {0,1,2} */
   uint32_t col_idx_;
 };
+
+/** Mark the columns of the (left) tuple that an expression reads in used. */
+inline void CollectColumnsUsed(const AbstractExpression &expr, std::vector<bool> *used) {
+  if (const auto *column = dynamic_cast<const ColumnValueExpression *>(&expr); column != nullptr) {
+    if (column->GetTupleIdx() == 0 && column->GetColIdx() < used->size()) {
+      (*used)[column->GetColIdx()] = true;
+    }
+    return;
+  }
+  for (const auto &child : expr.GetChildren()) {
+    CollectColumnsUsed(*child, used);
+  }
+}
 }  // namespace bustub
@@ -42,6 +42,23 @@ class ComparisonExpression : public AbstractExpression {
     return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
   }
 
+  auto EvaluateView(const TupleView &view) const -> Value override {
+    Value lhs = GetChildAt(0)->EvaluateView(view);
+    Value rhs = GetChildAt(1)->EvaluateView(view);
+    return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
+  }
+
+  auto EvaluateBatch(const TupleBatch &batch) const -> std::vector<Value> override {
+    auto lhs = GetChildAt(0)->EvaluateBatch(batch);
+    auto rhs = GetChildAt(1)->EvaluateBatch(batch);
+    std::vector<Value> values;
+    values.reserve(lhs.size());
+    for (size_t i = 0; i < lhs.size(); i++) {
+      values.push_back(ValueFactory::GetBooleanValue(PerformComparison(lhs[i], rhs[i])));
+    }
+    return values;
+  }
+
   auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
                     const Schema &right_schema) const -> Value override {
     Value lhs = GetChildAt(0)->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema);
@@ -70,6 +70,22 @@ class StringExpression : public AbstractExpression {
     return ValueFactory::GetVarcharValue(Compute(str));
   }
 
+  auto EvaluateView(const TupleView &view) const -> Value override {
+    Value val = GetChildAt(0)->EvaluateView(view);
+    auto str = val.GetAs<char *>();
+    return ValueFactory::GetVarcharValue(Compute(str));
+  }
+
+  auto EvaluateBatch(const TupleBatch &batch) const -> std::vector<Value> override {
+    auto vals = GetChildAt(0)->EvaluateBatch(batch);
+    std::vector<Value> values;
+    values.reserve(vals.size());
+    for (const auto &val : vals) {
+      values.push_back(ValueFactory::GetVarcharValue(Compute(val.GetAs<char *>())));
+    }
+    return values;
+  }
+
   auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
                     const Schema &right_schema) const -> Value override {
     Value val = GetChildAt(0)->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema);
@@ -22,16 +22,27 @@
 namespace bustub {
 /**
  * IndexScanPlanNode identifies a table that should be scanned with an optional predicate.
+ *
+ * Without a key it walks the whole index in ascending or descending key order, which only a B+ tree can do.
+ * With a key it looks the key up through Index::ScanKey, which every index kind answers.
  */
 class IndexScanPlanNode : public AbstractPlanNode {
  public:
   /**
    * Creates a new index scan plan node.
    * @param output the output format of this scan plan node
-   * @param table_oid the identifier of table to be scanned
+   * @param index_oid the identifier of the index to be scanned
+   * @param filter_predicate the predicate the fetched tuples must satisfy, nullptr for none
+   * @param pred_key the constant to look up in the index, nullptr for an ordered scan of the whole index
+   * @param reverse whether an ordered scan walks the index in descending key order
    */
-  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid)
-      : AbstractPlanNode(std::move(output), {}), index_oid_(index_oid) {}
+  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid, AbstractExpressionRef filter_predicate = nullptr,
+                    AbstractExpressionRef pred_key = nullptr, bool reverse = false)
+      : AbstractPlanNode(std::move(output), {}),
+        index_oid_(index_oid),
+        filter_predicate_(std::move(filter_predicate)),
+        pred_key_(std::move(pred_key)),
+        reverse_(reverse) {}
 
   auto GetType() const -> PlanType override { return PlanType::IndexScan; }
 
@@ -43,11 +54,22 @@ class IndexScanPlanNode : public AbstractPlanNode {
   /** The table whose tuples should be scanned. */
   index_oid_t index_oid_;
 
-  // Add anything you want here for index lookup
+  /** The predicate the fetched tuples are filtered with, it still holds the condition the key was taken from */
+  AbstractExpressionRef filter_predicate_;
+
+  /** The key of a point lookup, a constant expression */
+  AbstractExpressionRef pred_key_;
+
+  /** Whether an ordered scan hands out the entries in descending key order */
+  bool reverse_;
 
  protected:
   auto PlanNodeToString() const -> std::string override {
-    return fmt::format("IndexScan {{ index_oid={} }}", index_oid_);
+    if (pred_key_) {
+      return fmt::format("IndexScan {{ index_oid={}, key={}, filter={} }}", index_oid_, pred_key_, filter_predicate_);
+    }
+    return fmt::format("IndexScan {{ index_oid={}, order={}, filter={} }}", index_oid_, reverse_ ? "desc" : "asc",
+                       filter_predicate_);
   }
 };
 
@@ -83,7 +83,12 @@ class Optimizer {
    */
   auto OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
-  /** @brief check if the index can be matched */
+  /**
+   * @brief turn a seq scan whose filter holds `column = constant` into a point lookup on an index over that column
+   */
+  auto OptimizeSeqScanAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /** @brief check if the index can be matched, hash indexes are preferred over trees */
   auto MatchIndex(const std::string &table_name, uint32_t index_key_idx)
       -> std::optional<std::tuple<index_oid_t, std::string>>;
 
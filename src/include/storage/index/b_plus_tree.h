@@ -3,20 +3,28 @@
  *
  * Implementation of simple b+ tree data structure where internal pages direct
  * the search and leaf pages contain actual data.
- * (1) We only support unique key
+ * (1) Keys are unique unless the tree is created non-unique, which orders
+ *     entries by (key, rid)
  * (2) support insert & remove
- * (3) The structure should shrink and grow dynamically
+ * (3) The structure should shrink and grow dynamically. Removes only take the
+ *     entry out of its leaf; underfull pages are merged by a compaction pass,
+ *     which can run in a background thread
  * (4) Implement index iterator for range scan
  */
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <deque>
 #include <iostream>
+#include <limits>
+#include <mutex>  // NOLINT
 #include <optional>
 #include <queue>
 #include <shared_mutex>
 #include <string>
+#include <thread>  // NOLINT
+#include <utility>
 #include <vector>
 
 #include "common/config.h"
@@ -57,6 +65,8 @@ class Context {
 };
 
 #define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
+// pages filled below this share are merged with a sibling by compaction
+#define BPLUS_TREE_COMPACTION_THRESHOLD 0.25
 
 // Main class providing the API for the Interactive B+ Tree.
 INDEX_TEMPLATE_ARGUMENTS
@@ -67,7 +77,9 @@ class BPlusTree {
  public:
   explicit BPlusTree(std::string name, page_id_t header_page_id, BufferPoolManager *buffer_pool_manager,
                      const KeyComparator &comparator, int leaf_max_size = LEAF_PAGE_SIZE,
-                     int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int internal_max_size = INTERNAL_PAGE_SIZE, bool unique = true);
+
+  ~BPlusTree();
 
   // Returns true if this B+ tree has no keys and values.
   auto IsEmpty() const -> bool;
@@ -75,12 +87,30 @@ class BPlusTree {
   // Insert a key-value pair into this B+ tree.
   auto Insert(const KeyType &key, const ValueType &value, Transaction *txn = nullptr) -> bool;
 
-  // Remove a key and its value from this B+ tree.
+  // Remove a key and its value from this B+ tree, or every value of the key in a non-unique tree.
   void Remove(const KeyType &key, Transaction *txn);
 
-  // Return the value associated with a given key
+  // Remove a key-value pair from this B+ tree. A unique tree removes the key whatever its value.
+  void Remove(const KeyType &key, const ValueType &value, Transaction *txn);
+
+  // Merge pages filled below threshold (0 to 1) with a sibling, return how many pages were freed.
+  auto Compact(double threshold = BPLUS_TREE_COMPACTION_THRESHOLD) -> size_t;
+
+  // Run Compact every btree_compaction_interval, whenever entries were removed since the last run.
+  void StartCompaction(double threshold = BPLUS_TREE_COMPACTION_THRESHOLD);
+
+  void StopCompaction();
+
+  // Return the values associated with a given key, in rid order for a non-unique tree
   auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn = nullptr) -> bool;
 
+  // Insert a batch of key-value pairs, return how many were inserted.
+  auto InsertBatch(const std::vector<std::pair<KeyType, ValueType>> &entries, Transaction *txn = nullptr) -> size_t;
+
+  // Look up a batch of keys, result[i] receives the values associated with keys[i].
+  void GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *result,
+                 Transaction *txn = nullptr);
+
   // Return the page id of the root node
   auto GetRootPageId() -> page_id_t;
 
@@ -91,6 +121,16 @@ class BPlusTree {
 
   auto Begin(const KeyType &key) -> INDEXITERATOR_TYPE;
 
+  // Ascending scan over the keys in [key, upper]
+  auto Begin(const KeyType &key, const KeyType &upper) -> INDEXITERATOR_TYPE;
+
+  // Descending scans, from the last key, from the last key not greater than key, or over [lower, key]
+  auto RBegin() -> INDEXITERATOR_TYPE;
+
+  auto RBegin(const KeyType &key) -> INDEXITERATOR_TYPE;
+
+  auto RBegin(const KeyType &key, const KeyType &lower) -> INDEXITERATOR_TYPE;
+
   // Print the B+ tree
   void Print(BufferPoolManager *bpm);
 
@@ -130,6 +170,46 @@ class BPlusTree {
    */
   auto ToPrintableBPlusTree(page_id_t root_id) -> PrintableBPlusTree;
 
+  // rid stored next to a separator key; always zero in a unique tree
+  auto SeparatorRid(const ValueType &value) const -> RID { return unique_ ? RID(0) : value; }
+
+  // rid to search with so that a lookup lands on the first of a run of equal keys
+  auto SearchRid() const -> RID { return unique_ ? RID(0) : RID(std::numeric_limits<page_id_t>::min(), 0); }
+
+  auto LatchRoot(ReadPageGuard *root_guard, ReadPageGuard *header_guard) -> bool;
+
+  // make the root version odd, lookups then go through the header page until SetRoot
+  void BeginRootChange() { root_version_.fetch_add(1); }
+
+  void SetRoot(BPlusTreeHeaderPage *header, page_id_t root_page_id);
+
+  auto FindLeaf(const KeyType &key, const RID &rid, ReadPageGuard *parent_guard, ReadPageGuard *leaf_guard,
+                std::optional<std::pair<KeyType, RID>> *fence) -> bool;
+
+  auto BelowFence(const KeyType &key, const RID &rid, const std::optional<std::pair<KeyType, RID>> &fence) const
+      -> bool;
+
+  auto FindEdgeLeaf(bool rightmost, ReadPageGuard *leaf_guard) -> bool;
+
+  auto Scan(const KeyType &key, std::optional<KeyType> bound, bool reverse) -> INDEXITERATOR_TYPE;
+
+  auto CollectValues(ReadPageGuard *leaf_guard, const KeyType &key, std::vector<ValueType> *result) -> bool;
+
+  void RunCompaction();
+
+  auto TreeHeight() -> int;
+
+  auto LatchNode(int depth, const std::optional<std::pair<KeyType, RID>> &from, WritePageGuard *node_guard,
+                 std::optional<std::pair<KeyType, RID>> *fence) -> bool;
+
+  auto MergeChildren(InternalPage *node, double threshold) -> size_t;
+
+  auto MergeLeaves(WritePageGuard *left_guard, WritePageGuard *right_guard) -> bool;
+
+  auto ShrinkRoot() -> size_t;
+
+  void FreeRetiredPages();
+
   // member variable
   std::string index_name_;
   BufferPoolManager *bpm_;
@@ -138,6 +218,22 @@ class BPlusTree {
   int leaf_max_size_;
   int internal_max_size_;
   page_id_t header_page_id_;
+  bool unique_;
+  // copy of the root page id in the header page, so that lookups do not latch the header
+  std::atomic<page_id_t> root_page_id_{INVALID_PAGE_ID};
+  // incremented before and after each root change, odd while the root is being replaced
+  std::atomic<uint64_t> root_version_{0};
+  // incremented whenever pages are merged, lets iterators notice that a leaf they remember may be gone
+  std::atomic<uint64_t> merge_epoch_{0};
+  // entries removed since the last compaction
+  std::atomic<uint64_t> removed_{0};
+  // one compaction at a time
+  std::mutex compaction_latch_;
+  // merged pages that could not be freed yet because someone still had them pinned
+  std::vector<page_id_t> retired_pages_;
+  std::atomic<bool> enable_compaction_{false};
+  std::thread *compaction_thread_{nullptr};
+  double compaction_threshold_{BPLUS_TREE_COMPACTION_THRESHOLD};
 };
 
 /**
@@ -35,10 +35,25 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  auto InsertEntries(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) -> size_t override;
+
+  void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *result,
+                Transaction *transaction) override;
+
+  void ScanAll(std::vector<RID> *result, Transaction *transaction) override;
+
+  void ReverseScanAll(std::vector<RID> *result, Transaction *transaction) override;
+
   auto GetBeginIterator() -> INDEXITERATOR_TYPE;
 
   auto GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE;
 
+  auto GetBeginIterator(const KeyType &key, const KeyType &upper) -> INDEXITERATOR_TYPE;
+
+  auto GetReverseBeginIterator() -> INDEXITERATOR_TYPE;
+
+  auto GetReverseBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE;
+
   auto GetEndIterator() -> INDEXITERATOR_TYPE;
 
  protected:
@@ -0,0 +1,80 @@
+/**
+ * buffered_tree.h
+ *
+ * Write-optimized search tree in the style of a B-epsilon tree. Internal pages
+ * reserve most of their space for a buffer of pending insert and delete
+ * messages. A modification only appends a message to the root; once a buffer
+ * fills up, the messages headed for the busiest child are moved down in one
+ * batch, so each page write below the root is shared by many modifications.
+ * Lookups merge the messages found on their way down with the leaf entries.
+ *
+ * Entries are (key, value) pairs and a key may appear with several values.
+ */
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "concurrency/transaction.h"
+#include "storage/page/b_plus_tree_header_page.h"
+#include "storage/page/buffered_tree_internal_page.h"
+#include "storage/page/buffered_tree_leaf_page.h"
+#include "storage/page/page_guard.h"
+
+namespace bustub {
+
+#define BUFFERED_TREE_TYPE BufferedTree<KeyType, ValueType, KeyComparator>
+
+INDEX_TEMPLATE_ARGUMENTS
+class BufferedTree {
+  using InternalPage = BufferedTreeInternalPage<KeyType, ValueType, KeyComparator>;
+  using LeafPage = BufferedTreeLeafPage<KeyType, ValueType, KeyComparator>;
+  using Message = BufferedTreeMessage<KeyType, ValueType>;
+
+ public:
+  explicit BufferedTree(std::string name, page_id_t header_page_id, BufferPoolManager *buffer_pool_manager,
+                        const KeyComparator &comparator, int leaf_max_size = BUFFERED_TREE_LEAF_PAGE_SIZE,
+                        int internal_max_size = BUFFERED_TREE_INTERNAL_PAGE_SIZE);
+
+  // Returns true if this tree has no pages. A tree whose messages cancel out is not empty.
+  auto IsEmpty() const -> bool;
+
+  // Insert a key-value pair. The insert is blind, an existing pair is left as it is.
+  void Insert(const KeyType &key, const ValueType &value, Transaction *txn = nullptr);
+
+  // Remove a key-value pair, if present.
+  void Remove(const KeyType &key, const ValueType &value, Transaction *txn = nullptr);
+
+  // Return the values associated with a given key, in rid order
+  auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn = nullptr) -> bool;
+
+  // Return the page id of the root node
+  auto GetRootPageId() -> page_id_t;
+
+ private:
+  void Put(const Message &message);
+
+  void SplitRoot(BPlusTreeHeaderPage *header, WritePageGuard *root_guard);
+
+  auto IsFull(const BufferedTreePage *page) const -> bool;
+
+  void SplitChild(InternalPage *parent, int index, WritePageGuard *child_guard);
+
+  void FlushBuffer(InternalPage *node);
+
+  auto FlushChild(InternalPage *node, int index) -> bool;
+
+  void Collect(ReadPageGuard guard, const KeyType &key, std::vector<ValueType> *values,
+               std::vector<Message> *messages);
+
+  // member variable
+  std::string index_name_;
+  BufferPoolManager *bpm_;
+  KeyComparator comparator_;
+  int leaf_max_size_;
+  int internal_max_size_;
+  page_id_t header_page_id_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,47 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffered_tree_index.h
+//
+// Identification: src/include/storage/index/buffered_tree_index.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "storage/index/buffered_tree.h"
+#include "storage/index/index.h"
+
+namespace bustub {
+
+#define BUFFERED_TREE_INDEX_TYPE BufferedTreeIndex<KeyType, ValueType, KeyComparator>
+
+/**
+ * Index backed by a BufferedTree. Inserts and deletes are blind writes into the
+ * root buffer, which suits tables that take many more inserts than lookups.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BufferedTreeIndex : public Index {
+ public:
+  BufferedTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager);
+
+  // always true, the tree does not look for an existing entry
+  auto InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+ protected:
+  // comparator for key
+  KeyComparator comparator_;
+  // container
+  std::shared_ptr<BufferedTree<KeyType, ValueType, KeyComparator>> container_;
+};
+
+}  // namespace bustub
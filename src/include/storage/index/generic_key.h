@@ -14,6 +14,7 @@
 
 #include <cstring>
 
+#include "common/exception.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -30,6 +31,10 @@ template <size_t KeySize>
 class GenericKey {
  public:
   inline void SetFromKey(const Tuple &tuple) {
+    // a truncated key would lose the tail of its variable-length columns
+    if (tuple.GetLength() > KeySize) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "index key does not fit in " + std::to_string(KeySize) + " bytes");
+    }
     // intialize to 0
     memset(data_, 0, KeySize);
     memcpy(data_, tuple.GetData(), tuple.GetLength());
@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "common/exception.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -176,6 +177,57 @@ class Index {
    */
   virtual void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) = 0;
 
+  ///////////////////////////////////////////////////////////////////
+  // Batch Operations
+  ///////////////////////////////////////////////////////////////////
+
+  /**
+   * Insert a batch of entries into the index. Indexes that can share work between
+   * neighbouring keys override this; the default inserts the entries one by one.
+   * @param entries The index keys and the RIDs associated with them
+   * @param transaction The transaction context
+   * @returns the number of entries inserted
+   */
+  virtual auto InsertEntries(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) -> size_t {
+    size_t inserted = 0;
+    for (const auto &[key, rid] : entries) {
+      inserted += InsertEntry(key, rid, transaction) ? 1 : 0;
+    }
+    return inserted;
+  }
+
+  /**
+   * Search the index for a batch of keys.
+   * @param keys The index keys
+   * @param result Resized to the number of keys, result[i] is populated with the RIDs of keys[i]
+   * @param transaction The transaction context
+   */
+  virtual void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *result,
+                        Transaction *transaction) {
+    result->assign(keys.size(), {});
+    for (size_t i = 0; i < keys.size(); i++) {
+      ScanKey(keys[i], &(*result)[i], transaction);
+    }
+  }
+
+  /**
+   * Collect the RIDs of every entry in key order. Only indexes that keep their keys sorted override this.
+   * @param result The collection of RIDs that is populated with the entries, in key order
+   * @param transaction The transaction context
+   */
+  virtual void ScanAll(std::vector<RID> *result, Transaction *transaction) {
+    throw NotImplementedException(GetName() + " cannot be scanned in key order");
+  }
+
+  /**
+   * Collect the RIDs of every entry in descending key order. Only indexes that keep their keys sorted override this.
+   * @param result The collection of RIDs that is populated with the entries, in descending key order
+   * @param transaction The transaction context
+   */
+  virtual void ReverseScanAll(std::vector<RID> *result, Transaction *transaction) {
+    throw NotImplementedException(GetName() + " cannot be scanned in key order");
+  }
+
  private:
   /** The Index structure owns its metadata */
   std::unique_ptr<IndexMetadata> metadata_;
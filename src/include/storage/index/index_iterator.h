@@ -13,17 +13,54 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include <atomic>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "storage/page/b_plus_tree_header_page.h"
+#include "storage/page/b_plus_tree_internal_page.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/page_guard.h"
 
 namespace bustub {
 
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
+/**
+ * Range scan over the leaves of a B+ tree, in ascending or descending order.
+ *
+ * The iterator copies a leaf at a time into a batch under a short read latch and holds no
+ * latch between calls, so the tree stays open to concurrent inserts during a scan. Moving
+ * to the next leaf re-reads the sibling link of the current leaf with latch coupling, and
+ * entries up to the last one returned are skipped, so an entry is never returned twice even
+ * if the leaf was split in the meantime. After a batch is loaded, the following leaf is
+ * prefetched into the buffer pool.
+ *
+ * Background compaction may merge the current leaf into its left neighbour and free it. The
+ * tree counts such merges in a merge epoch; if the epoch moved since the batch was loaded, the
+ * scan descends from the root to the leaf now covering its position instead of trusting the
+ * leaf it remembers.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
+  using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>;
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+
  public:
-  // you may define your own constructor based on your member variables
+  // end iterator
   IndexIterator();
+
+  /**
+   * Start a scan at a leaf, which the caller has read latched. The latch is released before this returns.
+   * @param after the scan starts at the first entry past this one, or at the first entry of the leaf if nullopt
+   * @param bound the scan stops at the first key past this one, if any
+   * @param reverse whether to scan in descending order, `after` and `bound` then hold in the reverse sense
+   * @param merge_epoch the merge epoch of the tree, which must outlive the iterator
+   */
+  IndexIterator(BufferPoolManager *bpm, page_id_t header_page_id, const KeyComparator &comparator,
+                ReadPageGuard leaf_guard, std::optional<MappingType> after, std::optional<KeyType> bound,
+                bool reverse, const std::atomic<uint64_t> *merge_epoch);
   ~IndexIterator();  // NOLINT
 
   auto IsEnd() -> bool;
@@ -32,12 +69,48 @@ class IndexIterator {
 
   auto operator++() -> IndexIterator &;
 
-  auto operator==(const IndexIterator &itr) const -> bool { throw std::runtime_error("unimplemented"); }
+  /**
+   * Append the entries of the current leaf that were not returned yet to `batch`, then move on to the next leaf.
+   * @return false if the scan was already over
+   */
+  auto NextBatch(std::vector<MappingType> *batch) -> bool;
+
+  auto operator==(const IndexIterator &itr) const -> bool {
+    return page_id_ == itr.page_id_ && index_ == itr.index_;
+  }
 
-  auto operator!=(const IndexIterator &itr) const -> bool { throw std::runtime_error("unimplemented"); }
+  auto operator!=(const IndexIterator &itr) const -> bool { return !(*this == itr); }
 
  private:
-  // add your own private member variables here
+  // whether entry comes after last_ in scan order
+  auto Follows(const MappingType &entry) const -> bool;
+
+  void LoadLeaf(const LeafPage *leaf);
+
+  void Advance();
+
+  // descend to the leaf covering last_ (the first or last leaf if no entry was seen yet), used when a
+  // leaf link turns out to be stale
+  auto FindLeaf(ReadPageGuard *leaf_guard) -> bool;
+
+  void Finish();
+
+  BufferPoolManager *bpm_{nullptr};
+  page_id_t header_page_id_{INVALID_PAGE_ID};
+  std::optional<KeyComparator> comparator_;
+  const std::atomic<uint64_t> *merge_epoch_{nullptr};
+  // merge epoch of the tree when the batch was loaded
+  uint64_t epoch_{0};
+  bool reverse_{false};
+  std::optional<KeyType> bound_;
+  // last entry returned, or the entry to start after
+  std::optional<MappingType> last_;
+  // leaf the batch was read from, INVALID_PAGE_ID once the scan is over
+  page_id_t page_id_{INVALID_PAGE_ID};
+  // the batch reached the bound, no further leaf is read
+  bool bounded_{false};
+  std::vector<MappingType> batch_;
+  size_t index_{0};
 };
 
 }  // namespace bustub
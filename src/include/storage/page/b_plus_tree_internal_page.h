@@ -12,29 +12,41 @@
 
 #include <queue>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "storage/page/b_plus_tree_page.h"
 
 namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
-#define INTERNAL_PAGE_HEADER_SIZE 12
-#define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
+#define INTERNAL_PAGE_HEADER_SIZE 16
+// upper bound on the entry count, reached only when every key compresses to nothing
+#define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(page_id_t) + 4))
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
  * Pointer PAGE_ID(i) points to a subtree in which all keys K satisfy:
  * K(i) <= K < K(i+1).
+ * Each key is followed by a record id. In a non-unique tree, separators are
+ * ordered by (key, rid) so that a run of equal keys can span several leaves.
+ * A unique tree stores zero rids, which compress away.
  * NOTE: since the number of keys does not equal to number of child pointers,
  * the first key always remains invalid. That is to say, any search/lookup
  * should ignore the first key.
  *
- * Internal page format (keys are stored in increasing order):
+ * The first key is kept as the lower fence of the page so that it compresses
+ * like the others.
+ *
+ * Internal page format (keys are stored in increasing order, see BPlusTreePage
+ * for the cell format):
  *  --------------------------------------------------------------------------
- * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
+ * | HEADER | PREFIX | SLOT(1) ... SLOT(n) | FREE | KEY(n)+PAGE_ID(n) | ... | KEY(1)+PAGE_ID(1) |
  *  --------------------------------------------------------------------------
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeInternalPage : public BPlusTreePage {
+  static_assert(sizeof(KeyType) + sizeof(RID) < 256, "key length must fit in a cell header byte");
+
  public:
   // Deleted to disallow initialization
   BPlusTreeInternalPage() = delete;
@@ -53,12 +65,19 @@ class BPlusTreeInternalPage : public BPlusTreePage {
    */
   auto KeyAt(int index) const -> KeyType;
 
+  /**
+   * @param index The index of the key to get. Index must be non-zero.
+   * @return Record id that breaks ties between equal keys at index
+   */
+  auto RidAt(int index) const -> RID;
+
   /**
    *
    * @param index The index of the key to set. Index must be non-zero.
    * @param key The new value for key
+   * @param rid The new record id for key
    */
-  void SetKeyAt(int index, const KeyType &key);
+  void SetKeyAt(int index, const KeyType &key, const RID &rid);
 
   /**
    *
@@ -76,10 +95,11 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   /**
    *
    * @param key
+   * @param rid
    * @param key_comparator
-   * @return
+   * @return the index of the child whose subtree covers (key, rid)
    */
-  auto KeyIndex(const KeyType &key, const KeyComparator &key_comparator) const -> int;
+  auto KeyIndex(const KeyType &key, const RID &rid, const KeyComparator &key_comparator) const -> int;
 
   /**
    * @brief For test only, return a string representing all keys in
@@ -107,13 +127,42 @@ class BPlusTreeInternalPage : public BPlusTreePage {
     return kstr;
   }
   void SetValueAt(int index, const ValueType &value);
-  void ReduceToHalf(bool smaller);
-  void InsertAtBack(const KeyType &key, const ValueType &value);
-  void InsertAtBack(const MappingType &pair);
-  void InsertAtFront(const MappingType &pair);
-  void InsertValue(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
+  void InsertAtBack(const KeyType &key, const RID &rid, const ValueType &value);
+  void InsertValue(const KeyType &key, const RID &rid, const ValueType &value, const KeyComparator &comparator);
+  void RemoveAt(int index);
+
+  /** @return whether inserting this separator keeps the page within its max size and free space */
+  auto CanInsert(const KeyType &key, const RID &rid) const -> bool;
+
+  /** @return whether any separator can be inserted without splitting this page */
+  auto CanInsertAny() const -> bool;
+
+  /** @return the separator lifted to the parent if this page is split while inserting (key, rid) */
+  auto SplitKey(const KeyType &key, const RID &rid, const KeyComparator &comparator) const -> std::pair<KeyType, RID>;
+
+  /**
+   * Insert a new separator into this page and move the upper part of the entries into the empty
+   * `recipient`. The first separator of the recipient is the one lifted to the parent.
+   */
+  void InsertAndSplit(const KeyType &key, const RID &rid, const ValueType &value, const KeyComparator &comparator,
+                      BPlusTreeInternalPage *recipient);
+
+  /** @return how full this page is, from 0 to 1, by entry count or by bytes, whichever is higher */
+  auto FillRatio() const -> double;
+
+  /**
+   * Move all entries of `sibling`, the next child of the same parent, to the end of this page, leaving the
+   * sibling empty. (key, rid) is the separator of the sibling in the parent, it becomes the key of its first child.
+   * @return false if they do not fit, neither page is changed then
+   */
+  auto MergeFrom(BPlusTreeInternalPage *sibling, const KeyType &key, const RID &rid) -> bool;
+
  private:
-  // Flexible array member for page data.
-  MappingType array_[0];
+  static constexpr size_t SEPARATOR_SIZE = sizeof(KeyType) + sizeof(RID);
+  static constexpr BPlusTreeCellLayout CELL_LAYOUT{INTERNAL_PAGE_HEADER_SIZE, SEPARATOR_SIZE, sizeof(ValueType)};
+
+  auto CompareAt(int index, const KeyType &key, const RID &rid, const KeyComparator &comparator) const -> int;
+  void GatherWith(const KeyType &key, const RID &rid, const ValueType &value, const KeyComparator &comparator,
+                  std::vector<char> *separators, std::vector<ValueType> *values) const;
 };
 }  // namespace bustub
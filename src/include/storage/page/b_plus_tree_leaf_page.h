@@ -19,29 +19,37 @@
 namespace bustub {
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
-#define LEAF_PAGE_HEADER_SIZE 16
-#define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
+#define LEAF_PAGE_HEADER_SIZE 24
+// upper bound on the entry count, reached only when every key compresses to nothing
+#define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / (sizeof(ValueType) + 4))
 
 /**
  * Store indexed key and record id(record id = page id combined with slot id,
  * see include/common/rid.h for detailed implementation) together within leaf
- * page. Only support unique key.
+ * page. Entries are ordered by key, and by (key, rid) in a non-unique tree.
  *
- * Leaf page format (keys are stored in order):
+ * Leaf page format (keys are stored in order, see BPlusTreePage for the cell format):
  *  ----------------------------------------------------------------------
- * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
+ * | HEADER | PREFIX | SLOT(1) ... SLOT(n) | FREE | KEY(n) + RID(n) | ... | KEY(1) + RID(1)
  *  ----------------------------------------------------------------------
  *
- *  Header format (size in byte, 16 bytes in total):
+ *  Header format (size in byte, 24 bytes in total):
  *  ---------------------------------------------------------------------
- * | PageType (4) | CurrentSize (4) | MaxSize (4) |
+ * | PageType (4) | CurrentSize (4) | MaxSize (4) | PrefixLen (2) | CellStart (2) |
  *  ---------------------------------------------------------------------
  *  -----------------------------------------------
- * |  NextPageId (4)
+ * |  NextPageId (4) | PrevPageId (4) |
  *  -----------------------------------------------
+ *
+ * Leaves are linked in both directions so that they can be scanned in either order.
+ *
+ * Since keys are compressed, how many entries fit depends on the keys. Max size only caps
+ * the entry count; a page is also full once its cell area runs out of space.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeLeafPage : public BPlusTreePage {
+  static_assert(sizeof(KeyType) < 256, "key length must fit in a cell header byte");
+
  public:
   // Delete all constructor / destructor to ensure memory safety
   BPlusTreeLeafPage() = delete;
@@ -57,17 +65,40 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   // helper methods
   auto GetNextPageId() const -> page_id_t;
   void SetNextPageId(page_id_t next_page_id);
+  auto GetPrevPageId() const -> page_id_t;
+  void SetPrevPageId(page_id_t prev_page_id);
   auto KeyAt(int index) const -> KeyType;
-  void SetKeyAt(int index, const KeyType &key);
   auto ValueAt(int index) const -> ValueType;
   void SetValueAt(int index, const ValueType &value);
   auto IndexAt(const KeyType &key, const KeyComparator &comparator) const -> int;
+  auto IndexAt(const KeyType &key, const ValueType &value, const KeyComparator &comparator) const -> int;
   auto GetValue(const KeyType &key, ValueType *value, const KeyComparator &comparator) const -> bool;
   auto InsertValue(const KeyType &key, const ValueType &value, const KeyComparator &comparator) -> bool;
+  void InsertAt(int index, const KeyType &key, const ValueType &value);
   void InsertAtBack(const KeyType &key, const ValueType &value);
   void InsertAtBack(const MappingType &pair);
+  void RemoveAt(int index);
+
+  /** @return whether inserting this key keeps the page below its max size and within its free space */
+  auto CanInsert(const KeyType &key) const -> bool;
 
-  void ReduceToHalf();
+  /** @return the first entry of the new sibling if this page is split while inserting a pair at index */
+  auto SplitKey(int index, const KeyType &key, const ValueType &value) const -> MappingType;
+
+  /**
+   * Insert a new pair at index and move the upper part of the entries into the empty
+   * `recipient`. Each page picks a new prefix for its part.
+   */
+  void InsertAndSplit(int index, const KeyType &key, const ValueType &value, BPlusTreeLeafPage *recipient);
+
+  /** @return how full this page is, from 0 to 1, by entry count or by bytes, whichever is higher */
+  auto FillRatio() const -> double;
+
+  /**
+   * Move all entries of `sibling`, the next leaf, to the end of this page, leaving the sibling empty.
+   * @return false if they do not fit, neither page is changed then
+   */
+  auto MergeFrom(BPlusTreeLeafPage *sibling) -> bool;
 
   /**
    * @brief for test only return a string representing all keys in
@@ -95,8 +126,11 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   }
 
  private:
+  static constexpr BPlusTreeCellLayout CELL_LAYOUT{LEAF_PAGE_HEADER_SIZE, sizeof(KeyType), sizeof(ValueType)};
+
+  auto EntriesWith(int index, const KeyType &key, const ValueType &value) const -> std::vector<MappingType>;
+
   page_id_t next_page_id_;
-  // Flexible array member for page data.
-  MappingType array_[0];
+  page_id_t prev_page_id_;
 };
 }  // namespace bustub
@@ -15,8 +15,10 @@
 #include <climits>
 #include <cstdlib>
 #include <string>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
+#include "common/rid.h"
 #include "storage/index/generic_key.h"
 
 namespace bustub {
@@ -28,15 +30,52 @@ namespace bustub {
 // define page type enum
 enum class IndexPageType { INVALID_INDEX_PAGE = 0, LEAF_PAGE, INTERNAL_PAGE };
 
+/**
+ * Order of record ids, used to break ties between equal keys of a non-unique index.
+ * @return negative, zero or positive like a key comparator
+ */
+inline auto CompareRid(const RID &lhs, const RID &rhs) -> int {
+  if (lhs.GetPageId() != rhs.GetPageId()) {
+    return lhs.GetPageId() < rhs.GetPageId() ? -1 : 1;
+  }
+  if (lhs.GetSlotNum() != rhs.GetSlotNum()) {
+    return lhs.GetSlotNum() < rhs.GetSlotNum() ? -1 : 1;
+  }
+  return 0;
+}
+
+/**
+ * Byte sizes of the entries stored in a B+ tree page, together with the size of the
+ * page header that precedes the cell area. Leaf and internal pages each pass their own.
+ */
+struct BPlusTreeCellLayout {
+  size_t header_size_;
+  size_t key_size_;
+  size_t value_size_;
+};
+
 /**
  * Both internal and leaf page are inherited from this page.
  *
  * It actually serves as a header part for each B+ tree page and
  * contains information shared by both leaf page and internal page.
  *
- * Header format (size in byte, 12 bytes in total):
+ * Header format (size in byte, 16 bytes in total):
  * ----------------------------------------------------------------------------
- * | PageType (4) | CurrentSize (4) | MaxSize (4) |
+ * | PageType (4) | CurrentSize (4) | MaxSize (4) | PrefixLen (2) | CellStart (2) |
+ * ----------------------------------------------------------------------------
+ *
+ * Entries are kept in a slotted cell area that follows the (leaf / internal) header:
+ * ----------------------------------------------------------------------------
+ * | HEADER | PREFIX | SLOT(0) | SLOT(1) | ... FREE SPACE ... | CELL(n) | ... | CELL(0) |
+ * ----------------------------------------------------------------------------
+ *                                                            ^ CellStart
+ *
+ * PREFIX holds key bytes shared by the keys of this page. Each slot is the 2-byte offset of
+ * its cell, and slots are kept in key order. A cell stores a key compressed against PREFIX
+ * (prefix compression) with its trailing zero bytes dropped (suffix truncation):
+ * ----------------------------------------------------------------------------
+ * | Shared (1) | TrailingZeros (1) | KEY BYTES [Shared, KeySize - TrailingZeros) | VALUE |
  * ----------------------------------------------------------------------------
  */
 class BPlusTreePage {
@@ -57,11 +96,81 @@ class BPlusTreePage {
   void SetMaxSize(int max_size);
   auto GetMinSize() const -> int;
 
+ protected:
+  /** Reset the cell area to hold no entries, with the given shared key prefix. */
+  void ResetCells(const BPlusTreeCellLayout &layout, const char *prefix, size_t prefix_len);
+
+  /** Copy the (decompressed) key and/or value of the entry at `index`. Either output may be nullptr. */
+  void ReadCell(const BPlusTreeCellLayout &layout, int index, char *key, char *value) const;
+
+  /** Overwrite the value of the entry at `index`. Values are fixed-size, so this never moves the cell. */
+  void WriteCellValue(const BPlusTreeCellLayout &layout, int index, const char *value);
+
+  /** @return whether an entry with this key fits into the free space (possibly after compaction) */
+  auto HasRoomForCell(const BPlusTreeCellLayout &layout, const char *key) const -> bool;
+
+  /** @return whether an entry with any key fits, assuming the key does not compress at all */
+  auto HasRoomForAnyCell(const BPlusTreeCellLayout &layout) const -> bool;
+
+  /**
+   * Insert an entry at slot `index`, shifting the following slots to the right.
+   * @return false if the page does not have enough free space
+   */
+  auto InsertCell(const BPlusTreeCellLayout &layout, int index, const char *key, const char *value) -> bool;
+
+  /** Remove the entry at slot `index`, shifting the following slots to the left. */
+  void RemoveCell(const BPlusTreeCellLayout &layout, int index);
+
+  /** @return the bytes taken by the slot and cell of an entry with this key */
+  auto CellFootprint(const BPlusTreeCellLayout &layout, const char *key) const -> size_t;
+
+  /**
+   * Spread the given entries (in key order) over this page and `recipient`, replacing their contents. This page
+   * keeps the lower part. The split point is the one closest to the middle at which both pages can hold their part.
+   * Keys and values must not point into either page.
+   * @return the number of entries kept in this page
+   */
+  auto SplitCells(const BPlusTreeCellLayout &layout, const std::vector<const char *> &keys,
+                  const std::vector<const char *> &values, BPlusTreePage *recipient) -> size_t;
+
+  /** @return the split point SplitCells would choose for these entries, without modifying any page */
+  auto PlanSplit(const BPlusTreeCellLayout &layout, const std::vector<const char *> &keys) const -> size_t;
+
+  /**
+   * Replace the contents of this page with the given entries (in key order), compressed against their common
+   * prefix. Keys and values must not point into this page.
+   * @return false if the entries do not fit, the page is left as it was
+   */
+  auto MergeCells(const BPlusTreeCellLayout &layout, const std::vector<const char *> &keys,
+                  const std::vector<const char *> &values) -> bool;
+
+  /** @return the share of the cell area taken by the prefix, slots and live cells, from 0 to 1 */
+  auto CellAreaFill(const BPlusTreeCellLayout &layout) const -> double;
+
+  /** @return the shared key prefix of this page */
+  auto GetPrefix(const BPlusTreeCellLayout &layout) const -> const char *;
+  auto GetPrefixLen() const -> size_t { return prefix_len_; }
+
  private:
+  auto SlotAt(const BPlusTreeCellLayout &layout, int index) const -> uint16_t;
+  auto CellLength(const BPlusTreeCellLayout &layout, uint16_t offset) const -> size_t;
+  auto EncodedLength(const BPlusTreeCellLayout &layout, const char *key, uint8_t *shared, uint8_t *zeros) const
+      -> size_t;
+  auto FreeBytes(const BPlusTreeCellLayout &layout) const -> size_t;
+  auto LiveCellBytes(const BPlusTreeCellLayout &layout) const -> size_t;
+  void CompactCells(const BPlusTreeCellLayout &layout);
+  void AssignCells(const BPlusTreeCellLayout &layout, const std::vector<const char *> &keys,
+                   const std::vector<const char *> &values, size_t begin, size_t end, const char *prefix,
+                   size_t prefix_len);
+
   // member variable, attributes that both internal and leaf page share
-  IndexPageType page_type_ ;
-  int size_ ;
-  int max_size_ ;
+  IndexPageType page_type_;
+  int size_;
+  int max_size_;
+  uint16_t prefix_len_;
+  uint16_t cell_start_;
 };
 
+static_assert(sizeof(BPlusTreePage) == 16);
+
 }  // namespace bustub
@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffered_tree_internal_page.h
+//
+// Identification: src/include/storage/page/buffered_tree_internal_page.h
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "storage/page/buffered_tree_page.h"
+
+namespace bustub {
+
+#define BUFFERED_TREE_INTERNAL_PAGE_TYPE BufferedTreeInternalPage<KeyType, ValueType, KeyComparator>
+#define BUFFERED_TREE_INTERNAL_PAGE_HEADER_SIZE 20
+// pivots and children take about a quarter of the page, the message buffer takes the rest
+#define BUFFERED_TREE_INTERNAL_PAGE_SIZE                                                              \
+  std::max<int>(4, (BUSTUB_PAGE_SIZE - BUFFERED_TREE_INTERNAL_PAGE_HEADER_SIZE) / 4 /                 \
+                       (sizeof(MappingType) + sizeof(page_id_t)))
+
+/**
+ * Internal page of a buffered tree (a B-epsilon tree). Besides the pivots that
+ * direct the search, each internal page holds a buffer of messages on their
+ * way down to the leaves. Pivot i is the smallest (key, value) pair that can be
+ * found below child i; pivot 0 is never looked at. Messages are kept in arrival
+ * order, and every message in this page is newer than the messages below it.
+ *
+ * Internal page format:
+ *  ----------------------------------------------------------------------------------
+ * | HEADER | PIVOT(0) ... PIVOT(max) | CHILD(0) ... CHILD(max) | MESSAGE(1) ... MESSAGE(b)
+ *  ----------------------------------------------------------------------------------
+ *
+ * Header format (size in byte, 20 bytes in total):
+ * ----------------------------------------------------------------------------
+ * | PageType (4) | CurrentSize (4) | MaxSize (4) | BufferSize (4) | BufferMaxSize (4) |
+ * ----------------------------------------------------------------------------
+ *
+ * Size counts children. The buffer gets the space left over by MaxSize children.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BufferedTreeInternalPage : public BufferedTreePage {
+  using Message = BufferedTreeMessage<KeyType, ValueType>;
+
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  BufferedTreeInternalPage() = delete;
+  BufferedTreeInternalPage(const BufferedTreeInternalPage &other) = delete;
+
+  void Init(int max_size = BUFFERED_TREE_INTERNAL_PAGE_SIZE);
+
+  auto KeyAt(int index) const -> KeyType;
+  auto ValueAt(int index) const -> ValueType;
+  auto ChildAt(int index) const -> page_id_t;
+
+  /** @return the index of the child whose subtree covers (key, value) */
+  auto ChildIndex(const KeyType &key, const ValueType &value, const KeyComparator &comparator) const -> int;
+
+  /** Insert a child at index, with the smallest pair found below it as its pivot. */
+  void InsertChild(int index, const KeyType &key, const ValueType &value, page_id_t child);
+
+  auto GetBufferSize() const -> int { return buffer_size_; }
+  auto GetBufferMaxSize() const -> int { return buffer_max_size_; }
+  auto IsBufferFull() const -> bool { return buffer_size_ >= buffer_max_size_; }
+
+  auto MessageAt(int index) const -> const Message &;
+
+  /** Append a message to the buffer, which must not be full. */
+  void AppendMessage(const Message &message);
+
+  /** @return the child that most buffered messages are headed for */
+  auto BusiestChild(const KeyComparator &comparator) const -> int;
+
+  /**
+   * Remove up to `limit` of the messages headed for the child at index from the buffer, oldest first,
+   * and append them to `messages`.
+   */
+  void TakeMessages(int index, size_t limit, const KeyComparator &comparator, std::vector<Message> *messages);
+
+  /**
+   * Move the upper half of the children, together with the buffered messages headed for them, into the
+   * empty `recipient`.
+   * @return the pivot that separates this page from the recipient
+   */
+  auto MoveHalfTo(BufferedTreeInternalPage *recipient, const KeyComparator &comparator) -> MappingType;
+
+ private:
+  auto Pivots() const -> const MappingType * { return reinterpret_cast<const MappingType *>(data_); }
+  auto Pivots() -> MappingType * { return reinterpret_cast<MappingType *>(data_); }
+  auto Children() const -> const page_id_t * {
+    return reinterpret_cast<const page_id_t *>(data_ + GetMaxSize() * sizeof(MappingType));
+  }
+  auto Children() -> page_id_t * {
+    return reinterpret_cast<page_id_t *>(data_ + GetMaxSize() * sizeof(MappingType));
+  }
+  auto Messages() const -> const Message * {
+    return reinterpret_cast<const Message *>(data_ + GetMaxSize() * (sizeof(MappingType) + sizeof(page_id_t)));
+  }
+  auto Messages() -> Message * {
+    return reinterpret_cast<Message *>(data_ + GetMaxSize() * (sizeof(MappingType) + sizeof(page_id_t)));
+  }
+
+  int buffer_size_;
+  int buffer_max_size_;
+  // Flexible array member for page data.
+  char data_[0];
+};
+
+}  // namespace bustub
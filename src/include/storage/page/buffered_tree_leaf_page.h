@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffered_tree_leaf_page.h
+//
+// Identification: src/include/storage/page/buffered_tree_leaf_page.h
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <utility>
+
+#include "storage/page/buffered_tree_page.h"
+
+namespace bustub {
+
+#define BUFFERED_TREE_LEAF_PAGE_TYPE BufferedTreeLeafPage<KeyType, ValueType, KeyComparator>
+#define BUFFERED_TREE_LEAF_PAGE_HEADER_SIZE 12
+#define BUFFERED_TREE_LEAF_PAGE_SIZE \
+  ((BUSTUB_PAGE_SIZE - BUFFERED_TREE_LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
+
+/**
+ * Leaf page of a buffered tree. Entries are kept in (key, value) order, so a
+ * key may appear with several values.
+ *
+ * Leaf page format:
+ *  ----------------------------------------------------------------------
+ * | HEADER | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
+ *  ----------------------------------------------------------------------
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BufferedTreeLeafPage : public BufferedTreePage {
+  using Message = BufferedTreeMessage<KeyType, ValueType>;
+
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  BufferedTreeLeafPage() = delete;
+  BufferedTreeLeafPage(const BufferedTreeLeafPage &other) = delete;
+
+  void Init(int max_size = BUFFERED_TREE_LEAF_PAGE_SIZE);
+
+  auto KeyAt(int index) const -> KeyType;
+  auto ValueAt(int index) const -> ValueType;
+
+  /** @return the index of the first entry not less than key */
+  auto KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int;
+
+  /** @return the index of the first entry not less than (key, value) */
+  auto EntryIndex(const KeyType &key, const ValueType &value, const KeyComparator &comparator) const -> int;
+
+  /**
+   * Apply a message to this page. Inserting a pair that is present or deleting one
+   * that is not does nothing.
+   * @return false if the message inserts a new pair into a full page, which is left unchanged
+   */
+  auto Apply(const Message &message, const KeyComparator &comparator) -> bool;
+
+  /** Move the upper half of the entries into the empty `recipient`. */
+  void MoveHalfTo(BufferedTreeLeafPage *recipient);
+
+ private:
+  // Flexible array member for page data.
+  MappingType array_[0];
+};
+
+}  // namespace bustub
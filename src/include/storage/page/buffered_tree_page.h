@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffered_tree_page.h
+//
+// Identification: src/include/storage/page/buffered_tree_page.h
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+/** Operations that travel down a buffered tree as messages */
+enum class BufferedTreeOp : uint32_t { INSERT = 0, DELETE };
+
+/**
+ * A pending modification of a buffered tree. Messages wait in the buffers of
+ * internal pages and are applied once they reach a leaf.
+ */
+template <typename KeyType, typename ValueType>
+struct BufferedTreeMessage {
+  KeyType key_;
+  ValueType value_;
+  BufferedTreeOp op_;
+};
+
+/**
+ * Both internal and leaf pages of a buffered tree are inherited from this page.
+ *
+ * Header format (size in byte, 12 bytes in total):
+ * ----------------------------------------------------------------------------
+ * | PageType (4) | CurrentSize (4) | MaxSize (4) |
+ * ----------------------------------------------------------------------------
+ */
+class BufferedTreePage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  BufferedTreePage() = delete;
+  BufferedTreePage(const BufferedTreePage &other) = delete;
+  ~BufferedTreePage() = delete;
+
+  auto IsLeafPage() const -> bool { return page_type_ == IndexPageType::LEAF_PAGE; }
+  void SetPageType(IndexPageType page_type) { page_type_ = page_type; }
+
+  auto GetSize() const -> int { return size_; }
+  void SetSize(int size) { size_ = size; }
+  void IncreaseSize(int amount) { size_ += amount; }
+
+  auto GetMaxSize() const -> int { return max_size_; }
+  void SetMaxSize(int max_size) { max_size_ = max_size; }
+
+ private:
+  IndexPageType page_type_;
+  int size_;
+  int max_size_;
+};
+
+static_assert(sizeof(BufferedTreePage) == 12);
+
+}  // namespace bustub
@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map_page.h
+//
+// Identification: src/include/storage/page/free_space_map_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+
+namespace bustub {
+
+static constexpr uint64_t FREE_SPACE_MAP_PAGE_HEADER_SIZE = 8;
+
+/** The number of table pages one free space map page keeps the space class of. */
+static constexpr uint32_t FREE_SPACE_MAP_PAGE_CAPACITY =
+    (BUSTUB_PAGE_SIZE - FREE_SPACE_MAP_PAGE_HEADER_SIZE) / (sizeof(page_id_t) + sizeof(uint8_t));
+
+/**
+ * A page of a table's free space map. The pages form a chain, entry i of the chain is the i-th page of the
+ * table heap.
+ *
+ * Page format (size in bytes):
+ *  ------------------------------------------------------------------------------------------------
+ *  | NextPageId (4) | Size (4) | PageId_1 (4) | ... | PageId_n (4) | Class_1 (1) | ... | Class_n (1) |
+ *  ------------------------------------------------------------------------------------------------
+ */
+class FreeSpaceMapPage {
+ public:
+  /** Initialize an empty free space map page. */
+  void Init();
+
+  /** @return the number of entries in this page */
+  auto GetSize() const -> uint32_t { return size_; }
+
+  /** @return the page id of the next page of the map */
+  auto GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+  /** Set the page id of the next page of the map. */
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  /** @return true if no more entries fit in this page */
+  auto IsFull() const -> bool { return size_ == FREE_SPACE_MAP_PAGE_CAPACITY; }
+
+  /** @return the table page of entry index */
+  auto PageIdAt(uint32_t index) const -> page_id_t;
+
+  /** @return the space class of entry index */
+  auto SpaceClassAt(uint32_t index) const -> uint8_t;
+
+  /** Set the space class of entry index. */
+  void SetSpaceClassAt(uint32_t index, uint8_t space_class);
+
+  /** Append an entry for a table page. */
+  void Append(page_id_t page_id, uint8_t space_class);
+
+ private:
+  page_id_t next_page_id_;
+  uint32_t size_;
+  page_id_t page_ids_[FREE_SPACE_MAP_PAGE_CAPACITY];
+  uint8_t space_classes_[FREE_SPACE_MAP_PAGE_CAPACITY];
+};
+
+static_assert(sizeof(FreeSpaceMapPage) <= BUSTUB_PAGE_SIZE);
+
+}  // namespace bustub
@@ -30,9 +30,18 @@ namespace bustub {
  *  ----------------------------------------------------------------
  *
  *  Here '+' means concatenation.
- *  The above format omits the space required for the occupied_ and
- *  readable_ arrays. More information is in storage/page/hash_table_page_defs.h.
+ *  The above format omits the space required for the occupied_,
+ *  readable_ and fingerprints_ arrays. More information is in
+ *  storage/page/hash_table_page_defs.h.
  *
+ *  Every slot has a one byte fingerprint of its key, taken from a hash of the
+ *  key. A probe compares the fingerprints of BUCKET_GROUP_SIZE slots at once
+ *  (with SSE2 where available), and only compares the keys of readable slots
+ *  whose fingerprint matches, which in a full bucket is about one key.
+ *
+ *  Equal keys cannot be split apart, so a bucket that is full of keys with the
+ *  same hash continues on overflow pages: bucket pages linked through their
+ *  overflow page id, which only the bucket they hang off leads to.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class HashTableBucketPage {
@@ -40,12 +49,21 @@ class HashTableBucketPage {
   // Delete all constructor / destructor to ensure memory safety
   HashTableBucketPage() = delete;
 
+  /** Initialize a new bucket page, with no overflow page. */
+  void Init();
+
+  /** @return the page the bucket continues on, INVALID_PAGE_ID if none */
+  auto GetOverflowPageId() const -> page_id_t { return overflow_page_id_; }
+
+  /** Set the page the bucket continues on. */
+  void SetOverflowPageId(page_id_t overflow_page_id) { overflow_page_id_ = overflow_page_id; }
+
   /**
    * Scan the bucket and collect values that have the matching key
    *
    * @return true if at least one key matched
    */
-  auto GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) -> bool;
+  auto GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) const -> bool;
 
   /**
    * Attempts to insert a key and value in the bucket.  Uses the occupied_
@@ -120,28 +138,42 @@ class HashTableBucketPage {
   /**
    * @return the number of readable elements, i.e. current size
    */
-  auto NumReadable() -> uint32_t;
+  auto NumReadable() const -> uint32_t;
 
   /**
    * @return whether the bucket is full
    */
-  auto IsFull() -> bool;
+  auto IsFull() const -> bool;
 
   /**
    * @return whether the bucket is empty
    */
-  auto IsEmpty() -> bool;
+  auto IsEmpty() const -> bool;
 
   /**
    * Prints the bucket's occupancy information
    */
-  void PrintBucket();
+  void PrintBucket() const;
 
  private:
+  /** @return the fingerprint of key, the top byte of its hash */
+  static auto Fingerprint(KeyType key) -> uint8_t;
+
+  /**
+   * @return a mask with bit i set if slot group * BUCKET_GROUP_SIZE + i has the given fingerprint and is readable
+   */
+  auto MatchGroup(uint32_t group, uint8_t fingerprint) const -> uint32_t;
+
+  /** @return a mask with bit i set if slot group * BUCKET_GROUP_SIZE + i is set in the bitmap */
+  static auto GroupMask(const char *bitmap, uint32_t group) -> uint32_t;
+
   //  For more on BUCKET_ARRAY_SIZE see storage/page/hash_table_page_defs.h
-  char occupied_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
+  page_id_t overflow_page_id_;
+  char occupied_[BUCKET_GROUP_COUNT * BUCKET_GROUP_SIZE / 8];
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
-  char readable_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
+  char readable_[BUCKET_GROUP_COUNT * BUCKET_GROUP_SIZE / 8];
+  // Fingerprint of the key in each slot, meaningful for readable slots only.
+  uint8_t fingerprints_[BUCKET_GROUP_COUNT * BUCKET_GROUP_SIZE];
   // Flexible array member for page data.
   MappingType array_[1];
 };
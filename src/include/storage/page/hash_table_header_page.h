@@ -22,9 +22,13 @@
 
 namespace bustub {
 
+/** The number of block page ids that fit in a header page, after the 32 bytes of fields before them. */
+#define HASH_TABLE_HEADER_MAX_BLOCKS ((BUSTUB_PAGE_SIZE - 32) / sizeof(page_id_t))
+
 /**
  *
- * Header Page for linear probing hash table.
+ * Header Page for linear probing hash table. A layout too large for the block page ids of one header page lists
+ * directory pages in it instead, which are header pages that list the block page ids.
  *
  * Header format (size in byte, 16 bytes in total):
  * -------------------------------------------------------------
@@ -82,20 +86,20 @@ class HashTableHeaderPage {
    * @param index the index of the block
    * @return the page_id for the block.
    */
-  auto GetBlockPageId(size_t index) -> page_id_t;
+  auto GetBlockPageId(size_t index) const -> page_id_t;
 
   /**
    * @return the number of blocks currently stored in the header page
    */
-  auto NumBlocks() -> size_t;
+  auto NumBlocks() const -> size_t;
 
  private:
-  __attribute__((unused)) lsn_t lsn_;
-  __attribute__((unused)) size_t size_;
-  __attribute__((unused)) page_id_t page_id_;
-  __attribute__((unused)) size_t next_ind_;
+  lsn_t lsn_;
+  size_t size_;
+  page_id_t page_id_;
+  size_t next_ind_;
   // Flexible array member for page data.
-  __attribute__((unused)) page_id_t block_page_ids_[1];
+  page_id_t block_page_ids_[1];
 };
 
 }  // namespace bustub
@@ -35,10 +35,17 @@
 
 /**
  * BUCKET_ARRAY_SIZE is the number of (key, value) pairs that can be stored in an extendible hash index bucket page.
- * The computation is the same as the above BLOCK_ARRAY_SIZE, but blocks and buckets have different implementations
- * of search, insertion, removal, and helper methods.
+ * The computation is similar to the above BLOCK_ARRAY_SIZE, but each pair also takes a one byte fingerprint, and the
+ * occupied_, readable_ and fingerprint arrays are padded to whole groups of BUCKET_GROUP_SIZE slots. 32 bytes are
+ * held back for the padding and the overflow page id.
  */
-#define BUCKET_ARRAY_SIZE (4 * BUSTUB_PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+#define BUCKET_ARRAY_SIZE (4 * (BUSTUB_PAGE_SIZE - 32) / (4 * sizeof(MappingType) + 5))
+
+/**
+ * BUCKET_GROUP_SIZE is the number of fingerprints that are compared at once when a bucket page is probed.
+ */
+#define BUCKET_GROUP_SIZE 16
+#define BUCKET_GROUP_COUNT ((BUCKET_ARRAY_SIZE - 1) / BUCKET_GROUP_SIZE + 1)
 
 /**
  * DIRECTORY_ARRAY_SIZE is the number of page_ids that can fit in the directory page of an extendible hash index.
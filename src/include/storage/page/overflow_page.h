@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// overflow_page.h
+//
+// Identification: src/include/storage/page/overflow_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+
+namespace bustub {
+
+static constexpr uint64_t OVERFLOW_PAGE_HEADER_SIZE = 4;
+
+/** The bytes of a value one overflow page holds. */
+static constexpr uint32_t OVERFLOW_PAGE_CAPACITY = BUSTUB_PAGE_SIZE - OVERFLOW_PAGE_HEADER_SIZE;
+
+/**
+ * Set in the length of a varchar in a tuple whose characters are in overflow pages. The id of the first of them
+ * follows the length instead of the characters.
+ */
+static constexpr uint32_t TOAST_FLAG = 1U << 31;
+
+/** The bytes a varchar in overflow pages takes in its tuple, its length and the id of its first page */
+static constexpr uint32_t TOAST_POINTER_SIZE = sizeof(uint32_t) + sizeof(page_id_t);
+
+/**
+ * A page of the characters of a varchar too large to be kept in its tuple. The pages of a value form a chain, the
+ * length of the value in the tuple tells how much of the last one is used.
+ *
+ * Page format (size in bytes):
+ *  ----------------------------------
+ *  | NextPageId (4) | Data (4092) |
+ *  ----------------------------------
+ */
+class OverflowPage {
+ public:
+  /** Initialize the page as the last of its chain. */
+  void Init() { next_page_id_ = INVALID_PAGE_ID; }
+
+  /** @return the page id of the next page of the value */
+  auto GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+  /** Set the page id of the next page of the value. */
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  auto GetData() -> char * { return data_; }
+  auto GetData() const -> const char * { return data_; }
+
+ private:
+  page_id_t next_page_id_;
+  char data_[OVERFLOW_PAGE_CAPACITY];
+};
+
+static_assert(sizeof(OverflowPage) == BUSTUB_PAGE_SIZE);
+
+}  // namespace bustub
@@ -0,0 +1,244 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_page.h
+//
+// Identification: src/include/storage/page/pax_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+class ToastStore;
+
+static constexpr uint64_t PAX_PAGE_HEADER_SIZE = 16;
+
+/** How the values of a column are stored in a PAX page */
+enum class PaxEncoding : uint8_t {
+  /** As in a tuple */
+  Plain,
+  /** Integers as their difference to a base value of the page, in half their width */
+  FrameOfReference,
+  /** Varchars as the offset and size of their value in the varlen data, a value is stored once per page */
+  Dictionary,
+};
+
+/** The encoding of a column in a PAX page */
+struct PaxColumnEncoding {
+  PaxEncoding encoding_;
+  /** The bytes a value takes in the minipage */
+  uint8_t width_;
+  /** Whether base_ is set, it is by the first value that is not null */
+  bool has_base_;
+  uint8_t reserved_[5];
+  int64_t base_;
+};
+
+static_assert(sizeof(PaxColumnEncoding) == 16);
+
+/**
+ * Column-grouped (PAX) page format, for tables created with `WITH (format = pax)`:
+ *  ---------------------------------------------------------------------------------------------------------
+ *  | HEADER | TupleMeta_1 ... TupleMeta_c | Encoding_1 ... Encoding_n | MINIPAGE_1 | ... | MINIPAGE_n | ...
+ *  ---------------------------------------------------------------------------------------------------------
+ *  ----------------------
+ *  | FREE | VARLEN DATA |
+ *  ----------------------
+ *         ^
+ *         free space pointer
+ *
+ *  Header format (size in bytes):
+ *  -------------------------------------------------------------------------------------------
+ *  | NextPageId (4) | NumTuples (2) | NumDeletedTuples (2) | Capacity (2) | FixedEnd (2) | ...
+ *  -------------------------------------------------------------------------------------------
+ *  -----------------------------------------
+ *  | ... | FreeSpacePointer (2) | Flags (2) |
+ *  -----------------------------------------
+ *
+ * The page has room for the values of Capacity tuples, chosen from the schema and the encodings of the columns.
+ * Minipage i holds a null bitmap of the column, then its values one after the other, each in the width of the
+ * encoding of the column.
+ *
+ * Integer columns start out with frame-of-reference codes, and are laid out again as plain ones when a value does
+ * not fit in a code, with a smaller capacity. A page that has no room for that any more is closed to inserts.
+ * Equal varchars of a column share their data, and equality predicates compare codes and offsets rather than
+ * values.
+ *
+ * The first 8 bytes of the header are laid out as in TablePage, so the page chain and the tuple counts read the
+ * same in both formats.
+ */
+class PaxPage {
+ public:
+  /** Initialize an empty page for tuples of the schema. */
+  void Init(const Schema &schema);
+
+  /** @return number of tuples in this page */
+  auto GetNumTuples() const -> uint32_t { return num_tuples_; }
+
+  /** @return number of deleted tuples in this page, vacuumed or not */
+  auto GetNumDeletedTuples() const -> uint32_t { return num_deleted_tuples_; }
+
+  /** @return the number of tuples this page has room for */
+  auto GetCapacity() const -> uint32_t { return capacity_; }
+
+  /** @return the page ID of the next table page */
+  auto GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+  /** Set the page id of the next page in the table. */
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  /** @return the encoding of a column in this page */
+  auto GetEncoding(uint32_t column_idx) const -> const PaxColumnEncoding & { return Encodings()[column_idx]; }
+
+  /**
+   * @return the room left for inserts: nothing once every row is taken or the page is closed, else
+   * FREE_SPACE_CLASS_SIZE for the row and the bytes left for varlen data
+   */
+  auto GetFreeSpace() const -> size_t;
+
+  /** @return the most room a tuple takes in a page, in the unit of GetFreeSpace */
+  static auto GetTupleSpace(const Tuple &tuple, const Schema &schema) -> size_t;
+
+  /**
+   * Insert a tuple, its values go to the minipages of their columns.
+   * @return the slot of the tuple, nullopt if it does not fit
+   */
+  auto InsertTuple(const TupleMeta &meta, const Tuple &tuple, const Schema &schema) -> std::optional<uint16_t>;
+
+  /** Update a tuple meta. A vacuumed tuple cannot be restored. */
+  void UpdateTupleMeta(const TupleMeta &meta, const RID &rid, const Schema &schema);
+
+  /** Read a tuple, put together from its values in the minipages. */
+  auto GetTuple(const RID &rid, const Schema &schema) const -> std::pair<TupleMeta, Tuple>;
+
+  /** Read a tuple meta. */
+  auto GetTupleMeta(const RID &rid) const -> TupleMeta;
+
+  /**
+   * Update a tuple in place. A varchar value that is not the old one, or one already in the page, takes the place
+   * of the old one if it is of its size and no other tuple shares it, else it goes to the free space. Throws if the
+   * page has no room for it.
+   */
+  void UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid, const Schema &schema);
+
+  /** @return whether the value of a column of a tuple is null, read from the null bitmap alone */
+  auto IsNull(const Schema &schema, uint32_t column_idx, uint16_t slot) const -> bool;
+
+  /**
+   * @return the value of a column of a tuple, read from the minipage of the column alone, and from overflow pages
+   * through toast if the value is in them
+   */
+  auto GetValue(const Schema &schema, uint32_t column_idx, uint16_t slot, const ToastStore *toast = nullptr) const
+      -> Value;
+
+  /**
+   * Clear the matches of the tuples whose value of a column is not equal to a value. Encoded columns are compared
+   * without decoding: the value is encoded once, and the codes or offsets of the tuples are compared to it. A
+   * varchar in overflow pages is not read, and left as a match.
+   * @param[in,out] matches a flag for every tuple of the page
+   * @return false if the value cannot be compared to the column this way, matches are left as they were
+   */
+  auto MatchEquals(const Schema &schema, uint32_t column_idx, const Value &value, std::vector<bool> *matches) const
+      -> bool;
+
+  /**
+   * Vacuum the page: drop the varlen data of tuples whose delete committed and move the rest together at the end
+   * of the page.
+   * @return the bytes of room gained
+   */
+  auto Compact(const Schema &schema) -> size_t;
+
+ private:
+  /** The offset and size of a varchar value in the varlen data */
+  using VarEntry = std::pair<uint16_t, uint16_t>;
+  static constexpr uint32_t VAR_ENTRY_SIZE = 4;
+  static_assert(sizeof(VarEntry) == VAR_ENTRY_SIZE);
+
+  /** Set in the flags of a page that takes no more inserts */
+  static constexpr uint16_t PAX_PAGE_CLOSED = 1;
+
+  /**
+   * @return the number of tuples a page has room for in room bytes after the header, leaving room for varchars half
+   * as long as they may be if reserve_varlen is set
+   */
+  static auto ComputeCapacity(const Schema &schema, const std::vector<PaxColumnEncoding> &encodings, size_t room,
+                              bool reserve_varlen) -> uint16_t;
+
+  /**
+   * Lay the fixed part of the page out again for other encodings of the columns, the varlen data stays in place.
+   * @return false, leaving the page as it was, if it would not have room for min_capacity tuples
+   */
+  auto Relayout(const Schema &schema, const std::vector<PaxColumnEncoding> &encodings, uint32_t min_capacity)
+      -> bool;
+
+  /** @return whether a value that is not null can be stored in its column as encoded now */
+  auto Fits(uint32_t column_idx, const Value &value) const -> bool;
+
+  /** @return the offset of the null bitmap of a column, its values follow */
+  auto ColumnStart(const Schema &schema, uint32_t column_idx) const -> uint32_t;
+
+  /** @return the bytes of a null bitmap */
+  auto BitmapSize() const -> uint32_t { return (capacity_ + 7) / 8; }
+
+  auto ValueAt(const Schema &schema, uint32_t column_idx, uint16_t slot) -> char *;
+  auto ValueAt(const Schema &schema, uint32_t column_idx, uint16_t slot) const -> const char *;
+
+  void SetNull(const Schema &schema, uint32_t column_idx, uint16_t slot, bool is_null);
+
+  /** @return the value of an inlined column of a tuple that is not null, decoded */
+  auto ReadFixed(const Schema &schema, uint32_t column_idx, uint16_t slot) const -> Value;
+
+  /** Store the value of an inlined column of a tuple that is not null, encoded, it must fit. */
+  void WriteFixed(const Schema &schema, uint32_t column_idx, uint16_t slot, const Value &value);
+
+  /** @return the offset of a varchar value, length first, of a column in the varlen data if a tuple has it */
+  auto FindVarchar(const Schema &schema, uint32_t column_idx, const char *data, uint32_t size) const
+      -> std::optional<uint16_t>;
+
+  /** @return whether a tuple other than the one in slot has its varchar of a column at offset */
+  auto IsVarcharShared(const Schema &schema, uint32_t column_idx, uint16_t slot, uint16_t offset) const -> bool;
+
+  auto Metas() -> TupleMeta * { return reinterpret_cast<TupleMeta *>(page_start_ + PAX_PAGE_HEADER_SIZE); }
+  auto Metas() const -> const TupleMeta * {
+    return reinterpret_cast<const TupleMeta *>(page_start_ + PAX_PAGE_HEADER_SIZE);
+  }
+
+  /** @return the offset of the encodings, after the metas and aligned for their base values */
+  auto EncodingsStart() const -> uint32_t {
+    return (PAX_PAGE_HEADER_SIZE + capacity_ * sizeof(TupleMeta) + alignof(int64_t) - 1) / alignof(int64_t) *
+           alignof(int64_t);
+  }
+  auto Encodings() -> PaxColumnEncoding * {
+    return reinterpret_cast<PaxColumnEncoding *>(page_start_ + EncodingsStart());
+  }
+  auto Encodings() const -> const PaxColumnEncoding * {
+    return reinterpret_cast<const PaxColumnEncoding *>(page_start_ + EncodingsStart());
+  }
+
+  char page_start_[0];
+  page_id_t next_page_id_;
+  uint16_t num_tuples_;
+  uint16_t num_deleted_tuples_;
+  uint16_t capacity_;
+  uint16_t fixed_end_;
+  uint16_t free_space_pointer_;
+  uint16_t flags_;
+};
+
+static_assert(sizeof(PaxPage) == PAX_PAGE_HEADER_SIZE);
+
+}  // namespace bustub
@@ -47,6 +47,15 @@ static constexpr uint64_t TABLE_PAGE_HEADER_SIZE = 8;
  *
  * Tuple format:
  * | meta | data |
+ *
+ * The data of a tuple lies below the data of the tuples in the slots before it, so the offset of the last slot is
+ * the free space pointer. Compact keeps it that way, and so does an update that changes the size of a tuple, it
+ * moves the data of the tuples around it.
+ *
+ * A tuple updated to more than its page has room for is moved to another page, and its slot forwards to the rid
+ * there, so its own rid stays valid. The two high bits of the size of a slot mark a forwarding slot, whose data is
+ * the rid the tuple moved to, and a tuple that was moved in, which scans pass over and read through the slot that
+ * forwards to it.
  */
 
 class TablePage {
@@ -59,21 +68,31 @@ class TablePage {
   /** @return number of tuples in this page */
   auto GetNumTuples() const -> uint32_t { return num_tuples_; }
 
+  /** @return number of deleted tuples in this page, vacuumed or not */
+  auto GetNumDeletedTuples() const -> uint32_t { return num_deleted_tuples_; }
+
   /** @return the page ID of the next table page */
   auto GetNextPageId() const -> page_id_t { return next_page_id_; }
 
   /** Set the page id of the next page in the table. */
   void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
 
+  /** @return the bytes between the slot array and the tuple data, the room left for inserts */
+  auto GetFreeSpace() const -> size_t;
+
+  /** @return the bytes a tuple takes in a page, its data and its slot */
+  static auto GetTupleSpace(const Tuple &tuple) -> size_t { return tuple.GetLength() + TUPLE_INFO_SIZE; }
+
   /** Get the next offset to insert, return nullopt if this tuple cannot fit in this page */
   auto GetNextTupleOffset(const TupleMeta &meta, const Tuple &tuple) const -> std::optional<uint16_t>;
 
   /**
    * Insert a tuple into the table.
    * @param tuple tuple to insert
+   * @param moved_in whether the tuple is the new place of a tuple moved out of its page by an update
    * @return true if the insert is successful (i.e. there is enough space)
    */
-  auto InsertTuple(const TupleMeta &meta, const Tuple &tuple) -> std::optional<uint16_t>;
+  auto InsertTuple(const TupleMeta &meta, const Tuple &tuple, bool moved_in = false) -> std::optional<uint16_t>;
 
   /**
    * Update a tuple.
@@ -85,20 +104,66 @@ class TablePage {
    */
   auto GetTuple(const RID &rid) const -> std::pair<TupleMeta, Tuple>;
 
+  /**
+   * Look at a tuple in place. The view is valid while the page is latched.
+   * @param schema the schema of the tuple, for the view to read values with
+   */
+  auto GetTupleView(const RID &rid, const Schema *schema) const -> std::pair<TupleMeta, TupleView>;
+
   /**
    * Read a tuple meta from a table.
    */
   auto GetTupleMeta(const RID &rid) const -> TupleMeta;
 
   /**
-   * Update a tuple in place.
+   * Update a tuple in place, throws if the page has no room for it.
    */
   void UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid);
 
+  /**
+   * Update a tuple in place, of any size. A forwarding slot gets its tuple back.
+   * @return false, leaving the page as it was, if the page has no room for the tuple
+   */
+  auto UpdateTupleInPlace(const TupleMeta &meta, const Tuple &tuple, RID rid) -> bool;
+
+  /**
+   * Make a slot forward to the rid its tuple was moved to, in place of its data.
+   * @return false, leaving the page as it was, if the page has no room for the rid
+   */
+  auto SetForward(const RID &rid, const RID &target) -> bool;
+
+  /** @return the rid the tuple of a forwarding slot was moved to, nullopt if the slot has its tuple */
+  auto GetForward(const RID &rid) const -> std::optional<RID>;
+
+  /** @return whether the tuple was moved into this page by an update, and is read through a forwarding slot */
+  auto IsMovedIn(const RID &rid) const -> bool;
+
+  /**
+   * Vacuum the page: drop the data of tuples whose delete committed and move the data of the others together at the
+   * end of the page. Slots stay where they are, so every rid stays valid, and a vacuumed tuple keeps its meta with no
+   * data.
+   * @return the bytes of room gained
+   */
+  auto Compact() -> size_t;
+
   static_assert(sizeof(page_id_t) == 4);
 
  private:
   using TupleInfo = std::tuple<uint16_t, uint16_t, TupleMeta>;
+
+  /** Set in the size of a forwarding slot */
+  static constexpr uint16_t TUPLE_FORWARDED = 1 << 15;
+  /** Set in the size of a tuple moved in */
+  static constexpr uint16_t TUPLE_MOVED_IN = 1 << 14;
+  /** The bits of the size of a slot that are its size */
+  static constexpr uint16_t TUPLE_SIZE_MASK = TUPLE_MOVED_IN - 1;
+
+  /**
+   * Lay out the data of the tuples again with other data for one of them, in slot order from the end of the page.
+   * @return false, leaving the page as it was, if it does not fit
+   */
+  auto Relayout(uint16_t tuple_id, const char *data, uint16_t size, uint16_t flags) -> bool;
+
   char page_start_[0];
   page_id_t next_page_id_;
   uint16_t num_tuples_;
@@ -1,14 +1,16 @@
 #pragma once
 
-#include "storage/page/page.h"
+#include <cstdint>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
 #include "storage/table/tmp_tuple.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
-// To pass the test cases for this class, you must follow the existing TmpTuplePage format and implement the
-// existing functions exactly as they are! It may be helpful to look at TablePage.
-// Remember that this task is optional, you get full credit if you finish the next task.
+static constexpr uint64_t TMP_TUPLE_PAGE_HEADER_SIZE = 12;
 
 /**
  * TmpTuplePage format:
@@ -17,20 +19,45 @@ namespace bustub {
  * | PageId (4) | LSN (4) | FreeSpace (4) | (free space) | TupleSize2 | TupleData2 | TupleSize1 | TupleData1 |
  *
  * We choose this format because DeserializeExpression expects to read Size followed by Data.
+ *
+ * A page of the intermediate results of a query, tuples are only appended and never updated or deleted. FreeSpace
+ * is the offset of the last tuple appended, and a TmpTuple the offset of the size of its tuple, so it reads
+ * the tuple without a slot array.
  */
-class TmpTuplePage : public Page {
+class TmpTuplePage {
  public:
-  void Init(page_id_t page_id, uint32_t page_size) {
-    memcpy(GetData(), &page_id, sizeof(page_id_t));
-    memcpy(GetData() + sizeof(page_id_t), &page_size, sizeof(uint32_t));
-  }
+  /** Initialize an empty page, page_size bytes long. */
+  void Init(page_id_t page_id, uint32_t page_size);
+
+  /** @return the page id of this page */
+  auto GetTablePageId() const -> page_id_t { return page_id_; }
+
+  /** @return the bytes left for tuples, their sizes included */
+  auto GetFreeSpace() const -> uint32_t { return free_space_pointer_ - TMP_TUPLE_PAGE_HEADER_SIZE; }
 
-  auto GetTablePageId() -> page_id_t { return INVALID_PAGE_ID; }
+  /**
+   * Append a tuple to the page.
+   * @param[out] out where the tuple is in the page
+   * @return false if the page has no room for it
+   */
+  auto Insert(const Tuple &tuple, TmpTuple *out) -> bool;
 
-  auto Insert(const Tuple &tuple, TmpTuple *out) -> bool { return false; }
+  /** @return the offsets of the tuples of a page page_size bytes long, in the order they were inserted */
+  auto GetTupleOffsets(uint32_t page_size) const -> std::vector<uint32_t>;
+
+  /** @return a copy of the tuple at offset */
+  auto GetTuple(size_t offset) const -> Tuple;
+
+  /** @return a view of the tuple at offset, valid while the page is pinned */
+  auto GetTupleView(size_t offset, const Schema *schema) const -> TupleView;
 
  private:
-  static_assert(sizeof(page_id_t) == 4);
+  char page_start_[0];
+  page_id_t page_id_;
+  lsn_t lsn_;
+  uint32_t free_space_pointer_;
 };
 
+static_assert(sizeof(TmpTuplePage) == TMP_TUPLE_PAGE_HEADER_SIZE);
+
 }  // namespace bustub
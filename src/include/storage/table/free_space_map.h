@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.h
+//
+// Identification: src/include/storage/table/free_space_map.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/** The bytes of room one space class stands for, a page has class free_space / FREE_SPACE_CLASS_SIZE. */
+static constexpr size_t FREE_SPACE_CLASS_SIZE = BUSTUB_PAGE_SIZE / 256;
+
+/**
+ * FreeSpaceMap keeps how much room every page of a table heap has left, so that an insert can go to any page
+ * it fits in rather than only to the last one.
+ *
+ * The room is kept as a space class of one byte per page, rounded down, so a page the map offers always has the
+ * room asked for. The classes sit in a tree of maxima in memory, which finds the first page with enough room in
+ * O(log n), and are written through to a chain of FreeSpaceMapPages, so a table opened again starts out with
+ * them.
+ *
+ * An inserter checks a page out and returns it when done. A checked out page is offered to nobody else, so
+ * concurrent inserters each fill a page of their own.
+ */
+class FreeSpaceMap {
+ public:
+  /**
+   * Create an empty map, and the first page to persist it in.
+   * @param bpm the buffer pool manager
+   */
+  explicit FreeSpaceMap(BufferPoolManager *bpm);
+
+  /**
+   * Open a map persisted before.
+   * @param bpm the buffer pool manager
+   * @param first_page_id the first page of the map
+   */
+  FreeSpaceMap(BufferPoolManager *bpm, page_id_t first_page_id);
+
+  /** @return the first page the map is persisted in */
+  auto GetFirstPageId() const -> page_id_t { return first_page_id_; }
+
+  /**
+   * Register a page appended to the end of the table heap, it starts out checked out by the caller.
+   * @param page_id the new page
+   * @param free_space the bytes of room the page has
+   */
+  void AddPage(page_id_t page_id, size_t free_space);
+
+  /**
+   * Record the room a page has after it changed.
+   * @param page_id the page
+   * @param free_space the bytes of room the page has now
+   */
+  void UpdatePage(page_id_t page_id, size_t free_space);
+
+  /**
+   * Check out the first page, in heap order, that has at least size bytes of room and is not checked out.
+   * @param size the bytes of room needed
+   * @return the page, nullopt if no page has the room
+   */
+  auto CheckOutPage(size_t size) -> std::optional<page_id_t>;
+
+  /**
+   * Check out a given page, unless somebody else has it checked out.
+   * @param page_id the page
+   * @return whether the page was checked out
+   */
+  auto TryCheckOutPage(page_id_t page_id) -> bool;
+
+  /**
+   * Return a checked out page.
+   * @param page_id the page
+   * @param free_space the bytes of room the page has now
+   */
+  void ReturnPage(page_id_t page_id, size_t free_space);
+
+  /** @return the position of a page in the table heap */
+  auto GetPageIndex(page_id_t page_id) -> size_t;
+
+  /** @return the page at a position in the table heap, INVALID_PAGE_ID past the last page */
+  auto GetPageId(size_t page_index) -> page_id_t;
+
+  /** @return the number of pages of the table heap */
+  auto GetNumPages() -> size_t;
+
+ private:
+  static auto ToSpaceClass(size_t free_space) -> uint8_t;
+
+  /** Set the class of the page at index, and persist it. */
+  void SetSpaceClass(size_t index, uint8_t space_class);
+
+  /** Set the leaf of the page at index to the class it can be offered with, and the maxima above it. */
+  void UpdateTree(size_t index);
+
+  /** Double the number of leaves of the tree of maxima. */
+  void Grow();
+
+  BufferPoolManager *bpm_;
+  page_id_t first_page_id_{INVALID_PAGE_ID};
+
+  std::mutex latch_;
+  /** The pages the map is persisted in */
+  std::vector<page_id_t> map_page_ids_;
+  /** The pages of the table heap, in heap order */
+  std::vector<page_id_t> page_ids_;
+  std::unordered_map<page_id_t, size_t> page_index_;
+  /** The space class of every page */
+  std::vector<uint8_t> space_classes_;
+  /** Whether every page is checked out */
+  std::vector<bool> checked_out_;
+  /** Tree of maxima over the classes of the pages that are not checked out, the root at 1 and the leaves from
+   * capacity_ on */
+  std::vector<uint8_t> tree_;
+  size_t capacity_{1};
+};
+
+}  // namespace bustub
@@ -12,40 +12,95 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <mutex>  // NOLINT
 #include <optional>
+#include <set>
+#include <thread>  // NOLINT
 #include <utility>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "common/config.h"
 #include "concurrency/lock_manager.h"
 #include "concurrency/transaction.h"
 #include "recovery/log_manager.h"
+#include "storage/page/pax_page.h"
 #include "storage/page/table_page.h"
+#include "storage/table/free_space_map.h"
 #include "storage/table/table_iterator.h"
+#include "storage/table/toast_store.h"
 #include "storage/table/tuple.h"
+#include "storage/table/zone_map.h"
 
 namespace bustub {
 
+/** The most pages background vacuum compacts every table_vacuum_interval, so that it stays out of the way */
+static constexpr size_t TABLE_VACUUM_PAGES_PER_ROUND = 16;
+
+/** How the tuples of a table are laid out in its pages */
+enum class TableFormat {
+  /** TablePage, every tuple in one piece */
+  Row,
+  /** PaxPage, the values of every column together */
+  Pax,
+};
+
 /**
  * TableHeap represents a physical table on disk.
  * This is just a doubly-linked list of pages.
+ *
+ * A free space map keeps the room every page has left, inserts go to the first page the tuple fits in and only
+ * append a page when none has room. Every insert checks its page out of the map, so concurrent inserts fill
+ * different pages, and latch_ is only taken to append a page and to count the tuples of a page.
+ *
+ * Deletes only mark tuples. Pages with deleted tuples are remembered, and vacuum compacts them later, in the
+ * background if started, and hands the room it gains back to the free space map. Only a delete whose meta has no
+ * delete txn left, i.e. a committed one, is vacuumed: a pending delete can still be rolled back, and is picked up
+ * once its meta is updated on commit.
+ *
+ * The pages are TablePages, or PaxPages for a table in the PAX format, which keeps the schema to lay the tuples
+ * out with. Both formats share the page chain and the tuple counts.
+ *
+ * The free space map doubles as the page directory of the table: it lists the pages in heap order, so a scan can
+ * start at any of them without walking the page chain, and be split into ranges of pages to run in parallel.
+ *
+ * A table that knows its schema keeps a PageZone of every page in memory, so that scans can pass over pages
+ * without fetching them. It also moves the largest varchars of a tuple longer than TOAST_TUPLE_THRESHOLD to
+ * overflow pages, so that no tuple is too large for a page: GetTuple and the iterator read them back, a TupleView
+ * only when the value is asked for. Vacuum frees the overflow pages of the deleted tuples it drops.
  */
 class TableHeap {
   friend class TableIterator;
 
  public:
-  ~TableHeap() = default;
+  ~TableHeap();
 
   /**
    * Create a table heap without a transaction. (open table)
    * @param buffer_pool_manager the buffer pool manager
+   * @param format the page format of the table
+   * @param schema the schema of the table, needed for the PAX format and for zone maps
+   */
+  explicit TableHeap(BufferPoolManager *bpm, TableFormat format = TableFormat::Row, const Schema *schema = nullptr);
+
+  /**
+   * Open a table heap created before.
+   * @param bpm the buffer pool manager
    * @param first_page_id the id of the first page
+   * @param free_space_map_page_id the id of the first page of its free space map
+   * @param format the page format of the table
+   * @param schema the schema of the table, needed for the PAX format and for zone maps
    */
-  explicit TableHeap(BufferPoolManager *bpm);
+  TableHeap(BufferPoolManager *bpm, page_id_t first_page_id, page_id_t free_space_map_page_id,
+            TableFormat format = TableFormat::Row, const Schema *schema = nullptr);
 
   /**
-   * Insert a tuple into the table. If the tuple is too large (>= page_size), return std::nullopt.
+   * Insert a tuple into the table. The fixed-size part of the tuple must fit in a page, and its varchars too unless
+   * the table knows its schema.
    * @param meta tuple meta
    * @param tuple tuple to insert
    * @return rid of the inserted tuple
@@ -53,6 +108,16 @@ class TableHeap {
   auto InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManager *lock_mgr = nullptr,
                    Transaction *txn = nullptr, table_oid_t oid = 0) -> std::optional<RID>;
 
+  /**
+   * Insert a batch of tuples into the table. Each page gets as many of them as fit under one write latch, and
+   * their rows are locked together.
+   * @param meta tuple meta of every tuple
+   * @param tuples tuples to insert
+   * @return rids of the inserted tuples, in the order of tuples
+   */
+  auto InsertTuples(const TupleMeta &meta, const std::vector<Tuple> &tuples, LockManager *lock_mgr = nullptr,
+                    Transaction *txn = nullptr, table_oid_t oid = 0) -> std::vector<RID>;
+
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
    * @param meta new tuple meta
@@ -81,23 +146,119 @@ class TableHeap {
   /** @return the iterator of this table, use this for project 4 except updates */
   auto MakeEagerIterator() -> TableIterator;
 
+  /**
+   * Split a scan of the table into iterators over disjoint ranges of its pages, that can run in threads of their
+   * own. Like MakeIterator, they do not scan tuples inserted from now on.
+   * @param num_partitions the number of iterators, some of them are at their end already if the table has fewer pages
+   * @return the iterators, together they scan every page once, in heap order
+   */
+  auto MakePartitionedIterators(size_t num_partitions) -> std::vector<TableIterator>;
+
   /** @return the id of the first page of this table */
   inline auto GetFirstPageId() const -> page_id_t { return first_page_id_; }
 
+  /** @return the id of the first page of the free space map of this table */
+  inline auto GetFreeSpaceMapPageId() const -> page_id_t { return free_space_map_.GetFirstPageId(); }
+
+  /** @return the page format of this table */
+  inline auto GetFormat() const -> TableFormat { return format_; }
+
+  /**
+   * @param page_index the position of a page in the table heap
+   * @param filter tells from the summary of a page whether it may hold a tuple to scan
+   * @return false if the page holds no tuple to scan, true if it may or the table keeps no zone maps
+   */
+  auto PageMayMatch(size_t page_index, const std::function<bool(const PageZone &)> &filter) -> bool;
+
   /**
    * Update a tuple in place. SHOULD NOT BE USED UNLESS YOU WANT TO OPTIMIZE FOR PROJECT 4.
+   *
+   * The tuple keeps its rid whatever its new size. In a table of TablePages it is updated in its page if the page
+   * has room, else it moves to a page that has and its slot forwards to it. A PAX page only takes varchars that it
+   * has room for in its varlen data.
    * @param meta new tuple meta
    * @param tuple  new tuple
    * @param[out] rid the rid of the tuple to be updated
    */
   void UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid);
 
+  /**
+   * Compact pages that had tuples deleted since they were last vacuumed. A page an insert has checked out is left
+   * for the next call. Tuples whose delete has not committed are kept. The vacuumed tuples keep their slots, so no
+   * rid changes, but they cannot be restored.
+   * @param max_pages the most pages to compact
+   * @return the bytes of room gained
+   */
+  auto Vacuum(size_t max_pages = SIZE_MAX) -> size_t;
+
+  /** Run Vacuum on at most TABLE_VACUUM_PAGES_PER_ROUND pages every table_vacuum_interval. */
+  void StartVacuum();
+
+  void StopVacuum();
+
  private:
+  /** Insert a tuple as it is to be stored, with its varchars in overflow pages already moved there. */
+  auto InsertStoredTuple(const TupleMeta &meta, const Tuple &stored, bool moved_in, LockManager *lock_mgr,
+                         Transaction *txn, table_oid_t oid) -> RID;
+
+  /**
+   * Update a tuple of a table of TablePages: in its page if it fits, else in a page with room that its slot
+   * forwards to.
+   * @return the first overflow pages of the values of the old tuple, to free
+   */
+  auto UpdateRowTuple(const TupleMeta &meta, const Tuple &stored, RID rid) -> std::vector<page_id_t>;
+
+  /**
+   * Update a tuple in the slot at rid if its page has room for it.
+   * @param[out] old_toast_page_ids the first overflow pages of the values of the old tuple, if the slot has them
+   * @param[out] moved_to the rid the slot forwarded to before the update
+   * @return whether the tuple was updated
+   */
+  auto UpdateRowTupleInPage(const TupleMeta &meta, const Tuple &stored, RID rid,
+                            std::vector<page_id_t> *old_toast_page_ids, std::optional<RID> *moved_to) -> bool;
+
+  /** Append an empty page to the table, it starts out checked out by the caller. */
+  auto AppendPage() -> page_id_t;
+
+  /** Remember a page to vacuum, must not be called with a page latch held. */
+  void AddPageToVacuum(page_id_t page_id);
+
+  void RunVacuum();
+
+  /** @return the room a tuple takes in a page of this table, in the unit of the free space map */
+  auto GetTupleSpace(const Tuple &tuple) const -> size_t;
+
+  /** @return the tuple to store for a tuple with varchars to move to overflow pages, nullopt if it has none */
+  auto Toast(const Tuple &tuple) -> std::optional<Tuple>;
+
+  /** @return a tuple read from a page with the varchars in overflow pages read back into it */
+  auto Detoast(Tuple tuple) const -> Tuple;
+
+  /** @return the first overflow pages of the varchars of a tuple as stored in a page, none if it was vacuumed */
+  auto GetToastPageIds(const Tuple &stored) const -> std::vector<page_id_t>;
+
   BufferPoolManager *bpm_;
+  TableFormat format_;
+  /* the schema of the table if it was given, PAX pages do not know it */
+  std::unique_ptr<Schema> schema_;
   page_id_t first_page_id_{INVALID_PAGE_ID};
+  FreeSpaceMap free_space_map_;
+  /* the varchars too large to be kept in their tuples, only used with a schema */
+  ToastStore toast_;
 
   std::mutex latch_;
   page_id_t last_page_id_{INVALID_PAGE_ID}; /* protected by latch_ */
+  /* the number of tuples in every page, in heap order, protected by latch_ */
+  std::vector<uint16_t> page_num_tuples_;
+  /* the summary of every page, in heap order, empty without a schema, protected by latch_ */
+  std::vector<PageZone> page_zones_;
+  /* the pages with tuples deleted since they were last vacuumed, protected by latch_ */
+  std::set<page_id_t> pages_to_vacuum_;
+
+  // one vacuum at a time
+  std::mutex vacuum_latch_;
+  std::atomic<bool> enable_vacuum_{false};
+  std::thread *vacuum_thread_{nullptr};
 };
 
 }  // namespace bustub
@@ -13,20 +13,35 @@
 #pragma once
 
 #include <cassert>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <utility>
+#include <vector>
 
+#include "common/config.h"
 #include "common/macros.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
+#include "storage/page/page_guard.h"
 #include "storage/table/tuple.h"
+#include "storage/table/zone_map.h"
 
 namespace bustub {
 
 class TableHeap;
+class TablePage;
 
 /**
  * TableIterator enables the sequential scan of a TableHeap.
+ *
+ * The iterator reads a page at a time: the tuples to scan are copied out of a page under a single read latch the
+ * first time one of them is asked for, and handed out from there, so a page is fetched from the buffer pool twice
+ * per scan rather than twice per tuple. NextPage looks at the tuples in place instead, and copies only those it
+ * keeps, and NextPageColumns reads single columns. With a page filter, the pages whose zone maps it rules out are
+ * not fetched at all, and with an equality filter the tuples of a PAX page are matched on their encoded values
+ * before any of them is put together.
  */
 class TableIterator {
   friend class Cursor;
@@ -34,7 +49,16 @@ class TableIterator {
  public:
   DISALLOW_COPY(TableIterator);
 
-  TableIterator(TableHeap *table_heap, RID rid, RID stop_at_rid);
+  /**
+   * @param table_heap the table to scan
+   * @param rid the first tuple to look at
+   * @param stop_at_num_tuples the number of tuples of every page, in heap order, that the scan returns, empty to scan
+   * every tuple there is
+   * @param page_index the position of the page of rid in the table heap
+   * @param end_page_index the position of the first page not to scan
+   */
+  TableIterator(TableHeap *table_heap, RID rid, std::vector<uint16_t> stop_at_num_tuples, size_t page_index = 0,
+                size_t end_page_index = SIZE_MAX);
   TableIterator(TableIterator &&) = default;
 
   ~TableIterator() = default;
@@ -47,14 +71,80 @@ class TableIterator {
 
   auto operator++() -> TableIterator &;
 
+  /**
+   * Pass over the pages, from the current one on, that the filter rules out from their summaries.
+   * @param filter tells from the summary of a page whether it may hold a tuple to scan
+   */
+  void SetPageFilter(std::function<bool(const PageZone &)> filter);
+
+  /**
+   * Leave out of NextPage, on PAX pages, the tuples whose value of a column is not equal to a constant. Other pages
+   * are not filtered, keep has to check the same predicate.
+   * @param filter pairs of a column and the value it has to be equal to
+   */
+  void SetEqualityFilter(std::vector<std::pair<uint32_t, Value>> filter) { equality_filter_ = std::move(filter); }
+
+  /**
+   * Hand out the tuples left on the current page that are not deleted, and move on to the next page.
+   * @param[out] tuples the tuples are appended to it, in rid order
+   * @param schema the schema the views handed to keep read values with
+   * @param keep if given, only the tuples it accepts are copied out of the page, it gets views that are valid
+   * while it runs
+   * @return false if the scan was at its end
+   */
+  auto NextPage(std::vector<Tuple> *tuples, const Schema *schema = nullptr,
+                const std::function<bool(const TupleView &)> &keep = nullptr) -> bool;
+
+  /**
+   * Hand out the values of some columns of the tuples left on the current page that are not deleted, and move on
+   * to the next page. A PAX page is only read where those columns are, and only the overflow pages of the varchars
+   * of those columns are read.
+   * @param schema the schema of the table
+   * @param column_ids the columns to read
+   * @param[out] columns the values of column_ids[i] are appended to columns[i], in rid order
+   * @param[out] rids if not null, the rids of the tuples are appended to it
+   * @return false if the scan was at its end
+   */
+  auto NextPageColumns(const Schema &schema, const std::vector<uint32_t> &column_ids,
+                       std::vector<std::vector<Value>> *columns, std::vector<RID> *rids = nullptr) -> bool;
+
  private:
+  /**
+   * Look at a tuple of a TablePage in place, where its slot forwards to if it was moved.
+   * @param[out] moved_guard holds the page the tuple was moved to while the view is used
+   * @return nullopt for a tuple moved in, which is read through the slot that forwards to it
+   */
+  auto GetRowTupleView(const TablePage *page, RID rid, const Schema *schema, ReadPageGuard *moved_guard)
+      -> std::optional<std::pair<TupleMeta, TupleView>>;
+
+  /** @return the number of tuples of the current page the scan returns */
+  auto NumTuplesToScan(uint32_t num_tuples) const -> uint32_t;
+
+  /** Move to the first tuple to scan from slot on in page_id, or else in the first page after it that has any. */
+  void LoadPage(page_id_t page_id, uint32_t slot);
+
   TableHeap *table_heap_;
   RID rid_;
-
-  // When creating table iterator, we will record the maximum RID that we should scan.
+  /** The position of the current page in the table heap */
+  size_t page_index_{0};
+  /** The position of the first page not to scan, the end of the partition of the table this iterator scans */
+  size_t end_page_index_;
+  /** The page after the current one */
+  page_id_t next_page_id_{INVALID_PAGE_ID};
+  /** The slot after the last one to scan in the current page */
+  uint32_t end_slot_{0};
+  /** The tuples of the current page from the slot at page_tuples_start_ on, copied by GetTuple */
+  std::vector<std::pair<TupleMeta, Tuple>> page_tuples_;
+  uint32_t page_tuples_start_{0};
+  /** The pages it rules out are skipped */
+  std::function<bool(const PageZone &)> page_filter_;
+  /** The tuples of a PAX page whose values are not equal to these are not handed out by NextPage */
+  std::vector<std::pair<uint32_t, Value>> equality_filter_;
+
+  // When creating table iterator, we will record the number of tuples of every page that we should scan.
   // Otherwise we will have dead loops when updating while scanning. (In project 4, update should be implemented as
-  // deletion + insertion.)
-  RID stop_at_rid_;
+  // deletion + insertion.) Inserts go to any page with room, so a bound on the last page alone is not enough.
+  std::vector<uint16_t> stop_at_num_tuples_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_file_manager.h
+//
+// Identification: src/include/storage/table/tmp_file_manager.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/page/page_guard.h"
+#include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tmp_tuple.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * TmpTupleFile is an append-only run of TmpTuplePages that an operator spills intermediate tuples to. The pages go
+ * through the buffer pool and are only pinned while a tuple is appended or read, so a run larger than the pool is
+ * written out to disk by eviction and read back when asked for. A file is used by one operator at a time, and
+ * frees its pages when destroyed.
+ */
+class TmpTupleFile {
+ public:
+  explicit TmpTupleFile(BufferPoolManager *bpm) : bpm_(bpm) {}
+
+  ~TmpTupleFile();
+
+  DISALLOW_COPY_AND_MOVE(TmpTupleFile);
+
+  /**
+   * Append a tuple to the last page, or to a new one if it has no room. Throws if the tuple does not fit in an
+   * empty page.
+   * @return where the tuple is
+   */
+  auto Append(const Tuple &tuple) -> TmpTuple;
+
+  /** @return a copy of a tuple of this file */
+  auto GetTuple(const TmpTuple &tmp_tuple) const -> Tuple;
+
+  /**
+   * Look at a tuple of this file in place.
+   * @param[out] guard holds the page of the tuple while the view is used
+   */
+  auto GetTupleView(const TmpTuple &tmp_tuple, const Schema *schema, ReadPageGuard *guard) const -> TupleView;
+
+  /**
+   * Copy out the tuples of a page.
+   * @param page_index the position of the page in the file
+   * @param[out] tuples the tuples are appended to it, in the order they were appended to the file
+   */
+  void ReadPage(size_t page_index, std::vector<Tuple> *tuples) const;
+
+  /** @return the number of pages of this file */
+  auto GetNumPages() const -> size_t { return page_ids_.size(); }
+
+  /** @return the number of tuples appended to this file */
+  auto GetNumTuples() const -> size_t { return num_tuples_; }
+
+ private:
+  BufferPoolManager *bpm_;
+  /** The pages of the file, in the order they were appended */
+  std::vector<page_id_t> page_ids_;
+  size_t num_tuples_{0};
+};
+
+/**
+ * TmpFileManager hands out the TmpTupleFiles of a query, so that sorts, joins and aggregations can keep state
+ * larger than memory. Every ExecutorContext has one, the files and their pages are freed when the query ends, or
+ * earlier by DropFile.
+ */
+class TmpFileManager {
+ public:
+  explicit TmpFileManager(BufferPoolManager *bpm) : bpm_(bpm) {}
+
+  DISALLOW_COPY_AND_MOVE(TmpFileManager);
+
+  /** @return a new empty file, valid until it is dropped or the manager is destroyed */
+  auto CreateFile() -> TmpTupleFile *;
+
+  /** Free a file and its pages before the query ends. */
+  void DropFile(TmpTupleFile *file);
+
+  /** @return the number of pages of the files of the query */
+  auto GetNumPages() -> size_t;
+
+ private:
+  BufferPoolManager *bpm_;
+  std::mutex latch_;
+  std::vector<std::unique_ptr<TmpTupleFile>> files_;
+};
+
+}  // namespace bustub
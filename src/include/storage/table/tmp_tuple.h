@@ -4,8 +4,10 @@
 
 namespace bustub {
 
-// Document this class! What does it represent?
-
+/**
+ * TmpTuple refers to a tuple in a TmpTuplePage: the page and the offset of the size of the tuple in it. It is all
+ * an operator keeps of a tuple it spilled, the tuple is read back from the page, copied or in place.
+ */
 class TmpTuple {
  public:
   TmpTuple(page_id_t page_id, size_t offset) : page_id_(page_id), offset_(offset) {}
@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// toast_store.h
+//
+// Identification: src/include/storage/table/toast_store.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "storage/page/overflow_page.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/** A tuple that takes more than this many bytes has its largest varchars moved out to overflow pages */
+static constexpr uint32_t TOAST_TUPLE_THRESHOLD = BUSTUB_PAGE_SIZE / 4;
+
+/**
+ * ToastStore keeps the varchars of a table that are too large to be kept in their tuples in chains of
+ * OverflowPages. The tuple in the table page holds the length of the value, with TOAST_FLAG set, and the id of the
+ * first page, so the rows of the table stay narrow and a scan only reads the overflow pages of the values it looks
+ * at.
+ */
+class ToastStore {
+ public:
+  explicit ToastStore(BufferPoolManager *bpm) : bpm_(bpm) {}
+
+  /**
+   * Move the largest varchars of a tuple out to overflow pages until it takes at most TOAST_TUPLE_THRESHOLD bytes,
+   * or no varchar is left to move.
+   * @return the tuple to store in the table page
+   */
+  auto Toast(const Tuple &tuple, const Schema &schema) -> Tuple;
+
+  /** @return the tuple with every varchar in overflow pages read back into it */
+  auto Detoast(const Tuple &tuple, const Schema &schema) const -> Tuple;
+
+  /** @return the value of a varchar, length first, read from its overflow pages if it is in them */
+  auto ReadVarchar(const char *varchar) const -> Value;
+
+  /** Free a chain of overflow pages, given the id of its first page. */
+  void Free(page_id_t page_id);
+
+  /** @return whether a varchar of the tuple data is in overflow pages */
+  static auto IsToasted(const char *data, const Schema &schema) -> bool;
+
+  /** @return the ids of the first overflow pages of the varchars of the tuple data */
+  static auto GetToastPageIds(const char *data, const Schema &schema) -> std::vector<page_id_t>;
+
+ private:
+  /** @return the id of the first page of a new chain holding size bytes of data */
+  auto Store(const char *data, uint32_t size) -> page_id_t;
+
+  /** Read size bytes of the chain starting at page_id into out. */
+  void Load(page_id_t page_id, uint32_t size, char *out) const;
+
+  BufferPoolManager *bpm_;
+};
+
+}  // namespace bustub
@@ -21,6 +21,8 @@
 
 namespace bustub {
 
+class ToastStore;
+
 static constexpr size_t TUPLE_META_SIZE = 12;
 
 struct TupleMeta {
@@ -38,6 +40,9 @@ struct TupleMeta {
    * @brief marks whether this tuple is marked removed from table heap.
    */
   bool is_deleted_;
+
+  /** @return whether the tuple is deleted by a transaction that committed, only then may vacuum drop its data */
+  auto IsDeleteCommitted() const -> bool { return is_deleted_ && delete_txn_id_ == INVALID_TXN_ID; }
 };
 
 static_assert(sizeof(TupleMeta) == TUPLE_META_SIZE);
@@ -50,8 +55,11 @@ static_assert(sizeof(TupleMeta) == TUPLE_META_SIZE);
  */
 class Tuple {
   friend class TablePage;
+  friend class PaxPage;
   friend class TableHeap;
   friend class TableIterator;
+  friend class ToastStore;
+  friend class TupleView;
 
  public:
   // Default constructor (to create a dummy tuple)
@@ -108,8 +116,50 @@ class Tuple {
   // Get the starting storage address of specific column
   auto GetDataPtr(const Schema *schema, uint32_t column_idx) const -> const char *;
 
+  // Get the starting storage address of specific column in the tuple data at data
+  static auto GetDataPtr(const char *data, const Schema *schema, uint32_t column_idx) -> const char *;
+
   RID rid_{};  // if pointing to the table heap, the rid is valid
   std::vector<char> data_;
 };
 
+/**
+ * TupleView refers to the data of a tuple where it lies, in the frame of a pinned page, instead of copying it out
+ * like Tuple. It is only valid while the guard of that page is held, so values are read and predicates evaluated
+ * in place, and only the tuples to keep are copied with ToTuple. A view given the ToastStore of its table reads
+ * the varchars that are in overflow pages from there, only when they are asked for.
+ */
+class TupleView {
+ public:
+  TupleView(const char *data, uint32_t length, const Schema *schema, RID rid)
+      : data_(data), length_(length), schema_(schema), rid_(rid) {}
+
+  // return RID of the tuple
+  inline auto GetRid() const -> RID { return rid_; }
+
+  // Get the address of the tuple data in the page
+  inline auto GetData() const -> const char * { return data_; }
+
+  // Get length of the tuple, including varchar length
+  inline auto GetLength() const -> uint32_t { return length_; }
+
+  inline auto GetSchema() const -> const Schema * { return schema_; }
+
+  // Read the varchars that are in overflow pages from the store
+  inline void SetToastStore(const ToastStore *toast) { toast_ = toast; }
+
+  // Get the value of a specified column
+  auto GetValue(uint32_t column_idx) const -> Value;
+
+  // Copy the tuple out of the page
+  auto ToTuple() const -> Tuple;
+
+ private:
+  const char *data_;
+  uint32_t length_;
+  const Schema *schema_;
+  RID rid_;
+  const ToastStore *toast_{nullptr};
+};
+
 }  // namespace bustub
@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.h
+//
+// Identification: src/include/storage/table/tuple_batch.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/** The number of rows an executor hands out per NextBatch, a scan fills a batch a page at a time past it */
+static constexpr size_t BATCH_SIZE = 1024;
+
+/**
+ * TupleBatch holds rows for NextBatch column by column: a vector of the values of every column, the rids of the
+ * rows, and a selection vector of the positions of the rows that are in the batch. A filter only narrows the
+ * selection and leaves the vectors as they are, so expressions are evaluated once per batch on the selected rows,
+ * rather than once per tuple.
+ */
+class TupleBatch {
+ public:
+  /** Empty the batch, for rows of num_columns columns. */
+  void Reset(size_t num_columns);
+
+  /** @return the number of columns */
+  auto GetNumColumns() const -> size_t { return columns_.size(); }
+
+  /** @return the number of rows in the vectors, selected or not */
+  auto GetNumRows() const -> size_t { return rids_.size(); }
+
+  /** @return the number of rows selected */
+  auto GetSize() const -> size_t { return selection_.size(); }
+
+  /** Append a tuple of the schema, its values go to the vectors of the columns, and select it. */
+  void AppendTuple(const Tuple &tuple, const Schema &schema, RID rid);
+
+  /** @return the vectors of the columns, to fill directly, SelectAll selects what was appended */
+  auto GetColumns() -> std::vector<std::vector<Value>> * { return &columns_; }
+
+  /** @return the rids of the rows, to fill with the columns */
+  auto GetRids() -> std::vector<RID> * { return &rids_; }
+
+  /** Select every row in the vectors. */
+  void SelectAll();
+
+  /**
+   * Narrow the selection to the rows a predicate is true for.
+   * @param matches the value of the predicate for every row selected, in the order of the selection
+   */
+  void Select(const std::vector<Value> &matches);
+
+  /** @return the positions of the rows selected */
+  auto GetSelection() const -> const std::vector<uint32_t> & { return selection_; }
+
+  /** @return the value of a column of the i-th row selected */
+  auto GetValue(size_t column_idx, size_t i) const -> const Value & { return columns_[column_idx][selection_[i]]; }
+
+  /** @return the rid of the i-th row selected */
+  auto GetRid(size_t i) const -> RID { return rids_[selection_[i]]; }
+
+  /** @return the i-th row selected as a tuple of the schema */
+  auto GetTuple(size_t i, const Schema &schema) const -> Tuple;
+
+ private:
+  std::vector<std::vector<Value>> columns_;
+  std::vector<RID> rids_;
+  std::vector<uint32_t> selection_;
+};
+
+}  // namespace bustub
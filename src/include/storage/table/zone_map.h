@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map.h
+//
+// Identification: src/include/storage/table/zone_map.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/** The smallest and largest value that is not null, and the number of nulls, of a column over a page */
+struct ColumnZone {
+  /** Whether the column is summarized at all, varchars are not */
+  bool tracked_{false};
+  /** Unset while the page has no value of the column that is not null */
+  std::optional<Value> min_;
+  std::optional<Value> max_;
+  uint32_t null_count_{0};
+};
+
+/**
+ * PageZone summarizes the values of the fixed-size columns of every tuple that was put in a page, so that a scan
+ * can tell a page holds no tuple a predicate accepts without reading it.
+ *
+ * Tuples are only ever added: a deleted tuple, or the old version of an updated one, stays in the summary. A
+ * summary may therefore cover more than the page holds, never less.
+ */
+class PageZone {
+ public:
+  PageZone() = default;
+
+  /** An empty summary of a page of a table with the schema. */
+  explicit PageZone(const Schema &schema);
+
+  /** Take a tuple into the summary. */
+  void Add(const Schema &schema, const Tuple &tuple);
+
+  /** Take everything another summary of the same schema covers into this one. */
+  void Merge(const PageZone &other);
+
+  /** @return the summary of a column */
+  auto GetColumn(uint32_t column_idx) const -> const ColumnZone & { return columns_[column_idx]; }
+
+ private:
+  void AddValue(uint32_t column_idx, const Value &value);
+
+  std::vector<ColumnZone> columns_;
+};
+
+}  // namespace bustub
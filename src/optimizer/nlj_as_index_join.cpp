@@ -24,12 +24,20 @@ namespace bustub {
 auto Optimizer::MatchIndex(const std::string &table_name, uint32_t index_key_idx)
     -> std::optional<std::tuple<index_oid_t, std::string>> {
   const auto key_attrs = std::vector{index_key_idx};
+  // every index kind answers point lookups, a hash index in O(1) page accesses and a tree in O(log n),
+  // so a hash index on the column wins over a tree on it
+  const IndexInfo *match = nullptr;
   for (const auto *index_info : catalog_.GetTableIndexes(table_name)) {
     if (key_attrs == index_info->index_->GetKeyAttrs()) {
-      return std::make_optional(std::make_tuple(index_info->index_oid_, index_info->name_));
+      if (match == nullptr || (!IsHashIndex(match->index_type_) && IsHashIndex(index_info->index_type_))) {
+        match = index_info;
+      }
     }
   }
-  return std::nullopt;
+  if (match == nullptr) {
+    return std::nullopt;
+  }
+  return std::make_optional(std::make_tuple(match->index_oid_, match->name_));
 }
 
 auto Optimizer::OptimizeNLJAsIndexJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
@@ -58,7 +66,8 @@ auto Optimizer::OptimizeNLJAsIndexJoin(const AbstractPlanNodeRef &plan) -> Abstr
             // Now it's in form of <column_expr> = <column_expr>. Let's match an index for them.
 
             // Ensure right child is table scan
-            if (nlj_plan.GetRightPlan()->GetType() == PlanType::SeqScan) {
+            if (nlj_plan.GetRightPlan()->GetType() == PlanType::SeqScan &&
+                dynamic_cast<const SeqScanPlanNode &>(*nlj_plan.GetRightPlan()).filter_predicate_ == nullptr) {
               const auto &right_seq_scan = dynamic_cast<const SeqScanPlanNode &>(*nlj_plan.GetRightPlan());
               if (left_expr->GetTupleIdx() == 0 && right_expr->GetTupleIdx() == 1) {
                 if (auto index = MatchIndex(right_seq_scan.table_name_, right_expr->GetColIdx());
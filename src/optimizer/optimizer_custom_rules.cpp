@@ -11,7 +11,11 @@ auto Optimizer::OptimizeCustom(const AbstractPlanNodeRef &plan) -> AbstractPlanN
   auto p = plan;
   p = OptimizeMergeProjection(p);
   p = OptimizeMergeFilterNLJ(p);
+  p = OptimizeNLJAsIndexJoin(p);
   p = OptimizeNLJAsHashJoin(p);
+  p = OptimizeSeqScanAsIndexScan(p);
+  // after the join rules, which only take scans without a filter, filters left are evaluated in place in the scan
+  p = OptimizeMergeFilterScan(p);
   p = OptimizeOrderByAsIndexScan(p);
   p = OptimizeSortLimitAsTopN(p);
   return p;
@@ -32,10 +32,12 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
     const auto &sort_plan = dynamic_cast<const SortPlanNode &>(*optimized_plan);
     const auto &order_bys = sort_plan.GetOrderBy();
 
+    // the index is walked backwards when every column is sorted descending
+    const bool reverse = !order_bys.empty() && order_bys[0].first == OrderByType::DESC;
     std::vector<uint32_t> order_by_column_ids;
     for (const auto &[order_type, expr] : order_bys) {
-      // Order type is asc or default
-      if (!(order_type == OrderByType::ASC || order_type == OrderByType::DEFAULT)) {
+      // Order type is the same on every column, desc or else asc or default
+      if ((order_type == OrderByType::DESC) != reverse || order_type == OrderByType::INVALID) {
         return optimized_plan;
       }
 
@@ -58,6 +60,10 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
       const auto indices = catalog_.GetTableIndexes(table_info->name_);
 
       for (const auto *index : indices) {
+        // only a B+ tree hands out its entries in key order
+        if (index->index_type_ != IndexType::BPlusTreeIndex) {
+          continue;
+        }
         const auto &columns = index->key_schema_.GetColumns();
         // check index key schema == order by columns
         bool valid = true;
@@ -69,7 +75,8 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
             }
           }
           if (valid) {
-            return std::make_shared<IndexScanPlanNode>(optimized_plan->output_schema_, index->index_oid_);
+            return std::make_shared<IndexScanPlanNode>(optimized_plan->output_schema_, index->index_oid_,
+                                                       seq_scan.filter_predicate_, nullptr, reverse);
           }
         }
       }
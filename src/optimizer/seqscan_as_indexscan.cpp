@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+/** Collects the terms of a conjunction, a predicate that is no conjunction is its only term. */
+void CollectConjuncts(const AbstractExpressionRef &expr, std::vector<AbstractExpressionRef> *conjuncts) {
+  if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(expr.get());
+      logic_expr != nullptr && logic_expr->logic_type_ == LogicType::And) {
+    CollectConjuncts(logic_expr->GetChildAt(0), conjuncts);
+    CollectConjuncts(logic_expr->GetChildAt(1), conjuncts);
+    return;
+  }
+  conjuncts->push_back(expr);
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeSeqScanAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeSeqScanAsIndexScan(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  // the predicate sits either in a filter right above the scan, or already in the scan itself
+  const SeqScanPlanNode *seq_scan = nullptr;
+  AbstractExpressionRef predicate;
+  if (optimized_plan->GetType() == PlanType::Filter) {
+    const auto &filter_plan = dynamic_cast<const FilterPlanNode &>(*optimized_plan);
+    BUSTUB_ASSERT(optimized_plan->children_.size() == 1, "must have exactly one children");
+    if (filter_plan.GetChildPlan()->GetType() == PlanType::SeqScan) {
+      seq_scan = dynamic_cast<const SeqScanPlanNode *>(filter_plan.GetChildPlan().get());
+      if (seq_scan->filter_predicate_ == nullptr) {
+        predicate = filter_plan.GetPredicate();
+      }
+    }
+  } else if (optimized_plan->GetType() == PlanType::SeqScan) {
+    seq_scan = dynamic_cast<const SeqScanPlanNode *>(optimized_plan.get());
+    predicate = seq_scan->filter_predicate_;
+  }
+  if (predicate == nullptr) {
+    return optimized_plan;
+  }
+
+  // any term of the form `column = constant` can drive the scan, the whole predicate is checked on what it finds
+  const auto &table_schema = catalog_.GetTable(seq_scan->GetTableOid())->schema_;
+  std::vector<AbstractExpressionRef> conjuncts;
+  CollectConjuncts(predicate, &conjuncts);
+  const auto indexes = catalog_.GetTableIndexes(seq_scan->table_name_);
+  std::optional<index_oid_t> best_index;
+  bool best_is_hash = false;
+  AbstractExpressionRef best_key;
+  for (const auto &conjunct : conjuncts) {
+    const auto *expr = dynamic_cast<const ComparisonExpression *>(conjunct.get());
+    if (expr == nullptr || expr->comp_type_ != ComparisonType::Equal) {
+      continue;
+    }
+    auto column = expr->GetChildAt(0);
+    auto constant = expr->GetChildAt(1);
+    if (dynamic_cast<const ColumnValueExpression *>(column.get()) == nullptr) {
+      std::swap(column, constant);
+    }
+    const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(column.get());
+    const auto *constant_expr = dynamic_cast<const ConstantValueExpression *>(constant.get());
+    if (column_expr == nullptr || constant_expr == nullptr || constant_expr->val_.IsNull() ||
+        constant_expr->GetReturnType() != table_schema.GetColumn(column_expr->GetColIdx()).GetType()) {
+      continue;
+    }
+    auto index = MatchIndex(seq_scan->table_name_, column_expr->GetColIdx());
+    if (index == std::nullopt) {
+      continue;
+    }
+    // a hash index beats a tree on another term
+    auto index_oid = std::get<0>(*index);
+    bool is_hash = std::any_of(indexes.begin(), indexes.end(), [&](const IndexInfo *index_info) {
+      return index_info->index_oid_ == index_oid && IsHashIndex(index_info->index_type_);
+    });
+    if (best_index == std::nullopt || (is_hash && !best_is_hash)) {
+      best_index = index_oid;
+      best_is_hash = is_hash;
+      best_key = constant;
+    }
+  }
+  if (best_index == std::nullopt) {
+    return optimized_plan;
+  }
+  return std::make_shared<IndexScanPlanNode>(optimized_plan->output_schema_, *best_index, predicate, best_key);
+}
+
+}  // namespace bustub
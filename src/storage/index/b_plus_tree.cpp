@@ -1,5 +1,8 @@
+#include <limits>
+#include <numeric>
 #include <sstream>
 #include <string>
+#include <tuple>
 
 #include "common/exception.h"
 #include "common/logger.h"
@@ -10,69 +13,206 @@ namespace bustub {
 
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_TYPE::BPlusTree(std::string name, page_id_t header_page_id, BufferPoolManager *buffer_pool_manager,
-                          const KeyComparator &comparator, int leaf_max_size, int internal_max_size)
+                          const KeyComparator &comparator, int leaf_max_size, int internal_max_size, bool unique)
     : index_name_(std::move(name)),
       bpm_(buffer_pool_manager),
       comparator_(std::move(comparator)),
       leaf_max_size_(leaf_max_size),
       internal_max_size_(internal_max_size),
-      header_page_id_(header_page_id) {
+      header_page_id_(header_page_id),
+      unique_(unique) {
   WritePageGuard guard = bpm_->FetchPageWrite(header_page_id_);
   auto root_page = guard.AsMut<BPlusTreeHeaderPage>();
   root_page->root_page_id_ = INVALID_PAGE_ID;
+  root_page_id_.store(INVALID_PAGE_ID);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TYPE::~BPlusTree() { StopCompaction(); }
+
 /*
  * Helper function to decide whether current b+tree is empty
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::IsEmpty() const -> bool {
-  // Check whether the root page is empty
-  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
-  auto root_page = guard.As<BPlusTreeHeaderPage>();
-  return root_page->root_page_id_ == INVALID_PAGE_ID;
+  return root_page_id_.load() == INVALID_PAGE_ID;
 }
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 /*
- * Return the only value that associated with input key
- * This method is used for point query
- * @return : true means key exists
+ * Read latch the root page. The cached root page id is used without touching
+ * the header page, and is known to be right if the root version did not change
+ * until the root was latched. While the root is being replaced (odd version),
+ * or if the caller asks for the header latch and the root is a leaf, the
+ * header page is latched instead and kept in `header_guard`.
+ * @return : false means the tree is empty
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn) -> bool {
-  // Declaration of context instance.
-  // Context ctx;
-  // (void)ctx;
-  if (IsEmpty()) {
+auto BPLUSTREE_TYPE::LatchRoot(ReadPageGuard *root_guard, ReadPageGuard *header_guard) -> bool {
+  uint64_t version = root_version_.load();
+  if (version % 2 == 0) {
+    page_id_t page_id = root_page_id_.load();
+    if (page_id == INVALID_PAGE_ID) {
+      return false;
+    }
+    *root_guard = bpm_->FetchPageRead(page_id);
+    if (root_version_.load() == version &&
+        (header_guard == nullptr || !root_guard->As<BPlusTreePage>()->IsLeafPage())) {
+      return true;
+    }
+    root_guard->Drop();
+  }
+
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  page_id_t page_id = guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (page_id == INVALID_PAGE_ID) {
     return false;
   }
-  // Get the root
-  std::optional<ReadPageGuard> root_guard = bpm_->FetchPageRead(header_page_id_);
-  auto root_page = root_guard->As<BPlusTreeHeaderPage>();
-  int root_page_id = root_page->root_page_id_;
+  *root_guard = bpm_->FetchPageRead(page_id);
+  if (header_guard != nullptr) {
+    *header_guard = std::move(guard);
+  }
+  return true;
+}
 
-  ReadPageGuard node_guard = bpm_->FetchPageRead(root_page_id);
-  root_guard = std::nullopt;  // release head
+/*
+ * Point the header page and the cached root page id at a new root. The caller
+ * holds the header write latch, and has called BeginRootChange while it still
+ * held the latch of the old root, so that no reader can take the old root for
+ * the current one.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::SetRoot(BPlusTreeHeaderPage *header, page_id_t root_page_id) {
+  header->root_page_id_ = root_page_id;
+  root_page_id_.store(root_page_id);
+  root_version_.fetch_add(1);
+}
 
-  auto node = node_guard.As<BPlusTreePage>();
-  while (!node->IsLeafPage()) {
-    auto inner_node = node_guard.As<InternalPage>();
-    int next_id = inner_node->KeyIndex(key, comparator_);
-    page_id_t next_page_id = inner_node->ValueAt(next_id);
-    node_guard = bpm_->FetchPageRead(next_page_id);
-    node = node_guard.As<BPlusTreePage>();
+/*
+ * Descend to the leaf that covers (key, rid) with read latch crabbing. The parent
+ * of the leaf (the header page if the root is a leaf) is still latched on return,
+ * which keeps the leaf from being split until the parent guard is dropped.
+ * The separator that bounds the leaf from above is stored in `fence`, or
+ * std::nullopt for the rightmost leaf.
+ * @return : false means the tree is empty
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeaf(const KeyType &key, const RID &rid, ReadPageGuard *parent_guard,
+                              ReadPageGuard *leaf_guard, std::optional<std::pair<KeyType, RID>> *fence) -> bool {
+  if (!LatchRoot(leaf_guard, parent_guard)) {
+    return false;
+  }
+
+  fence->reset();
+  page_id_t page_id;
+  while (!leaf_guard->As<BPlusTreePage>()->IsLeafPage()) {
+    auto inner_node = leaf_guard->As<InternalPage>();
+    int next_id = inner_node->KeyIndex(key, rid, comparator_);
+    if (next_id + 1 < inner_node->GetSize()) {
+      fence->emplace(inner_node->KeyAt(next_id + 1), inner_node->RidAt(next_id + 1));
+    }
+    page_id = inner_node->ValueAt(next_id);
+    *parent_guard = std::move(*leaf_guard);
+    *leaf_guard = bpm_->FetchPageRead(page_id);
   }
+  return true;
+}
 
-  auto leaf = node_guard.As<LeafPage>();
-  ValueType tmp_result;
-  if (leaf->GetValue(key, &tmp_result, comparator_)) {
-    result->push_back(tmp_result);
+/*
+ * Whether (key, rid) sorts before the upper fence of a leaf
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BelowFence(const KeyType &key, const RID &rid,
+                                const std::optional<std::pair<KeyType, RID>> &fence) const -> bool {
+  if (!fence.has_value()) {
     return true;
   }
+  int result = comparator_(key, fence->first);
+  return result < 0 || (result == 0 && CompareRid(rid, fence->second) < 0);
+}
+
+/*
+ * Append the values of key found from the leaf on, following a run of equal
+ * keys into the next leaves of a non-unique tree.
+ * @return : true means the guard was moved on to another leaf
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::CollectValues(ReadPageGuard *leaf_guard, const KeyType &key, std::vector<ValueType> *result)
+    -> bool {
+  bool moved = false;
+  auto leaf = leaf_guard->As<LeafPage>();
+  int id = leaf->IndexAt(key, comparator_);
+  while (true) {
+    for (; id < leaf->GetSize() && comparator_(leaf->KeyAt(id), key) == 0; ++id) {
+      result->push_back(leaf->ValueAt(id));
+    }
+    // a run of equal keys continues in the next leaf only if it reaches the end of this one
+    if (unique_ || id < leaf->GetSize() || leaf->GetNextPageId() == INVALID_PAGE_ID) {
+      return moved;
+    }
+    *leaf_guard = bpm_->FetchPageRead(leaf->GetNextPageId());
+    leaf = leaf_guard->As<LeafPage>();
+    id = 0;
+    moved = true;
+  }
+}
 
-  return false;
+/*
+ * Return the values that associated with input key
+ * This method is used for point query
+ * @return : true means key exists
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn) -> bool {
+  ReadPageGuard parent_guard;
+  ReadPageGuard leaf_guard;
+  std::optional<std::pair<KeyType, RID>> fence;
+  if (!FindLeaf(key, SearchRid(), &parent_guard, &leaf_guard, &fence)) {
+    return false;
+  }
+  parent_guard.Drop();
+
+  size_t found = result->size();
+  CollectValues(&leaf_guard, key, result);
+  return result->size() > found;
+}
+
+/*
+ * Batched point query. Keys are looked up in sorted order, and a key that
+ * falls below the upper fence of the previous key's leaf is served from that
+ * leaf without descending from the root again.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *result,
+                               Transaction *txn) {
+  result->assign(keys.size(), {});
+  std::vector<size_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](size_t lhs, size_t rhs) { return comparator_(keys[lhs], keys[rhs]) < 0; });
+
+  RID search_rid = SearchRid();
+  ReadPageGuard parent_guard;
+  ReadPageGuard leaf_guard;
+  std::optional<std::pair<KeyType, RID>> fence;
+  bool cached = false;
+  for (size_t id : order) {
+    if (!cached || !BelowFence(keys[id], search_rid, fence)) {
+      // writers latch from the root down, so no latch may be held while the root is latched again
+      leaf_guard.Drop();
+      parent_guard.Drop();
+      if (!FindLeaf(keys[id], search_rid, &parent_guard, &leaf_guard, &fence)) {
+        return;
+      }
+      parent_guard.Drop();
+      cached = true;
+    }
+    // the fence is only known for the leaf reached from the root
+    if (CollectValues(&leaf_guard, keys[id], &(*result)[id])) {
+      cached = false;
+    }
+  }
 }
 
 /*****************************************************************************
@@ -82,18 +222,17 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  * Insert constant key & value pair into b+ tree
  * if current tree is empty, start new tree, update root page id and insert
  * entry, otherwise insert into leaf page.
- * @return: since we only support unique key, if user try to insert duplicate
- * keys return false, otherwise return true.
+ * @return: if user try to insert a duplicate key (or, for a non-unique tree, a
+ * duplicate key & value pair) return false, otherwise return true.
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *txn) -> bool {
   // Declaration of context instance.
-//  Context ctx;
-//  (void)ctx;
-//  return false;
-  if (IsEmpty()) {
-    WritePageGuard header_guard = bpm_->FetchPageWrite(header_page_id_);
+  Context ctx;
+  ctx.header_page_.emplace(bpm_->FetchPageWrite(header_page_id_));
 
+  // the header is latched once, and the empty check is made under that latch
+  if (ctx.header_page_->As<BPlusTreeHeaderPage>()->root_page_id_ == INVALID_PAGE_ID) {
     page_id_t root_page_id;
 
     auto new_root_page = reinterpret_cast<LeafPage *>(bpm_->NewPage(&root_page_id)->GetData());
@@ -104,20 +243,16 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
     new_root_page->Init(leaf_max_size_);
     //    new_root_page->InsertValue(key, value, comparator_);
     new_root_page->InsertAtBack(key, value);
-    auto header = header_guard.AsMut<BPlusTreeHeaderPage>();
-    header->root_page_id_ = root_page_id;
+    bpm_->UnpinPage(root_page_id, true);
+    BeginRootChange();
+    SetRoot(ctx.header_page_->AsMut<BPlusTreeHeaderPage>(), root_page_id);
     return true;
   }
 
-  // Declaration of context instance.
-  Context ctx;
-  //  (void)ctx;
-  WritePageGuard guard = bpm_->FetchPageWrite(header_page_id_);
-  ctx.header_page_.emplace(std::move(guard));
-
   page_id_t root_page_id;
 
   std::vector<int> inner_ids;
+  RID rid = SeparatorRid(value);
   auto header = ctx.header_page_->As<BPlusTreeHeaderPage>();
   root_page_id = header->root_page_id_;
 
@@ -125,36 +260,51 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
   auto cur_page = ctx.write_set_.back().As<BPlusTreePage>();
   while (!cur_page->IsLeafPage()) {
     auto inner_page = ctx.write_set_.back().As<InternalPage>();
-    int next_id = inner_page->KeyIndex(key, comparator_);
+    int next_id = inner_page->KeyIndex(key, rid, comparator_);
     inner_ids.push_back(next_id);
     int next_page_id = inner_page->ValueAt(next_id);
-    guard = bpm_->FetchPageWrite(next_page_id);
+    WritePageGuard guard = bpm_->FetchPageWrite(next_page_id);
     cur_page = guard.As<BPlusTreePage>();
     ctx.write_set_.emplace_back(std::move(guard));
   }
 
   auto detect_page = ctx.write_set_.back().As<LeafPage>();
-  ValueType dummy_value;
-  if (detect_page->GetValue(key, &dummy_value, comparator_)) {
+  int insert_id = unique_ ? detect_page->IndexAt(key, comparator_) : detect_page->IndexAt(key, value, comparator_);
+  if (insert_id < detect_page->GetSize() && comparator_(detect_page->KeyAt(insert_id), key) == 0 &&
+      (unique_ || detect_page->ValueAt(insert_id) == value)) {
     return false;  // The key already exist
   }
 
-  // count which pages need modification
+  // count which pages need modification. Whether a page splits depends on how well the key
+  // being pushed into it compresses, so follow the keys that the splits below would lift.
   int modification_count = 1;
   // whether leaf page need split
-  bool need_split = cur_page->GetSize() + 1 == cur_page->GetMaxSize();
+  bool need_split = !detect_page->CanInsert(key);
+  KeyType lifted_key = key;
+  RID lifted_rid = rid;
+  if (need_split) {
+    auto lifted = detect_page->SplitKey(insert_id, key, value);
+    lifted_key = lifted.first;
+    lifted_rid = SeparatorRid(lifted.second);
+  }
 
   // internal pages
   for (int i = ctx.write_set_.size() - 2; i >= 0 && need_split; --i) {
     ++modification_count;
-    auto page = ctx.write_set_[i].As<BPlusTreePage>();
-    need_split = page->GetSize() == page->GetMaxSize();
+    auto page = ctx.write_set_[i].As<InternalPage>();
+    need_split = !page->CanInsert(lifted_key, lifted_rid);
+    if (need_split) {
+      std::tie(lifted_key, lifted_rid) = page->SplitKey(lifted_key, lifted_rid, comparator_);
+    }
   }
 
   bool root_change_flag = need_split && (modification_count == static_cast<int>(ctx.write_set_.size()));
 
   if (!root_change_flag) {
     ctx.header_page_ = std::nullopt;
+  } else {
+    // the old root is still latched, readers that reach it from here on retry
+    BeginRootChange();
   }
 
   int release_count = ctx.write_set_.size() - modification_count;
@@ -165,12 +315,10 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
 
   // handle leaf page
   auto leaf_page = ctx.write_set_.back().AsMut<LeafPage>();
-  leaf_page->InsertValue(key, value, comparator_);
   KeyType next_insert_key;
+  RID next_insert_rid;
   page_id_t next_insert_value;
-  if (leaf_page->GetSize() == leaf_page->GetMaxSize()) {
-    int max_size = leaf_page->GetMaxSize();
-    int split_id = max_size / 2;
+  if (!leaf_page->CanInsert(key)) {
     page_id_t new_page_id = INVALID_PAGE_ID;
     auto new_leaf_page = reinterpret_cast<LeafPage *>(bpm_->NewPage(&new_page_id)->GetData());
 
@@ -179,14 +327,21 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
 
     new_leaf_page->Init(leaf_max_size_);
     new_leaf_page->SetNextPageId(leaf_page->GetNextPageId());
-    leaf_page->SetNextPageId(new_page_id);
-    for (int i = split_id; i < max_size; ++i) {
-      new_leaf_page->InsertAtBack(leaf_page->KeyAt(i), leaf_page->ValueAt(i));
+    new_leaf_page->SetPrevPageId(ctx.write_set_.back().PageId());
+    leaf_page->InsertAndSplit(insert_id, key, value, new_leaf_page);
+    // link the new leaf only once it is filled, latching the right sibling while holding
+    // this leaf follows the left to right order of scans
+    if (leaf_page->GetNextPageId() != INVALID_PAGE_ID) {
+      WritePageGuard next_guard = bpm_->FetchPageWrite(leaf_page->GetNextPageId());
+      next_guard.AsMut<LeafPage>()->SetPrevPageId(new_page_id);
     }
-    leaf_page->ReduceToHalf();
+    leaf_page->SetNextPageId(new_page_id);
     next_insert_key = new_leaf_page->KeyAt(0);
+    next_insert_rid = SeparatorRid(new_leaf_page->ValueAt(0));
     next_insert_value = new_page_id;
     bpm_->UnpinPage(new_page_id, true);
+  } else {
+    leaf_page->InsertAt(insert_id, key, value);
   }
   ctx.write_set_.pop_back();
 
@@ -194,31 +349,10 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
   while (!ctx.write_set_.empty()) {
     auto inner_page = ctx.write_set_.back().AsMut<InternalPage>();
     KeyType insert_key = next_insert_key;
+    RID insert_rid = next_insert_rid;
     page_id_t insert_value = next_insert_value;
-    // split internal page
-    if (inner_page->GetSize() == inner_page->GetMaxSize()) {
-      int to_insert_id = inner_page->KeyIndex(insert_key, comparator_) + 1;
-      int max_size = inner_page->GetMaxSize();
-      int split_id = (max_size + 1) / 2;  // first id on the higher half
-      bool insert_to_lower = false;       // new pair insert to lower half
-      bool insert_is_lift = true;         // new key are lifted
-
-      int right_first_insert_id = split_id;  // just initialize
-      KeyType lift_key = next_insert_key;    // just initialize
-      auto lift_value = next_insert_value;
-      if (to_insert_id < split_id) {
-        lift_key = inner_page->KeyAt(split_id - 1);
-        lift_value = inner_page->ValueAt(split_id - 1);
-        //        right_first_insert_id == split_id; //useless as already set the same value
-        insert_is_lift = false;
-        insert_to_lower = true;
-      } else if (to_insert_id > split_id) {
-        right_first_insert_id = split_id + 1;
-        lift_key = inner_page->KeyAt(split_id);
-        lift_value = inner_page->ValueAt(split_id);
-        insert_is_lift = false;
-      }
-
+    // split internal page, the first key of the new page is lifted to the parent
+    if (!inner_page->CanInsert(insert_key, insert_rid)) {
       page_id_t new_page_id = INVALID_PAGE_ID;
       auto new_inner_page = reinterpret_cast<InternalPage *>(bpm_->NewPage(&new_page_id)->GetData());
 
@@ -228,25 +362,14 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
       //      LOG_DEBUG("%s", loginfo.c_str());
 
       new_inner_page->Init(internal_max_size_);
-      new_inner_page->SetKeyAt(0, lift_key);  // for remove operation
-      new_inner_page->SetValueAt(0, lift_value);
-      for (int i = right_first_insert_id; i < max_size; ++i) {
-        new_inner_page->InsertAtBack(inner_page->KeyAt(i), inner_page->ValueAt(i));
-      }
-      inner_page->ReduceToHalf(insert_to_lower);
-      if (!insert_is_lift) {
-        if (insert_to_lower) {
-          inner_page->InsertValue(insert_key, insert_value, comparator_);
-        } else {
-          new_inner_page->InsertValue(insert_key, insert_value, comparator_);
-        }
-      }
+      inner_page->InsertAndSplit(insert_key, insert_rid, insert_value, comparator_, new_inner_page);
 
       bpm_->UnpinPage(new_page_id, true);
-      next_insert_key = lift_key;
+      next_insert_key = new_inner_page->KeyAt(0);
+      next_insert_rid = new_inner_page->RidAt(0);
       next_insert_value = new_page_id;
     } else {
-      inner_page->InsertValue(insert_key, insert_value, comparator_);
+      inner_page->InsertValue(insert_key, insert_rid, insert_value, comparator_);
     }
     ctx.write_set_.pop_back();
   }
@@ -262,43 +385,403 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
     new_page->Init(internal_max_size_);
     auto head_page = ctx.header_page_->AsMut<BPlusTreeHeaderPage>();
     page_id_t old_root_page_id = head_page->root_page_id_;
-    head_page->root_page_id_ = new_page_id;
-    new_page->SetValueAt(
-        0, old_root_page_id);  // key head is invalid hear. As it always at leftmost, it doesn't affect merge operation.
-    new_page->InsertAtBack(next_insert_key, next_insert_value);
+    // key head is never looked at, store the separator there so that it shares the page prefix
+    new_page->InsertAtBack(next_insert_key, next_insert_rid, old_root_page_id);
+    new_page->InsertAtBack(next_insert_key, next_insert_rid, next_insert_value);
     bpm_->UnpinPage(new_page_id, true);
+    SetRoot(head_page, new_page_id);
   }
 
   return true;
 }
 
+/*
+ * Insert a batch of key & value pairs. The pairs are sorted, and the leaf
+ * reached for one pair takes all following pairs that sort below its upper
+ * fence and fit without a split. Only the leaf is write latched for that;
+ * a pair that needs a split goes through Insert.
+ * @return: the number of pairs inserted, duplicates are skipped
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::InsertBatch(const std::vector<std::pair<KeyType, ValueType>> &entries, Transaction *txn)
+    -> size_t {
+  std::vector<std::pair<KeyType, ValueType>> sorted(entries);
+  std::stable_sort(sorted.begin(), sorted.end(), [&](const auto &lhs, const auto &rhs) {
+    int result = comparator_(lhs.first, rhs.first);
+    return result < 0 || (result == 0 && !unique_ && CompareRid(lhs.second, rhs.second) < 0);
+  });
+
+  size_t inserted = 0;
+  size_t i = 0;
+  while (i < sorted.size()) {
+    ReadPageGuard parent_guard;
+    ReadPageGuard leaf_read_guard;
+    std::optional<std::pair<KeyType, RID>> fence;
+    if (!FindLeaf(sorted[i].first, SeparatorRid(sorted[i].second), &parent_guard, &leaf_read_guard, &fence)) {
+      parent_guard.Drop();
+      inserted += Insert(sorted[i].first, sorted[i].second, txn) ? 1 : 0;
+      ++i;
+      continue;
+    }
+    // the latched parent keeps the leaf from splitting while its latch is upgraded
+    page_id_t leaf_page_id = leaf_read_guard.PageId();
+    leaf_read_guard.Drop();
+    WritePageGuard leaf_guard = bpm_->FetchPageWrite(leaf_page_id);
+    parent_guard.Drop();
+
+    auto leaf = leaf_guard.AsMut<LeafPage>();
+    bool need_split = false;
+    for (; i < sorted.size(); ++i) {
+      const auto &[key, value] = sorted[i];
+      if (!BelowFence(key, SeparatorRid(value), fence)) {
+        break;
+      }
+      int insert_id = unique_ ? leaf->IndexAt(key, comparator_) : leaf->IndexAt(key, value, comparator_);
+      if (insert_id < leaf->GetSize() && comparator_(leaf->KeyAt(insert_id), key) == 0 &&
+          (unique_ || leaf->ValueAt(insert_id) == value)) {
+        continue;  // The key already exist
+      }
+      if (!leaf->CanInsert(key)) {
+        need_split = true;
+        break;
+      }
+      leaf->InsertAt(insert_id, key, value);
+      ++inserted;
+    }
+    leaf_guard.Drop();
+
+    if (need_split) {
+      inserted += Insert(sorted[i].first, sorted[i].second, txn) ? 1 : 0;
+      ++i;
+    }
+  }
+  return inserted;
+}
+
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
 /*
  * Delete key & value pair associated with input key
  * If current tree is empty, return immediately.
- * If not, User needs to first find the right leaf page as deletion target, then
- * delete entry from leaf page. Remember to deal with redistribute or merge if
- * necessary.
+ * A non-unique tree removes every pair with this key.
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
-  // Declaration of context instance.
-  Context ctx;
-  (void)ctx;
+  if (unique_) {
+    Remove(key, ValueType{}, txn);
+    return;
+  }
+  std::vector<ValueType> values;
+  GetValue(key, &values, txn);
+  for (const auto &value : values) {
+    Remove(key, value, txn);
+  }
+}
+
+/*
+ * Delete a key & value pair. The entry is only taken out of its leaf, which is
+ * write latched while its parent is still read latched, as in InsertBatch. A
+ * leaf may be left underfull or even empty: merging pages is left to Compact,
+ * so a delete never write latches anything above the leaf.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Remove(const KeyType &key, const ValueType &value, Transaction *txn) {
+  ReadPageGuard parent_guard;
+  ReadPageGuard leaf_read_guard;
+  std::optional<std::pair<KeyType, RID>> fence;
+  if (!FindLeaf(key, SeparatorRid(value), &parent_guard, &leaf_read_guard, &fence)) {
+    return;
+  }
+  // the latched parent keeps the leaf from being split or merged while its latch is upgraded
+  page_id_t leaf_page_id = leaf_read_guard.PageId();
+  leaf_read_guard.Drop();
+  WritePageGuard leaf_guard = bpm_->FetchPageWrite(leaf_page_id);
+  parent_guard.Drop();
+
+  auto leaf = leaf_guard.AsMut<LeafPage>();
+  int id = unique_ ? leaf->IndexAt(key, comparator_) : leaf->IndexAt(key, value, comparator_);
+  if (id < leaf->GetSize() && comparator_(leaf->KeyAt(id), key) == 0 && (unique_ || leaf->ValueAt(id) == value)) {
+    leaf->RemoveAt(id);
+    removed_.fetch_add(1);
+  }
+}
+
+/*****************************************************************************
+ * COMPACTION
+ *****************************************************************************/
+/*
+ * Merge pages filled below threshold with a sibling, level by level from the
+ * parents of the leaves up, then lower the tree while its root has a single
+ * child. Each parent is write latched on its own while its children are merged,
+ * reached from the root with read latch crabbing, so the rest of the tree stays
+ * open to lookups, inserts and removes.
+ * @return : the number of pages merged away
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Compact(double threshold) -> size_t {
+  std::scoped_lock lock(compaction_latch_);
+  removed_.store(0);
+  size_t merged = 0;
+  for (int depth = TreeHeight() - 1; depth >= 0; --depth) {
+    std::optional<std::pair<KeyType, RID>> from;
+    while (true) {
+      WritePageGuard node_guard;
+      std::optional<std::pair<KeyType, RID>> fence;
+      if (!LatchNode(depth, from, &node_guard, &fence)) {
+        break;
+      }
+      merged += MergeChildren(node_guard.AsMut<InternalPage>(), threshold);
+      node_guard.Drop();
+      if (!fence.has_value()) {
+        break;
+      }
+      from = fence;
+    }
+  }
+  merged += ShrinkRoot();
+  FreeRetiredPages();
+  return merged;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::StartCompaction(double threshold) {
+  StopCompaction();
+  compaction_threshold_ = threshold;
+  enable_compaction_ = true;
+  compaction_thread_ = new std::thread(&BPLUSTREE_TYPE::RunCompaction, this);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::StopCompaction() {
+  enable_compaction_ = false;
+  if (compaction_thread_ != nullptr) {
+    compaction_thread_->join();
+    delete compaction_thread_;
+    compaction_thread_ = nullptr;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RunCompaction() {
+  while (enable_compaction_) {
+    std::this_thread::sleep_for(btree_compaction_interval);
+    if (removed_.load() > 0) {
+      Compact(compaction_threshold_);
+    }
+  }
+}
+
+/*
+ * @return the number of internal levels, zero for an empty tree or a root leaf
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::TreeHeight() -> int {
+  ReadPageGuard guard;
+  if (!LatchRoot(&guard, nullptr)) {
+    return 0;
+  }
+  int height = 0;
+  while (!guard.As<BPlusTreePage>()->IsLeafPage()) {
+    ReadPageGuard child_guard = bpm_->FetchPageRead(guard.As<InternalPage>()->ValueAt(0));
+    guard = std::move(child_guard);
+    ++height;
+  }
+  return height;
+}
+
+/*
+ * Write latch the internal page at depth (the root being at depth 0) whose
+ * subtree covers `from`, or the leftmost one if from is nullopt. The pages
+ * above it are read latched on the way down. The separator that bounds the
+ * page from above is stored in `fence`, or std::nullopt for the rightmost page.
+ * @return : false means there is no internal page at that depth
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::LatchNode(int depth, const std::optional<std::pair<KeyType, RID>> &from,
+                               WritePageGuard *node_guard, std::optional<std::pair<KeyType, RID>> *fence) -> bool {
+  fence->reset();
+  ReadPageGuard header_guard = bpm_->FetchPageRead(header_page_id_);
+  page_id_t page_id = header_guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  if (depth == 0) {
+    *node_guard = bpm_->FetchPageWrite(page_id);
+    return !node_guard->As<BPlusTreePage>()->IsLeafPage();
+  }
+
+  ReadPageGuard guard = bpm_->FetchPageRead(page_id);
+  header_guard.Drop();
+  for (int level = 1;; ++level) {
+    if (guard.As<BPlusTreePage>()->IsLeafPage()) {
+      return false;
+    }
+    auto inner_node = guard.As<InternalPage>();
+    int next_id = from.has_value() ? inner_node->KeyIndex(from->first, from->second, comparator_) : 0;
+    if (next_id + 1 < inner_node->GetSize()) {
+      fence->emplace(inner_node->KeyAt(next_id + 1), inner_node->RidAt(next_id + 1));
+    }
+    if (level == depth) {
+      *node_guard = bpm_->FetchPageWrite(inner_node->ValueAt(next_id));
+      return !node_guard->As<BPlusTreePage>()->IsLeafPage();
+    }
+    ReadPageGuard child_guard = bpm_->FetchPageRead(inner_node->ValueAt(next_id));
+    guard = std::move(child_guard);
+  }
+}
+
+/*
+ * Walk the children of a write latched internal page left to right, holding
+ * the latches of two neighbours at a time, and merge the right one into the
+ * left one whenever either is filled below threshold and their entries fit
+ * into one page. The merged away pages are retired.
+ * @return : the number of pages merged away
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::MergeChildren(InternalPage *node, double threshold) -> size_t {
+  if (node->GetSize() < 2) {
+    return 0;
+  }
+  size_t merged = 0;
+  WritePageGuard left_guard = bpm_->FetchPageWrite(node->ValueAt(0));
+  int id = 0;
+  while (id + 1 < node->GetSize()) {
+    WritePageGuard right_guard = bpm_->FetchPageWrite(node->ValueAt(id + 1));
+    bool done;
+    if (left_guard.As<BPlusTreePage>()->IsLeafPage()) {
+      auto left = left_guard.As<LeafPage>();
+      auto right = right_guard.As<LeafPage>();
+      done = (left->FillRatio() < threshold || right->FillRatio() < threshold) && MergeLeaves(&left_guard, &right_guard);
+    } else {
+      auto left = left_guard.AsMut<InternalPage>();
+      auto right = right_guard.AsMut<InternalPage>();
+      done = (left->FillRatio() < threshold || right->FillRatio() < threshold) &&
+             left->MergeFrom(right, node->KeyAt(id + 1), node->RidAt(id + 1));
+    }
+    if (!done) {
+      left_guard = std::move(right_guard);
+      ++id;
+      continue;
+    }
+    node->RemoveAt(id + 1);
+    // moved while the merged pages are still latched, see IndexIterator::Advance
+    merge_epoch_.fetch_add(1);
+    retired_pages_.push_back(right_guard.PageId());
+    ++merged;
+  }
+  return merged;
+}
+
+/*
+ * Move the entries of the right leaf into the left one and unlink the right
+ * leaf. The leaf after it is latched to fix its previous link, left to right
+ * like scans do. The emptied leaf links back to the left one, which now holds
+ * its entries.
+ * @return : false if the entries do not fit into the left leaf
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::MergeLeaves(WritePageGuard *left_guard, WritePageGuard *right_guard) -> bool {
+  auto left = left_guard->AsMut<LeafPage>();
+  auto right = right_guard->AsMut<LeafPage>();
+  if (!left->MergeFrom(right)) {
+    return false;
+  }
+  page_id_t next_page_id = right->GetNextPageId();
+  if (next_page_id != INVALID_PAGE_ID) {
+    WritePageGuard next_guard = bpm_->FetchPageWrite(next_page_id);
+    next_guard.AsMut<LeafPage>()->SetPrevPageId(left_guard->PageId());
+  }
+  left->SetNextPageId(next_page_id);
+  right->SetNextPageId(left_guard->PageId());
+  right->SetPrevPageId(left_guard->PageId());
+  return true;
+}
+
+/*
+ * Replace a root that has a single child by that child, and drop a root leaf
+ * that has no entries left.
+ * @return : the number of root pages retired
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::ShrinkRoot() -> size_t {
+  size_t retired = 0;
+  WritePageGuard header_guard = bpm_->FetchPageWrite(header_page_id_);
+  auto header = header_guard.AsMut<BPlusTreeHeaderPage>();
+  while (header->root_page_id_ != INVALID_PAGE_ID) {
+    WritePageGuard root_guard = bpm_->FetchPageWrite(header->root_page_id_);
+    auto root = root_guard.As<BPlusTreePage>();
+    page_id_t new_root_page_id;
+    if (root->IsLeafPage() && root->GetSize() == 0) {
+      new_root_page_id = INVALID_PAGE_ID;
+    } else if (!root->IsLeafPage() && root->GetSize() == 1) {
+      new_root_page_id = root_guard.As<InternalPage>()->ValueAt(0);
+    } else {
+      break;
+    }
+    // the old root is still latched, readers that reach it from here on retry
+    BeginRootChange();
+    SetRoot(header, new_root_page_id);
+    merge_epoch_.fetch_add(1);
+    retired_pages_.push_back(root_guard.PageId());
+    ++retired;
+  }
+  return retired;
+}
+
+/*
+ * Free the retired pages. No page links to them anymore, but a reader that
+ * read a link just before it changed may still have one pinned; such a page
+ * is tried again on the next compaction.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::FreeRetiredPages() {
+  std::vector<page_id_t> pinned;
+  for (page_id_t page_id : retired_pages_) {
+    if (!bpm_->DeletePage(page_id)) {
+      pinned.push_back(page_id);
+    }
+  }
+  retired_pages_ = std::move(pinned);
 }
 
 /*****************************************************************************
  * INDEX ITERATOR
  *****************************************************************************/
+/*
+ * Descend to the leftmost or rightmost leaf with read latch crabbing
+ * @return : false means the tree is empty
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindEdgeLeaf(bool rightmost, ReadPageGuard *leaf_guard) -> bool {
+  if (!LatchRoot(leaf_guard, nullptr)) {
+    return false;
+  }
+  ReadPageGuard guard;
+  page_id_t page_id;
+  while (!leaf_guard->As<BPlusTreePage>()->IsLeafPage()) {
+    auto inner_node = leaf_guard->As<InternalPage>();
+    page_id = inner_node->ValueAt(rightmost ? inner_node->GetSize() - 1 : 0);
+    guard = std::move(*leaf_guard);
+    *leaf_guard = bpm_->FetchPageRead(page_id);
+  }
+  return true;
+}
+
 /*
  * Input parameter is void, find the leftmost leaf page first, then construct
  * index iterator
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
+auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
+  ReadPageGuard leaf_guard;
+  if (!FindEdgeLeaf(false, &leaf_guard)) {
+    return End();
+  }
+  return INDEXITERATOR_TYPE(bpm_, header_page_id_, comparator_, std::move(leaf_guard), std::nullopt, std::nullopt,
+                            false, &merge_epoch_);
+}
 
 /*
  * Input parameter is low key, find the leaf page that contains the input key
@@ -306,7 +789,43 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE()
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
+auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE { return Scan(key, std::nullopt, false); }
+
+/*
+ * Range scan over [key, upper], both ends included
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Begin(const KeyType &key, const KeyType &upper) -> INDEXITERATOR_TYPE {
+  return Scan(key, upper, false);
+}
+
+/*
+ * Input parameter is void, find the rightmost leaf page first, then construct
+ * an index iterator that runs in descending order
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RBegin() -> INDEXITERATOR_TYPE {
+  ReadPageGuard leaf_guard;
+  if (!FindEdgeLeaf(true, &leaf_guard)) {
+    return End();
+  }
+  return INDEXITERATOR_TYPE(bpm_, header_page_id_, comparator_, std::move(leaf_guard), std::nullopt, std::nullopt,
+                            true, &merge_epoch_);
+}
+
+/*
+ * Descending scan from the last entry whose key is not greater than the input key
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RBegin(const KeyType &key) -> INDEXITERATOR_TYPE { return Scan(key, std::nullopt, true); }
+
+/*
+ * Descending range scan over [lower, key], both ends included
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RBegin(const KeyType &key, const KeyType &lower) -> INDEXITERATOR_TYPE {
+  return Scan(key, lower, true);
+}
 
 /*
  * Input parameter is void, construct an index iterator representing the end
@@ -316,11 +835,30 @@ auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE { return IN
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
 
+/*
+ * Start a scan at key. The iterator begins after a (key, rid) pair that sorts
+ * just before (or, in reverse, just after) every entry with this key.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Scan(const KeyType &key, std::optional<KeyType> bound, bool reverse) -> INDEXITERATOR_TYPE {
+  RID edge_rid = reverse ? RID(std::numeric_limits<page_id_t>::max(), std::numeric_limits<uint32_t>::max())
+                         : RID(std::numeric_limits<page_id_t>::min(), 0);
+  ReadPageGuard parent_guard;
+  ReadPageGuard leaf_guard;
+  std::optional<std::pair<KeyType, RID>> fence;
+  if (!FindLeaf(key, edge_rid, &parent_guard, &leaf_guard, &fence)) {
+    return End();
+  }
+  parent_guard.Drop();
+  return INDEXITERATOR_TYPE(bpm_, header_page_id_, comparator_, std::move(leaf_guard), MappingType(key, edge_rid),
+                            std::move(bound), reverse, &merge_epoch_);
+}
+
 /**
  * @return Page id of the root of this tree
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t { return 0; }
+auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t { return root_page_id_.load(); }
 
 /*****************************************************************************
  * UTILITIES AND DEBUG
@@ -554,5 +1092,6 @@ template class BPlusTree<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTree<GenericKey<32>, RID, GenericComparator<32>>;
 
 template class BPlusTree<GenericKey<64>, RID, GenericComparator<64>>;
+template class BPlusTree<GenericKey<128>, RID, GenericComparator<128>>;
 
 }  // namespace bustub
@@ -20,8 +20,11 @@ BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata,
     : Index(std::move(metadata)), comparator_(GetMetadata()->GetKeySchema()) {
   page_id_t header_page_id;
   buffer_pool_manager->NewPage(&header_page_id);
-  container_ = std::make_shared<BPlusTree<KeyType, ValueType, KeyComparator>>(GetMetadata()->GetName(), header_page_id,
-                                                                              buffer_pool_manager, comparator_);
+  // table columns are not unique in general, so the tree keeps every (key, rid) pair
+  container_ = std::make_shared<BPlusTree<KeyType, ValueType, KeyComparator>>(
+      GetMetadata()->GetName(), header_page_id, buffer_pool_manager, comparator_, LEAF_PAGE_SIZE, INTERNAL_PAGE_SIZE,
+      false);
+  container_->StartCompaction();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -39,7 +42,7 @@ void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *t
   KeyType index_key;
   index_key.SetFromKey(key);
 
-  container_->Remove(index_key, transaction);
+  container_->Remove(index_key, rid, transaction);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -51,12 +54,62 @@ void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, T
   container_->GetValue(index_key, result, transaction);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::InsertEntries(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction)
+    -> size_t {
+  std::vector<std::pair<KeyType, ValueType>> index_entries(entries.size());
+  for (size_t i = 0; i < entries.size(); i++) {
+    index_entries[i].first.SetFromKey(entries[i].first);
+    index_entries[i].second = entries[i].second;
+  }
+
+  return container_->InsertBatch(index_entries, transaction);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *result,
+                                    Transaction *transaction) {
+  std::vector<KeyType> index_keys(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    index_keys[i].SetFromKey(keys[i]);
+  }
+
+  container_->GetValues(index_keys, result, transaction);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanAll(std::vector<RID> *result, Transaction *transaction) {
+  for (auto iter = container_->Begin(); !iter.IsEnd(); ++iter) {
+    result->push_back((*iter).second);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ReverseScanAll(std::vector<RID> *result, Transaction *transaction) {
+  for (auto iter = container_->RBegin(); !iter.IsEnd(); ++iter) {
+    result->push_back((*iter).second);
+  }
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_INDEX_TYPE::GetBeginIterator() -> INDEXITERATOR_TYPE { return container_->Begin(); }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_INDEX_TYPE::GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE { return container_->Begin(key); }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::GetBeginIterator(const KeyType &key, const KeyType &upper) -> INDEXITERATOR_TYPE {
+  return container_->Begin(key, upper);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::GetReverseBeginIterator() -> INDEXITERATOR_TYPE { return container_->RBegin(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::GetReverseBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE {
+  return container_->RBegin(key);
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_INDEX_TYPE::GetEndIterator() -> INDEXITERATOR_TYPE { return container_->End(); }
 
@@ -65,5 +118,6 @@ template class BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTreeIndex<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTreeIndex<GenericKey<64>, RID, GenericComparator<64>>;
+template class BPlusTreeIndex<GenericKey<128>, RID, GenericComparator<128>>;
 
 }  // namespace bustub
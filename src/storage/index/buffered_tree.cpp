@@ -0,0 +1,273 @@
+#include <algorithm>
+#include <limits>
+#include <string>
+
+#include "storage/index/buffered_tree.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+BUFFERED_TREE_TYPE::BufferedTree(std::string name, page_id_t header_page_id, BufferPoolManager *buffer_pool_manager,
+                                 const KeyComparator &comparator, int leaf_max_size, int internal_max_size)
+    : index_name_(std::move(name)),
+      bpm_(buffer_pool_manager),
+      comparator_(comparator),
+      leaf_max_size_(leaf_max_size),
+      internal_max_size_(internal_max_size),
+      header_page_id_(header_page_id) {
+  WritePageGuard guard = bpm_->FetchPageWrite(header_page_id_);
+  auto root_page = guard.AsMut<BPlusTreeHeaderPage>();
+  root_page->root_page_id_ = INVALID_PAGE_ID;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BUFFERED_TREE_TYPE::IsEmpty() const -> bool {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  return guard.As<BPlusTreeHeaderPage>()->root_page_id_ == INVALID_PAGE_ID;
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+/*
+ * Return the values associated with key. The leaf entries are combined with the
+ * messages still buffered above them, older messages first.
+ * @return : true means key exists
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BUFFERED_TREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn) -> bool {
+  ReadPageGuard header_guard = bpm_->FetchPageRead(header_page_id_);
+  page_id_t root_page_id = header_guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (root_page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  ReadPageGuard root_guard = bpm_->FetchPageRead(root_page_id);
+  header_guard.Drop();
+
+  std::vector<ValueType> values;
+  std::vector<Message> messages;
+  Collect(std::move(root_guard), key, &values, &messages);
+  for (const auto &message : messages) {
+    auto it = std::find(values.begin(), values.end(), message.value_);
+    if (message.op_ == BufferedTreeOp::INSERT && it == values.end()) {
+      values.push_back(message.value_);
+    } else if (message.op_ == BufferedTreeOp::DELETE && it != values.end()) {
+      values.erase(it);
+    }
+  }
+  std::sort(values.begin(), values.end(),
+            [](const ValueType &lhs, const ValueType &rhs) { return CompareRid(lhs, rhs) < 0; });
+  result->insert(result->end(), values.begin(), values.end());
+  return !values.empty();
+}
+
+/*
+ * Gather the leaf values and buffered messages of key below the latched page.
+ * The children that may hold key are visited while the page stays latched, so
+ * no message can move past the search. Messages are appended deepest first.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BUFFERED_TREE_TYPE::Collect(ReadPageGuard guard, const KeyType &key, std::vector<ValueType> *values,
+                                 std::vector<Message> *messages) {
+  if (guard.As<BufferedTreePage>()->IsLeafPage()) {
+    auto leaf = guard.As<LeafPage>();
+    for (int i = leaf->KeyIndex(key, comparator_); i < leaf->GetSize() && comparator_(leaf->KeyAt(i), key) == 0;
+         ++i) {
+      values->push_back(leaf->ValueAt(i));
+    }
+    return;
+  }
+
+  auto node = guard.As<InternalPage>();
+  int first = node->ChildIndex(key, RID(std::numeric_limits<page_id_t>::min(), 0), comparator_);
+  int last = node->ChildIndex(
+      key, RID(std::numeric_limits<page_id_t>::max(), std::numeric_limits<uint32_t>::max()), comparator_);
+  for (int i = first; i <= last; ++i) {
+    Collect(bpm_->FetchPageRead(node->ChildAt(i)), key, values, messages);
+  }
+  for (int i = 0; i < node->GetBufferSize(); ++i) {
+    if (comparator_(node->MessageAt(i).key_, key) == 0) {
+      messages->push_back(node->MessageAt(i));
+    }
+  }
+}
+
+/*****************************************************************************
+ * INSERTION / REMOVE
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void BUFFERED_TREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *txn) {
+  Put({key, value, BufferedTreeOp::INSERT});
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BUFFERED_TREE_TYPE::Remove(const KeyType &key, const ValueType &value, Transaction *txn) {
+  Put({key, value, BufferedTreeOp::DELETE});
+}
+
+/*
+ * Add a message to the root buffer. A root leaf takes the message directly.
+ * The header page stays write latched, which is what serializes writers: they
+ * all go through the root buffer anyway.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BUFFERED_TREE_TYPE::Put(const Message &message) {
+  WritePageGuard header_guard = bpm_->FetchPageWrite(header_page_id_);
+  auto header = header_guard.AsMut<BPlusTreeHeaderPage>();
+  if (header->root_page_id_ == INVALID_PAGE_ID) {
+    if (message.op_ == BufferedTreeOp::DELETE) {
+      return;
+    }
+    BasicPageGuard leaf_guard = bpm_->NewPageGuarded(&header->root_page_id_);
+    leaf_guard.AsMut<LeafPage>()->Init(leaf_max_size_);
+  }
+
+  WritePageGuard root_guard = bpm_->FetchPageWrite(header->root_page_id_);
+  while (true) {
+    if (root_guard.As<BufferedTreePage>()->IsLeafPage()) {
+      if (root_guard.AsMut<LeafPage>()->Apply(message, comparator_)) {
+        return;
+      }
+      SplitRoot(header, &root_guard);
+      continue;
+    }
+
+    auto root = root_guard.AsMut<InternalPage>();
+    if (IsFull(root)) {
+      SplitRoot(header, &root_guard);
+      continue;
+    }
+    if (root->IsBufferFull()) {
+      FlushBuffer(root);
+      // the flush is stuck on full pages below that the root has no room to split
+      if (root->IsBufferFull()) {
+        SplitRoot(header, &root_guard);
+        continue;
+      }
+    }
+    root->AppendMessage(message);
+    return;
+  }
+}
+
+/*
+ * Whether a page has no room left: a leaf for another entry, an internal page
+ * for another child.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BUFFERED_TREE_TYPE::IsFull(const BufferedTreePage *page) const -> bool {
+  return page->GetSize() >= page->GetMaxSize();
+}
+
+/*
+ * Split the root into two pages under a new root, and latch the new root.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BUFFERED_TREE_TYPE::SplitRoot(BPlusTreeHeaderPage *header, WritePageGuard *root_guard) {
+  page_id_t new_root_page_id;
+  BasicPageGuard new_root_guard = bpm_->NewPageGuarded(&new_root_page_id);
+  auto new_root = new_root_guard.AsMut<InternalPage>();
+  new_root->Init(internal_max_size_);
+  // the pivot of the first child is never looked at
+  new_root->InsertChild(0, KeyType{}, ValueType{}, root_guard->PageId());
+  SplitChild(new_root, 0, root_guard);
+  header->root_page_id_ = new_root_page_id;
+  new_root_guard.Drop();
+  *root_guard = bpm_->FetchPageWrite(new_root_page_id);
+}
+
+/*
+ * Move the upper half of the child at index into a new page, which becomes the
+ * next child of parent. The parent must have room for another child.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BUFFERED_TREE_TYPE::SplitChild(InternalPage *parent, int index, WritePageGuard *child_guard) {
+  page_id_t sibling_page_id;
+  BasicPageGuard sibling_guard = bpm_->NewPageGuarded(&sibling_page_id);
+  MappingType separator;
+  if (child_guard->As<BufferedTreePage>()->IsLeafPage()) {
+    auto sibling = sibling_guard.AsMut<LeafPage>();
+    sibling->Init(leaf_max_size_);
+    child_guard->AsMut<LeafPage>()->MoveHalfTo(sibling);
+    separator = MappingType(sibling->KeyAt(0), sibling->ValueAt(0));
+  } else {
+    auto sibling = sibling_guard.AsMut<InternalPage>();
+    sibling->Init(internal_max_size_);
+    separator = child_guard->AsMut<InternalPage>()->MoveHalfTo(sibling, comparator_);
+  }
+  parent->InsertChild(index + 1, separator.first, separator.second, sibling_page_id);
+}
+
+/*
+ * Move messages down until at most half of the buffer of node is in use, or
+ * until no more progress can be made.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BUFFERED_TREE_TYPE::FlushBuffer(InternalPage *node) {
+  while (node->GetBufferSize() > node->GetBufferMaxSize() / 2 && FlushChild(node, node->BusiestChild(comparator_))) {
+  }
+}
+
+/*
+ * Move the buffered messages headed for the child at index one level down. A
+ * full child is split instead, if node has room for that. A leaf child applies
+ * the messages, an internal child buffers as many as it has room for, flushing
+ * its own buffer first if needed.
+ * @return : false means nothing could be done
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BUFFERED_TREE_TYPE::FlushChild(InternalPage *node, int index) -> bool {
+  WritePageGuard child_guard = bpm_->FetchPageWrite(node->ChildAt(index));
+  if (IsFull(child_guard.As<BufferedTreePage>())) {
+    if (IsFull(node)) {
+      return false;
+    }
+    SplitChild(node, index, &child_guard);
+    return true;
+  }
+
+  std::vector<Message> messages;
+  if (child_guard.As<BufferedTreePage>()->IsLeafPage()) {
+    auto leaf = child_guard.AsMut<LeafPage>();
+    node->TakeMessages(index, node->GetBufferSize(), comparator_, &messages);
+    for (size_t i = 0; i < messages.size(); ++i) {
+      if (!leaf->Apply(messages[i], comparator_)) {
+        // the leaf filled up, the rest goes back and waits for a split
+        for (; i < messages.size(); ++i) {
+          node->AppendMessage(messages[i]);
+        }
+        break;
+      }
+    }
+    return true;
+  }
+
+  auto child = child_guard.AsMut<InternalPage>();
+  if (child->IsBufferFull()) {
+    FlushBuffer(child);
+  }
+  int room = child->GetBufferMaxSize() - child->GetBufferSize();
+  node->TakeMessages(index, room, comparator_, &messages);
+  for (const auto &message : messages) {
+    child->AppendMessage(message);
+  }
+  return !messages.empty();
+}
+
+/**
+ * @return Page id of the root of this tree
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BUFFERED_TREE_TYPE::GetRootPageId() -> page_id_t {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  return guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+}
+
+template class BufferedTree<GenericKey<4>, RID, GenericComparator<4>>;
+template class BufferedTree<GenericKey<8>, RID, GenericComparator<8>>;
+template class BufferedTree<GenericKey<16>, RID, GenericComparator<16>>;
+template class BufferedTree<GenericKey<32>, RID, GenericComparator<32>>;
+template class BufferedTree<GenericKey<64>, RID, GenericComparator<64>>;
+template class BufferedTree<GenericKey<128>, RID, GenericComparator<128>>;
+
+}  // namespace bustub
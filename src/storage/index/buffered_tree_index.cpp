@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffered_tree_index.cpp
+//
+// Identification: src/storage/index/buffered_tree_index.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/buffered_tree_index.h"
+
+namespace bustub {
+/*
+ * Constructor
+ */
+INDEX_TEMPLATE_ARGUMENTS
+BUFFERED_TREE_INDEX_TYPE::BufferedTreeIndex(std::unique_ptr<IndexMetadata> &&metadata,
+                                            BufferPoolManager *buffer_pool_manager)
+    : Index(std::move(metadata)), comparator_(GetMetadata()->GetKeySchema()) {
+  page_id_t header_page_id;
+  buffer_pool_manager->NewPage(&header_page_id);
+  container_ = std::make_shared<BufferedTree<KeyType, ValueType, KeyComparator>>(
+      GetMetadata()->GetName(), header_page_id, buffer_pool_manager, comparator_);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BUFFERED_TREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool {
+  // construct insert index key
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  container_->Insert(index_key, rid, transaction);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BUFFERED_TREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  // construct delete index key
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  container_->Remove(index_key, rid, transaction);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BUFFERED_TREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  // construct scan index key
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  container_->GetValue(index_key, result, transaction);
+}
+
+template class BufferedTreeIndex<GenericKey<4>, RID, GenericComparator<4>>;
+template class BufferedTreeIndex<GenericKey<8>, RID, GenericComparator<8>>;
+template class BufferedTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
+template class BufferedTreeIndex<GenericKey<32>, RID, GenericComparator<32>>;
+template class BufferedTreeIndex<GenericKey<64>, RID, GenericComparator<64>>;
+template class BufferedTreeIndex<GenericKey<128>, RID, GenericComparator<128>>;
+
+}  // namespace bustub
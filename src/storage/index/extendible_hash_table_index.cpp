@@ -45,5 +45,6 @@ template class ExtendibleHashTableIndex<GenericKey<8>, RID, GenericComparator<8>
 template class ExtendibleHashTableIndex<GenericKey<16>, RID, GenericComparator<16>>;
 template class ExtendibleHashTableIndex<GenericKey<32>, RID, GenericComparator<32>>;
 template class ExtendibleHashTableIndex<GenericKey<64>, RID, GenericComparator<64>>;
+template class ExtendibleHashTableIndex<GenericKey<128>, RID, GenericComparator<128>>;
 
 }  // namespace bustub
@@ -7,24 +7,196 @@
 
 namespace bustub {
 
-/*
- * NOTE: you can change the destructor/constructor method here
- * set your own input parameters
- */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::IndexIterator() = default;
 
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *bpm, page_id_t header_page_id, const KeyComparator &comparator,
+                                  ReadPageGuard leaf_guard, std::optional<MappingType> after,
+                                  std::optional<KeyType> bound, bool reverse, const std::atomic<uint64_t> *merge_epoch)
+    : bpm_(bpm),
+      header_page_id_(header_page_id),
+      comparator_(comparator),
+      merge_epoch_(merge_epoch),
+      epoch_(merge_epoch->load()),
+      reverse_(reverse),
+      bound_(std::move(bound)),
+      last_(std::move(after)),
+      page_id_(leaf_guard.PageId()) {
+  LoadLeaf(leaf_guard.As<LeafPage>());
+  leaf_guard.Drop();
+  if (batch_.empty()) {
+    Advance();
+  }
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::~IndexIterator() = default;  // NOLINT
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::IsEnd() -> bool { throw std::runtime_error("unimplemented"); }
+auto INDEXITERATOR_TYPE::IsEnd() -> bool { return page_id_ == INVALID_PAGE_ID; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator*() -> const MappingType & { return batch_[index_]; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
+  if (++index_ >= batch_.size()) {
+    Advance();
+  }
+  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::NextBatch(std::vector<MappingType> *batch) -> bool {
+  if (IsEnd()) {
+    return false;
+  }
+  batch->insert(batch->end(), batch_.begin() + index_, batch_.end());
+  Advance();
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::Follows(const MappingType &entry) const -> bool {
+  if (!last_.has_value()) {
+    return true;
+  }
+  int result = (*comparator_)(entry.first, last_->first);
+  if (result == 0) {
+    result = CompareRid(entry.second, last_->second);
+  }
+  return reverse_ ? result < 0 : result > 0;
+}
 
+/*
+ * Copy the entries of leaf that come after last_ and within the bound into the
+ * batch, in scan order. The caller holds the read latch of leaf.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::LoadLeaf(const LeafPage *leaf) {
+  batch_.clear();
+  index_ = 0;
+  int size = leaf->GetSize();
+  for (int i = 0; i < size; ++i) {
+    MappingType entry(leaf->KeyAt(reverse_ ? size - 1 - i : i), leaf->ValueAt(reverse_ ? size - 1 - i : i));
+    if (!Follows(entry)) {
+      continue;
+    }
+    if (bound_.has_value()) {
+      int result = (*comparator_)(entry.first, *bound_);
+      if (reverse_ ? result < 0 : result > 0) {
+        bounded_ = true;
+        break;
+      }
+    }
+    batch_.push_back(std::move(entry));
+  }
+}
+
+/*
+ * Move on to the next leaf in scan order that has entries left, or to the end.
+ * A forward scan holds the latch of the current leaf while latching the next
+ * one, the same left to right order inserts use. A backward scan cannot do that
+ * without risking a deadlock, so it latches the previous leaf alone and checks
+ * that its next link still points back. If not, the previous leaf was split and
+ * the scan descends from the root to find its position again. It does the same
+ * whenever leaves were merged since the batch was loaded, the merge epoch being
+ * checked only once a leaf is latched, as merges happen under the leaf latches.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::Advance() {
+  if (!batch_.empty()) {
+    last_ = batch_.back();
+  }
+  batch_.clear();
+  index_ = 0;
+
+  while (batch_.empty()) {
+    if (bounded_) {
+      Finish();
+      return;
+    }
+    ReadPageGuard guard = bpm_->FetchPageRead(page_id_);
+    if (merge_epoch_->load() != epoch_) {
+      // the current leaf may be gone, and its entries may have moved into a leaf the scan already passed
+      guard.Drop();
+      epoch_ = merge_epoch_->load();
+      if (!FindLeaf(&guard)) {
+        Finish();
+        return;
+      }
+    } else if (!reverse_) {
+      page_id_t next_page_id = guard.As<LeafPage>()->GetNextPageId();
+      if (next_page_id == INVALID_PAGE_ID) {
+        Finish();
+        return;
+      }
+      ReadPageGuard next_guard = bpm_->FetchPageRead(next_page_id);
+      guard = std::move(next_guard);
+    } else {
+      page_id_t prev_page_id = guard.As<LeafPage>()->GetPrevPageId();
+      guard.Drop();
+      if (prev_page_id == INVALID_PAGE_ID) {
+        Finish();
+        return;
+      }
+      guard = bpm_->FetchPageRead(prev_page_id);
+      if (merge_epoch_->load() != epoch_ || guard.As<LeafPage>()->GetNextPageId() != page_id_) {
+        guard.Drop();
+        epoch_ = merge_epoch_->load();
+        if (!FindLeaf(&guard)) {
+          Finish();
+          return;
+        }
+      }
+    }
+    page_id_ = guard.PageId();
+    auto leaf = guard.As<LeafPage>();
+    LoadLeaf(leaf);
+    page_id_t following_page_id = reverse_ ? leaf->GetPrevPageId() : leaf->GetNextPageId();
+    guard.Drop();
+
+    // bring the following leaf in while the caller works on this batch
+    if (!batch_.empty() && !bounded_ && following_page_id != INVALID_PAGE_ID) {
+      bpm_->PrefetchPage(following_page_id);
+    }
+  }
+}
+
+/*
+ * @return : false means the tree is empty
+ */
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator*() -> const MappingType & { throw std::runtime_error("unimplemented"); }
+auto INDEXITERATOR_TYPE::FindLeaf(ReadPageGuard *leaf_guard) -> bool {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  page_id_t page_id = guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  ReadPageGuard child_guard = bpm_->FetchPageRead(page_id);
+  guard = std::move(child_guard);
+  while (!guard.As<BPlusTreePage>()->IsLeafPage()) {
+    auto inner_node = guard.As<InternalPage>();
+    int index;
+    if (last_.has_value()) {
+      index = inner_node->KeyIndex(last_->first, last_->second, *comparator_);
+    } else {
+      index = reverse_ ? inner_node->GetSize() - 1 : 0;
+    }
+    child_guard = bpm_->FetchPageRead(inner_node->ValueAt(index));
+    guard = std::move(child_guard);
+  }
+  *leaf_guard = std::move(guard);
+  return true;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & { throw std::runtime_error("unimplemented"); }
+void INDEXITERATOR_TYPE::Finish() {
+  page_id_ = INVALID_PAGE_ID;
+  batch_.clear();
+  index_ = 0;
+}
 
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
 
@@ -35,5 +207,6 @@ template class IndexIterator<GenericKey<16>, RID, GenericComparator<16>>;
 template class IndexIterator<GenericKey<32>, RID, GenericComparator<32>>;
 
 template class IndexIterator<GenericKey<64>, RID, GenericComparator<64>>;
+template class IndexIterator<GenericKey<128>, RID, GenericComparator<128>>;
 
 }  // namespace bustub
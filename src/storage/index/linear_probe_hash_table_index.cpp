@@ -7,15 +7,15 @@ namespace bustub {
  * Constructor
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
-HASH_TABLE_INDEX_TYPE::LinearProbeHashTableIndex(std::unique_ptr<IndexMetadata> &&metadata,
-                                                 BufferPoolManager *buffer_pool_manager, size_t num_buckets,
-                                                 const HashFunction<KeyType> &hash_fn)
+LINEAR_PROBE_HASH_TABLE_INDEX_TYPE::LinearProbeHashTableIndex(std::unique_ptr<IndexMetadata> &&metadata,
+                                                              BufferPoolManager *buffer_pool_manager,
+                                                              size_t num_buckets, const HashFunction<KeyType> &hash_fn)
     : Index(std::move(metadata)),
       comparator_(GetMetadata()->GetKeySchema()),
       container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_, num_buckets, hash_fn) {}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool {
+auto LINEAR_PROBE_HASH_TABLE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool {
   // construct insert index key
   KeyType index_key;
   index_key.SetFromKey(key);
@@ -24,7 +24,7 @@ auto HASH_TABLE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+void LINEAR_PROBE_HASH_TABLE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
   // construct delete index key
   KeyType index_key;
   index_key.SetFromKey(key);
@@ -33,7 +33,7 @@ void HASH_TABLE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+void LINEAR_PROBE_HASH_TABLE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
   // construct scan index key
   KeyType index_key;
   index_key.SetFromKey(key);
@@ -45,5 +45,6 @@ template class LinearProbeHashTableIndex<GenericKey<8>, RID, GenericComparator<8
 template class LinearProbeHashTableIndex<GenericKey<16>, RID, GenericComparator<16>>;
 template class LinearProbeHashTableIndex<GenericKey<32>, RID, GenericComparator<32>>;
 template class LinearProbeHashTableIndex<GenericKey<64>, RID, GenericComparator<64>>;
+template class LinearProbeHashTableIndex<GenericKey<128>, RID, GenericComparator<128>>;
 
 }  // namespace bustub
@@ -9,10 +9,13 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 
 #include "common/exception.h"
+#include "common/macros.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 
 namespace bustub {
@@ -26,8 +29,8 @@ namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(int max_size) {
   SetPageType(IndexPageType::INTERNAL_PAGE);
-  SetSize(0);
   SetMaxSize(max_size);
+  ResetCells(CELL_LAYOUT, nullptr, 0);
 }
 /*
  * Helper method to get/set the key associated with input "index"(a.k.a
@@ -35,14 +38,44 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(int max_size) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType {
-  // replace with your own code
-  KeyType ans = array_[index].first;
-  return ans;
+  char separator[SEPARATOR_SIZE];
+  ReadCell(CELL_LAYOUT, index, separator, nullptr);
+  KeyType key;
+  memcpy(&key, separator, sizeof(KeyType));
+  return key;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
-  array_[index].first = key;
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::RidAt(int index) const -> RID {
+  char separator[SEPARATOR_SIZE];
+  ReadCell(CELL_LAYOUT, index, separator, nullptr);
+  RID rid;
+  memcpy(&rid, separator + sizeof(KeyType), sizeof(RID));
+  return rid;
+}
+
+/*
+ * The key is stored in a cell of its own length, so the entry is written anew
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key, const RID &rid) {
+  char separator[SEPARATOR_SIZE];
+  memcpy(separator, &key, sizeof(KeyType));
+  memcpy(separator + sizeof(KeyType), &rid, sizeof(RID));
+  ValueType value = ValueAt(index);
+  RemoveCell(CELL_LAYOUT, index);
+  bool inserted = InsertCell(CELL_LAYOUT, index, separator, reinterpret_cast<const char *>(&value));
+  BUSTUB_ASSERT(inserted, "internal page is out of space");
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const -> int {
+  for (int i = 0; i < GetSize(); i++) {
+    if (ValueAt(i) == value) {
+      return i;
+    }
+  }
+  return -1;
 }
 
 /*
@@ -51,64 +84,192 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType {
-  return array_[index].second;
+  ValueType value;
+  ReadCell(CELL_LAYOUT, index, nullptr, reinterpret_cast<char *>(&value));
+  return value;
+}
+
+/*
+ * Compare the separator at index with (key, rid), keys first
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::CompareAt(int index, const KeyType &key, const RID &rid,
+                                               const KeyComparator &comparator) const -> int {
+  char separator[SEPARATOR_SIZE];
+  ReadCell(CELL_LAYOUT, index, separator, nullptr);
+  KeyType separator_key;
+  RID separator_rid;
+  memcpy(&separator_key, separator, sizeof(KeyType));
+  memcpy(&separator_rid, separator + sizeof(KeyType), sizeof(RID));
+  int result = comparator(separator_key, key);
+  return result != 0 ? result : CompareRid(separator_rid, rid);
+}
+
+/*
+ * Index of the child whose subtree covers (key, rid): the last separator (ignoring the first) not greater than it
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyIndex(const KeyType &key, const RID &rid,
+                                              const KeyComparator &key_comparator) const -> int {
+  int lo = 1;
+  int hi = GetSize();
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (CompareAt(mid, key, rid, key_comparator) > 0) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  return lo - 1;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &key_comparator) const -> int {
-  auto pair_comparator = [&](const KeyType &val, const MappingType &pair) -> bool {
-    return key_comparator(val, pair.first) < 0;
-  };
-  int idx = std::upper_bound(array_ + 1, array_ + GetSize(), key, pair_comparator) - array_ - 1;
-  return idx;
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &value) {
+  WriteCellValue(CELL_LAYOUT, index, reinterpret_cast<const char *>(&value));
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &value) { array_[index].second = value; }
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertAtBack(const KeyType &key, const RID &rid, const ValueType &value) {
+  char separator[SEPARATOR_SIZE];
+  memcpy(separator, &key, sizeof(KeyType));
+  memcpy(separator + sizeof(KeyType), &rid, sizeof(RID));
+  bool inserted = InsertCell(CELL_LAYOUT, GetSize(), separator, reinterpret_cast<const char *>(&value));
+  BUSTUB_ASSERT(inserted, "internal page is out of space");
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::ReduceToHalf(bool smaller) {
-  int split_size = (GetMaxSize() + 1) / 2;
-  if (smaller) {
-    --split_size;
-  }
-  SetSize(split_size);
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertValue(const KeyType &key, const RID &rid, const ValueType &value,
+                                                 const KeyComparator &comparator) {
+  char separator[SEPARATOR_SIZE];
+  memcpy(separator, &key, sizeof(KeyType));
+  memcpy(separator + sizeof(KeyType), &rid, sizeof(RID));
+  int id = KeyIndex(key, rid, comparator) + 1;
+  bool inserted = InsertCell(CELL_LAYOUT, id, separator, reinterpret_cast<const char *>(&value));
+  BUSTUB_ASSERT(inserted, "internal page is out of space");
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertAtBack(const KeyType &key, const ValueType &value) {
-  int back_id = GetSize();
-  array_[back_id] = {key, value};
-  IncreaseSize(1);
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::RemoveAt(int index) {
+  RemoveCell(CELL_LAYOUT, index);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertAtBack(const MappingType &pair) {
-  int back_id = GetSize();
-  array_[back_id] = pair;
-  IncreaseSize(1);
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::CanInsert(const KeyType &key, const RID &rid) const -> bool {
+  char separator[SEPARATOR_SIZE];
+  memcpy(separator, &key, sizeof(KeyType));
+  memcpy(separator + sizeof(KeyType), &rid, sizeof(RID));
+  return GetSize() < GetMaxSize() && HasRoomForCell(CELL_LAYOUT, separator);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertAtFront(const MappingType &pair) {
-  int back_id = GetSize();
-  IncreaseSize(1);
-  for (int i = back_id - 1; i >= 0; --i) {
-    array_[i + 1] = array_[i];
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::CanInsertAny() const -> bool {
+  return GetSize() < GetMaxSize() && HasRoomForAnyCell(CELL_LAYOUT);
+}
+
+/*
+ * All separators and values of this page plus the new entry, which goes right after the child it was split from
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::GatherWith(const KeyType &key, const RID &rid, const ValueType &value,
+                                                const KeyComparator &comparator, std::vector<char> *separators,
+                                                std::vector<ValueType> *values) const {
+  int size = GetSize();
+  int id = KeyIndex(key, rid, comparator) + 1;
+  separators->resize((size + 1) * SEPARATOR_SIZE);
+  values->resize(size + 1);
+  for (int i = 0, slot = 0; slot <= size; slot++) {
+    char *separator = separators->data() + slot * SEPARATOR_SIZE;
+    if (slot == id) {
+      memcpy(separator, &key, sizeof(KeyType));
+      memcpy(separator + sizeof(KeyType), &rid, sizeof(RID));
+      (*values)[slot] = value;
+      continue;
+    }
+    ReadCell(CELL_LAYOUT, i, separator, reinterpret_cast<char *>(&(*values)[slot]));
+    i++;
   }
-  array_[0] = pair;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertValue(const KeyType &key, const ValueType &value,
-                                                 const KeyComparator &comparator) {
-  int id = KeyIndex(key, comparator);
-  int pre_size = GetSize();
-  IncreaseSize(1);
-  for (int i = pre_size - 1; i > id; --i) {
-    array_[i + 1] = array_[i];
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::SplitKey(const KeyType &key, const RID &rid, const KeyComparator &comparator) const
+    -> std::pair<KeyType, RID> {
+  std::vector<char> separators;
+  std::vector<ValueType> values;
+  GatherWith(key, rid, ValueType{}, comparator, &separators, &values);
+  std::vector<const char *> keys;
+  keys.reserve(values.size());
+  for (size_t i = 0; i < values.size(); i++) {
+    keys.push_back(separators.data() + i * SEPARATOR_SIZE);
+  }
+  const char *lifted = keys[PlanSplit(CELL_LAYOUT, keys)];
+  std::pair<KeyType, RID> separator;
+  memcpy(&separator.first, lifted, sizeof(KeyType));
+  memcpy(&separator.second, lifted + sizeof(KeyType), sizeof(RID));
+  return separator;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertAndSplit(const KeyType &key, const RID &rid, const ValueType &value,
+                                                    const KeyComparator &comparator,
+                                                    BPlusTreeInternalPage *recipient) {
+  std::vector<char> separators;
+  std::vector<ValueType> values;
+  GatherWith(key, rid, value, comparator, &separators, &values);
+  std::vector<const char *> keys;
+  std::vector<const char *> value_ptrs;
+  keys.reserve(values.size());
+  value_ptrs.reserve(values.size());
+  for (size_t i = 0; i < values.size(); i++) {
+    keys.push_back(separators.data() + i * SEPARATOR_SIZE);
+    value_ptrs.push_back(reinterpret_cast<const char *>(&values[i]));
+  }
+  SplitCells(CELL_LAYOUT, keys, value_ptrs, recipient);
+}
+
+/*****************************************************************************
+ * MERGE
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::FillRatio() const -> double {
+  double count_fill = static_cast<double>(GetSize()) / GetMaxSize();
+  return std::max(count_fill, CellAreaFill(CELL_LAYOUT));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::MergeFrom(BPlusTreeInternalPage *sibling, const KeyType &key, const RID &rid)
+    -> bool {
+  int size = GetSize() + sibling->GetSize();
+  if (size > GetMaxSize()) {
+    return false;
+  }
+  std::vector<char> separators(size * SEPARATOR_SIZE);
+  std::vector<ValueType> values(size);
+  for (int i = 0; i < GetSize(); i++) {
+    ReadCell(CELL_LAYOUT, i, separators.data() + i * SEPARATOR_SIZE, reinterpret_cast<char *>(&values[i]));
+  }
+  for (int i = 0; i < sibling->GetSize(); i++) {
+    int slot = GetSize() + i;
+    sibling->ReadCell(CELL_LAYOUT, i, separators.data() + slot * SEPARATOR_SIZE,
+                      reinterpret_cast<char *>(&values[slot]));
+  }
+  char *first = separators.data() + GetSize() * SEPARATOR_SIZE;
+  memcpy(first, &key, sizeof(KeyType));
+  memcpy(first + sizeof(KeyType), &rid, sizeof(RID));
+
+  std::vector<const char *> keys;
+  std::vector<const char *> value_ptrs;
+  keys.reserve(size);
+  value_ptrs.reserve(size);
+  for (int i = 0; i < size; i++) {
+    keys.push_back(separators.data() + i * SEPARATOR_SIZE);
+    value_ptrs.push_back(reinterpret_cast<const char *>(&values[i]));
+  }
+  if (!MergeCells(CELL_LAYOUT, keys, value_ptrs)) {
+    return false;
   }
-  array_[id + 1] = {key, value};
+  sibling->ResetCells(CELL_LAYOUT, nullptr, 0);
+  return true;
 }
 
 // valuetype for internalNode should be page id_t
@@ -117,4 +278,5 @@ template class BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator
 template class BPlusTreeInternalPage<GenericKey<16>, page_id_t, GenericComparator<16>>;
 template class BPlusTreeInternalPage<GenericKey<32>, page_id_t, GenericComparator<32>>;
 template class BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+template class BPlusTreeInternalPage<GenericKey<128>, page_id_t, GenericComparator<128>>;
 }  // namespace bustub
@@ -9,9 +9,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <sstream>
 
 #include "common/exception.h"
+#include "common/macros.h"
 #include "common/rid.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
@@ -28,13 +30,14 @@ namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(int max_size) {
   SetPageType(IndexPageType::LEAF_PAGE);
-  SetSize(0);
   SetMaxSize(max_size);
   SetNextPageId(INVALID_PAGE_ID);
+  SetPrevPageId(INVALID_PAGE_ID);
+  ResetCells(CELL_LAYOUT, nullptr, 0);
 }
 
 /**
- * Helper methods to set/get next page id
+ * Helper methods to set/get next and previous page id
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const -> page_id_t {
@@ -46,86 +49,219 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
   next_page_id_ = next_page_id;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetPrevPageId() const -> page_id_t {
+  return prev_page_id_;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetPrevPageId(page_id_t prev_page_id) {
+  prev_page_id_ = prev_page_id;
+}
+
 /*
  * Helper method to find and return the key associated with input "index"(a.k.a
  * array offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType {
-  // replace with your own code
-  KeyType key = array_[index].first;
+  KeyType key;
+  ReadCell(CELL_LAYOUT, index, reinterpret_cast<char *>(&key), nullptr);
   return key;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { array_[index].first = key; }
-
-INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType { return array_[index].second; }
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType {
+  ValueType value;
+  ReadCell(CELL_LAYOUT, index, nullptr, reinterpret_cast<char *>(&value));
+  return value;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::SetValueAt(int index, const ValueType &value) { array_[index].second = value; }
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetValueAt(int index, const ValueType &value) {
+  WriteCellValue(CELL_LAYOUT, index, reinterpret_cast<const char *>(&value));
+}
 
+/*
+ * Index of the first key that is not less than `key` (lower bound)
+ */
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::IndexAt(const KeyType &key, const KeyComparator &comparator) const -> int {
-  auto cmp = [&](const MappingType &element, const KeyType &val) -> bool { return comparator(element.first, val) < 0; };
-  return std::lower_bound(array_, array_ + GetSize(), key, cmp) - array_;
+  int lo = 0;
+  int hi = GetSize();
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (comparator(KeyAt(mid), key) < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
 }
 
+/*
+ * Index of the first entry that is not less than (key, value), for trees that keep duplicate keys
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::ReduceToHalf() {
-  SetSize(GetSize()/2);
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::IndexAt(const KeyType &key, const ValueType &value,
+                                         const KeyComparator &comparator) const -> int {
+  int lo = 0;
+  int hi = GetSize();
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    int result = comparator(KeyAt(mid), key);
+    if (result < 0 || (result == 0 && CompareRid(ValueAt(mid), value) < 0)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetValue(const KeyType &key, ValueType *value, const KeyComparator &comparator) const
     -> bool {
-  //  auto cmp = [&](const MappingType &element, const KeyType &val) -> bool { return comparator(element.first, val) <
-  //  0; }; int id = std::lower_bound(array_, array_ + GetSize(), key, cmp) - array_;
   int id = IndexAt(key, comparator);
   if (id == GetSize() || comparator(KeyAt(id), key) != 0) {
     return false;
   }
-  *value = array_[id].second;
+  *value = ValueAt(id);
   return true;
 }
 
+/*
+ * Insert a pair in key order. The caller makes sure the page has room for it.
+ * @return false if the key already exists
+ */
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::InsertValue(const KeyType &key, const ValueType &value,
                                              const KeyComparator &comparator) -> bool {
-  //  auto cmp = [&](const MappingType &element, const KeyType &val) -> bool { return comparator(element.first, val) <
-  //  0; }; int id = std::lower_bound(array_, array_ + GetSize(), key, cmp) - array_;
   int id = IndexAt(key, comparator);
   if (id != GetSize() && comparator(KeyAt(id), key) == 0) {
     return false;
   }
-  auto size = GetSize();
-  IncreaseSize(1);
-  for (int i = size - 1; i >= id; --i) {
-    array_[i + 1] = array_[i];
-  }
-  array_[id] = {key, value};
+  InsertAt(id, key, value);
   return true;
-};
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::InsertAt(int index, const KeyType &key, const ValueType &value) {
+  bool inserted =
+      InsertCell(CELL_LAYOUT, index, reinterpret_cast<const char *>(&key), reinterpret_cast<const char *>(&value));
+  BUSTUB_ASSERT(inserted, "leaf page is out of space");
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::InsertAtBack(const KeyType &key, const ValueType &value) {
-  int back_id = GetSize();
-  array_[back_id] = {key, value};
-  IncreaseSize(1);
+  InsertAt(GetSize(), key, value);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::InsertAtBack(const MappingType &pair) {
-  int back_id = GetSize();
-  array_[back_id] = pair;
-  IncreaseSize(1);
+  InsertAtBack(pair.first, pair.second);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAt(int index) {
+  RemoveCell(CELL_LAYOUT, index);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::CanInsert(const KeyType &key) const -> bool {
+  return GetSize() + 1 < GetMaxSize() && HasRoomForCell(CELL_LAYOUT, reinterpret_cast<const char *>(&key));
+}
+
+/*
+ * All entries of this page plus the new pair at index
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::EntriesWith(int index, const KeyType &key, const ValueType &value) const
+    -> std::vector<MappingType> {
+  std::vector<MappingType> entries;
+  entries.reserve(GetSize() + 1);
+  for (int i = 0; i < GetSize(); i++) {
+    if (i == index) {
+      entries.emplace_back(key, value);
+    }
+    entries.emplace_back(KeyAt(i), ValueAt(i));
+  }
+  if (index == GetSize()) {
+    entries.emplace_back(key, value);
+  }
+  return entries;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::SplitKey(int index, const KeyType &key, const ValueType &value) const
+    -> MappingType {
+  auto entries = EntriesWith(index, key, value);
+  std::vector<const char *> keys;
+  keys.reserve(entries.size());
+  for (const auto &entry : entries) {
+    keys.push_back(reinterpret_cast<const char *>(&entry.first));
+  }
+  return entries[PlanSplit(CELL_LAYOUT, keys)];
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::InsertAndSplit(int index, const KeyType &key, const ValueType &value,
+                                                BPlusTreeLeafPage *recipient) {
+  auto entries = EntriesWith(index, key, value);
+  std::vector<const char *> keys;
+  std::vector<const char *> values;
+  keys.reserve(entries.size());
+  values.reserve(entries.size());
+  for (const auto &entry : entries) {
+    keys.push_back(reinterpret_cast<const char *>(&entry.first));
+    values.push_back(reinterpret_cast<const char *>(&entry.second));
+  }
+  SplitCells(CELL_LAYOUT, keys, values, recipient);
+}
+
+/*****************************************************************************
+ * MERGE
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::FillRatio() const -> double {
+  // a leaf holds at most max size - 1 entries, see CanInsert
+  double count_fill = static_cast<double>(GetSize()) / (GetMaxSize() - 1);
+  return std::max(count_fill, CellAreaFill(CELL_LAYOUT));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::MergeFrom(BPlusTreeLeafPage *sibling) -> bool {
+  if (GetSize() + sibling->GetSize() >= GetMaxSize()) {
+    return false;
+  }
+  std::vector<MappingType> entries;
+  entries.reserve(GetSize() + sibling->GetSize());
+  for (int i = 0; i < GetSize(); i++) {
+    entries.emplace_back(KeyAt(i), ValueAt(i));
+  }
+  for (int i = 0; i < sibling->GetSize(); i++) {
+    entries.emplace_back(sibling->KeyAt(i), sibling->ValueAt(i));
+  }
+  std::vector<const char *> keys;
+  std::vector<const char *> values;
+  keys.reserve(entries.size());
+  values.reserve(entries.size());
+  for (const auto &entry : entries) {
+    keys.push_back(reinterpret_cast<const char *>(&entry.first));
+    values.push_back(reinterpret_cast<const char *>(&entry.second));
+  }
+  if (!MergeCells(CELL_LAYOUT, keys, values)) {
+    return false;
+  }
+  sibling->ResetCells(CELL_LAYOUT, nullptr, 0);
+  return true;
+}
 
 template class BPlusTreeLeafPage<GenericKey<4>, RID, GenericComparator<4>>;
 template class BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeLeafPage<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTreeLeafPage<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTreeLeafPage<GenericKey<64>, RID, GenericComparator<64>>;
+template class BPlusTreeLeafPage<GenericKey<128>, RID, GenericComparator<128>>;
 }  // namespace bustub
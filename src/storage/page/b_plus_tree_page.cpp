@@ -9,6 +9,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <cstring>
+
+#include "common/macros.h"
 #include "storage/page/b_plus_tree_page.h"
 
 namespace bustub {
@@ -56,4 +59,309 @@ auto BPlusTreePage::GetMinSize() const -> int {
     return max_size_/2;
 }
 
+/*****************************************************************************
+ * CELL AREA
+ *****************************************************************************/
+/*
+ * The cell area is addressed with offsets from the beginning of the page.
+ * Slots grow from the end of the prefix towards the end of the page, cells
+ * grow from the end of the page towards the slots.
+ */
+void BPlusTreePage::ResetCells(const BPlusTreeCellLayout &layout, const char *prefix, size_t prefix_len) {
+  BUSTUB_ASSERT(prefix_len <= layout.key_size_, "prefix longer than key");
+  auto *page_start = reinterpret_cast<char *>(this);
+  size_ = 0;
+  prefix_len_ = prefix_len;
+  cell_start_ = BUSTUB_PAGE_SIZE;
+  if (prefix_len > 0) {
+    memmove(page_start + layout.header_size_, prefix, prefix_len);
+  }
+}
+
+auto BPlusTreePage::GetPrefix(const BPlusTreeCellLayout &layout) const -> const char * {
+  return reinterpret_cast<const char *>(this) + layout.header_size_;
+}
+
+auto BPlusTreePage::SlotAt(const BPlusTreeCellLayout &layout, int index) const -> uint16_t {
+  uint16_t offset;
+  memcpy(&offset, GetPrefix(layout) + prefix_len_ + index * sizeof(uint16_t), sizeof(uint16_t));
+  return offset;
+}
+
+auto BPlusTreePage::CellLength(const BPlusTreeCellLayout &layout, uint16_t offset) const -> size_t {
+  const auto *cell = reinterpret_cast<const uint8_t *>(this) + offset;
+  return 2 + layout.key_size_ - cell[0] - cell[1] + layout.value_size_;
+}
+
+auto BPlusTreePage::EncodedLength(const BPlusTreeCellLayout &layout, const char *key, uint8_t *shared,
+                                  uint8_t *zeros) const -> size_t {
+  const char *prefix = GetPrefix(layout);
+  size_t shared_len = 0;
+  while (shared_len < prefix_len_ && key[shared_len] == prefix[shared_len]) {
+    ++shared_len;
+  }
+  size_t zero_len = 0;
+  while (shared_len + zero_len < layout.key_size_ && key[layout.key_size_ - zero_len - 1] == 0) {
+    ++zero_len;
+  }
+  *shared = shared_len;
+  *zeros = zero_len;
+  return 2 + layout.key_size_ - shared_len - zero_len + layout.value_size_;
+}
+
+auto BPlusTreePage::CellFootprint(const BPlusTreeCellLayout &layout, const char *key) const -> size_t {
+  uint8_t shared;
+  uint8_t zeros;
+  return sizeof(uint16_t) + EncodedLength(layout, key, &shared, &zeros);
+}
+
+auto BPlusTreePage::FreeBytes(const BPlusTreeCellLayout &layout) const -> size_t {
+  return cell_start_ - (layout.header_size_ + prefix_len_ + size_ * sizeof(uint16_t));
+}
+
+auto BPlusTreePage::LiveCellBytes(const BPlusTreeCellLayout &layout) const -> size_t {
+  size_t bytes = 0;
+  for (int i = 0; i < size_; i++) {
+    bytes += CellLength(layout, SlotAt(layout, i));
+  }
+  return bytes;
+}
+
+void BPlusTreePage::ReadCell(const BPlusTreeCellLayout &layout, int index, char *key, char *value) const {
+  const auto *cell = reinterpret_cast<const char *>(this) + SlotAt(layout, index);
+  auto shared = static_cast<uint8_t>(cell[0]);
+  auto zeros = static_cast<uint8_t>(cell[1]);
+  size_t stored = layout.key_size_ - shared - zeros;
+  if (key != nullptr) {
+    memcpy(key, GetPrefix(layout), shared);
+    memcpy(key + shared, cell + 2, stored);
+    memset(key + shared + stored, 0, zeros);
+  }
+  if (value != nullptr) {
+    memcpy(value, cell + 2 + stored, layout.value_size_);
+  }
+}
+
+void BPlusTreePage::WriteCellValue(const BPlusTreeCellLayout &layout, int index, const char *value) {
+  auto *cell = reinterpret_cast<char *>(this) + SlotAt(layout, index);
+  size_t stored = layout.key_size_ - static_cast<uint8_t>(cell[0]) - static_cast<uint8_t>(cell[1]);
+  memcpy(cell + 2 + stored, value, layout.value_size_);
+}
+
+auto BPlusTreePage::HasRoomForCell(const BPlusTreeCellLayout &layout, const char *key) const -> bool {
+  size_t footprint = CellFootprint(layout, key);
+  if (FreeBytes(layout) >= footprint) {
+    return true;
+  }
+  // removed cells leave holes that a compaction would give back
+  size_t used = layout.header_size_ + prefix_len_ + size_ * sizeof(uint16_t) + LiveCellBytes(layout);
+  return used + footprint <= BUSTUB_PAGE_SIZE;
+}
+
+auto BPlusTreePage::HasRoomForAnyCell(const BPlusTreeCellLayout &layout) const -> bool {
+  size_t footprint = sizeof(uint16_t) + 2 + layout.key_size_ + layout.value_size_;
+  if (FreeBytes(layout) >= footprint) {
+    return true;
+  }
+  size_t used = layout.header_size_ + prefix_len_ + size_ * sizeof(uint16_t) + LiveCellBytes(layout);
+  return used + footprint <= BUSTUB_PAGE_SIZE;
+}
+
+/*
+ * Rewrite all live cells contiguously at the end of the page, reclaiming the
+ * space of removed cells.
+ */
+void BPlusTreePage::CompactCells(const BPlusTreeCellLayout &layout) {
+  char buffer[BUSTUB_PAGE_SIZE];
+  auto *page_start = reinterpret_cast<char *>(this);
+  auto *slots = page_start + layout.header_size_ + prefix_len_;
+  size_t end = BUSTUB_PAGE_SIZE;
+  for (int i = 0; i < size_; i++) {
+    uint16_t offset = SlotAt(layout, i);
+    size_t length = CellLength(layout, offset);
+    end -= length;
+    memcpy(buffer + end, page_start + offset, length);
+    auto new_offset = static_cast<uint16_t>(end);
+    memcpy(slots + i * sizeof(uint16_t), &new_offset, sizeof(uint16_t));
+  }
+  memcpy(page_start + end, buffer + end, BUSTUB_PAGE_SIZE - end);
+  cell_start_ = end;
+}
+
+auto BPlusTreePage::InsertCell(const BPlusTreeCellLayout &layout, int index, const char *key, const char *value)
+    -> bool {
+  BUSTUB_ASSERT(index >= 0 && index <= size_, "slot index out of range");
+  uint8_t shared;
+  uint8_t zeros;
+  size_t length = EncodedLength(layout, key, &shared, &zeros);
+  if (FreeBytes(layout) < length + sizeof(uint16_t)) {
+    if (!HasRoomForCell(layout, key)) {
+      return false;
+    }
+    CompactCells(layout);
+  }
+
+  auto *page_start = reinterpret_cast<char *>(this);
+  cell_start_ -= length;
+  auto *cell = page_start + cell_start_;
+  size_t stored = layout.key_size_ - shared - zeros;
+  cell[0] = static_cast<char>(shared);
+  cell[1] = static_cast<char>(zeros);
+  memcpy(cell + 2, key + shared, stored);
+  memcpy(cell + 2 + stored, value, layout.value_size_);
+
+  auto *slots = page_start + layout.header_size_ + prefix_len_;
+  memmove(slots + (index + 1) * sizeof(uint16_t), slots + index * sizeof(uint16_t),
+          (size_ - index) * sizeof(uint16_t));
+  memcpy(slots + index * sizeof(uint16_t), &cell_start_, sizeof(uint16_t));
+  size_++;
+  return true;
+}
+
+void BPlusTreePage::RemoveCell(const BPlusTreeCellLayout &layout, int index) {
+  BUSTUB_ASSERT(index >= 0 && index < size_, "slot index out of range");
+  auto *slots = reinterpret_cast<char *>(this) + layout.header_size_ + prefix_len_;
+  uint16_t offset = SlotAt(layout, index);
+  if (offset == cell_start_) {
+    // the most recently written cell can be given back to the free space right away
+    cell_start_ += CellLength(layout, offset);
+  }
+  memmove(slots + index * sizeof(uint16_t), slots + (index + 1) * sizeof(uint16_t),
+          (size_ - index - 1) * sizeof(uint16_t));
+  size_--;
+}
+
+/*****************************************************************************
+ * SPLIT
+ *****************************************************************************/
+namespace {
+
+/* Bytes needed by entries [begin, end) when compressed against the given prefix, including prefix and slots. */
+auto RangeBytes(const BPlusTreeCellLayout &layout, const std::vector<const char *> &keys, size_t begin, size_t end,
+                const char *prefix, size_t prefix_len) -> size_t {
+  size_t bytes = prefix_len;
+  for (size_t i = begin; i < end; i++) {
+    const char *key = keys[i];
+    size_t shared = 0;
+    while (shared < prefix_len && key[shared] == prefix[shared]) {
+      ++shared;
+    }
+    size_t zeros = 0;
+    while (shared + zeros < layout.key_size_ && key[layout.key_size_ - zeros - 1] == 0) {
+      ++zeros;
+    }
+    bytes += sizeof(uint16_t) + 2 + layout.key_size_ - shared - zeros + layout.value_size_;
+  }
+  return bytes;
+}
+
+/* Length of the prefix shared by all keys in [begin, end). */
+auto CommonPrefixLen(const BPlusTreeCellLayout &layout, const std::vector<const char *> &keys, size_t begin,
+                     size_t end) -> size_t {
+  size_t len = layout.key_size_;
+  for (size_t i = begin + 1; i < end && len > 0; i++) {
+    size_t shared = 0;
+    while (shared < len && keys[i][shared] == keys[begin][shared]) {
+      ++shared;
+    }
+    len = shared;
+  }
+  return len;
+}
+
+/*
+ * The prefix for one half of a split is either the common prefix of that half or the prefix
+ * of the page being split, whichever takes fewer bytes. Keeping the old prefix guarantees that
+ * no cell grows, so a split point that fits both halves always exists.
+ */
+auto PickPrefix(const BPlusTreeCellLayout &layout, const std::vector<const char *> &keys, size_t begin, size_t end,
+                const char *old_prefix, size_t old_prefix_len, size_t *prefix_len, size_t *bytes) -> const char * {
+  size_t common_len = CommonPrefixLen(layout, keys, begin, end);
+  size_t common_bytes = RangeBytes(layout, keys, begin, end, keys[begin], common_len);
+  size_t old_bytes = RangeBytes(layout, keys, begin, end, old_prefix, old_prefix_len);
+  if (common_bytes <= old_bytes) {
+    *prefix_len = common_len;
+    *bytes = common_bytes;
+    return keys[begin];
+  }
+  *prefix_len = old_prefix_len;
+  *bytes = old_bytes;
+  return old_prefix;
+}
+
+}  // namespace
+
+auto BPlusTreePage::PlanSplit(const BPlusTreeCellLayout &layout, const std::vector<const char *> &keys) const
+    -> size_t {
+  size_t count = keys.size();
+  BUSTUB_ASSERT(count >= 2, "cannot split less than two entries");
+  size_t capacity = BUSTUB_PAGE_SIZE - layout.header_size_;
+  size_t mid = count / 2;
+  for (size_t distance = 0; distance < count; distance++) {
+    for (size_t split : {mid - distance, mid + distance}) {
+      if (split < 1 || split >= count) {
+        continue;
+      }
+      size_t prefix_len;
+      size_t left_bytes;
+      size_t right_bytes;
+      PickPrefix(layout, keys, 0, split, GetPrefix(layout), prefix_len_, &prefix_len, &left_bytes);
+      PickPrefix(layout, keys, split, count, GetPrefix(layout), prefix_len_, &prefix_len, &right_bytes);
+      if (left_bytes <= capacity && right_bytes <= capacity) {
+        return split;
+      }
+    }
+  }
+  UNREACHABLE("no split point fits both pages");
+}
+
+void BPlusTreePage::AssignCells(const BPlusTreeCellLayout &layout, const std::vector<const char *> &keys,
+                                const std::vector<const char *> &values, size_t begin, size_t end, const char *prefix,
+                                size_t prefix_len) {
+  ResetCells(layout, prefix, prefix_len);
+  for (size_t i = begin; i < end; i++) {
+    bool inserted = InsertCell(layout, size_, keys[i], values[i]);
+    BUSTUB_ASSERT(inserted, "split half does not fit into its page");
+  }
+}
+
+auto BPlusTreePage::SplitCells(const BPlusTreeCellLayout &layout, const std::vector<const char *> &keys,
+                               const std::vector<const char *> &values, BPlusTreePage *recipient) -> size_t {
+  size_t split = PlanSplit(layout, keys);
+  char old_prefix[BUSTUB_PAGE_SIZE];
+  size_t old_prefix_len = prefix_len_;
+  memcpy(old_prefix, GetPrefix(layout), old_prefix_len);
+
+  size_t prefix_len;
+  size_t bytes;
+  const char *prefix = PickPrefix(layout, keys, split, keys.size(), old_prefix, old_prefix_len, &prefix_len, &bytes);
+  recipient->AssignCells(layout, keys, values, split, keys.size(), prefix, prefix_len);
+  prefix = PickPrefix(layout, keys, 0, split, old_prefix, old_prefix_len, &prefix_len, &bytes);
+  AssignCells(layout, keys, values, 0, split, prefix, prefix_len);
+  return split;
+}
+
+/*****************************************************************************
+ * MERGE
+ *****************************************************************************/
+auto BPlusTreePage::MergeCells(const BPlusTreeCellLayout &layout, const std::vector<const char *> &keys,
+                               const std::vector<const char *> &values) -> bool {
+  if (keys.empty()) {
+    ResetCells(layout, nullptr, 0);
+    return true;
+  }
+  // every key shares the common prefix in full, so no other prefix takes fewer bytes
+  size_t prefix_len = CommonPrefixLen(layout, keys, 0, keys.size());
+  if (RangeBytes(layout, keys, 0, keys.size(), keys[0], prefix_len) > BUSTUB_PAGE_SIZE - layout.header_size_) {
+    return false;
+  }
+  AssignCells(layout, keys, values, 0, keys.size(), keys[0], prefix_len);
+  return true;
+}
+
+auto BPlusTreePage::CellAreaFill(const BPlusTreeCellLayout &layout) const -> double {
+  size_t used = prefix_len_ + size_ * sizeof(uint16_t) + LiveCellBytes(layout);
+  return static_cast<double>(used) / static_cast<double>(BUSTUB_PAGE_SIZE - layout.header_size_);
+}
+
 }  // namespace bustub
@@ -0,0 +1,125 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffered_tree_internal_page.cpp
+//
+// Identification: src/storage/page/buffered_tree_internal_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/buffered_tree_internal_page.h"
+
+namespace bustub {
+
+/*
+ * Init method after creating a new internal page. The message buffer gets the
+ * space that max_size children leave.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BUFFERED_TREE_INTERNAL_PAGE_TYPE::Init(int max_size) {
+  SetPageType(IndexPageType::INTERNAL_PAGE);
+  SetSize(0);
+  SetMaxSize(max_size);
+  buffer_size_ = 0;
+  buffer_max_size_ = (BUSTUB_PAGE_SIZE - BUFFERED_TREE_INTERNAL_PAGE_HEADER_SIZE -
+                      max_size * (sizeof(MappingType) + sizeof(page_id_t))) /
+                     sizeof(Message);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BUFFERED_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType { return Pivots()[index].first; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BUFFERED_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return Pivots()[index].second; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BUFFERED_TREE_INTERNAL_PAGE_TYPE::ChildAt(int index) const -> page_id_t { return Children()[index]; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BUFFERED_TREE_INTERNAL_PAGE_TYPE::ChildIndex(const KeyType &key, const ValueType &value,
+                                                  const KeyComparator &comparator) const -> int {
+  // the first pivot above (key, value) bounds the child from above
+  auto it = std::upper_bound(Pivots() + 1, Pivots() + GetSize(), key, [&](const KeyType &k, const MappingType &pivot) {
+    int result = comparator(k, pivot.first);
+    return result < 0 || (result == 0 && CompareRid(value, pivot.second) < 0);
+  });
+  return static_cast<int>(it - Pivots()) - 1;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BUFFERED_TREE_INTERNAL_PAGE_TYPE::InsertChild(int index, const KeyType &key, const ValueType &value,
+                                                   page_id_t child) {
+  std::move_backward(Pivots() + index, Pivots() + GetSize(), Pivots() + GetSize() + 1);
+  std::move_backward(Children() + index, Children() + GetSize(), Children() + GetSize() + 1);
+  Pivots()[index] = MappingType(key, value);
+  Children()[index] = child;
+  IncreaseSize(1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BUFFERED_TREE_INTERNAL_PAGE_TYPE::MessageAt(int index) const -> const Message & { return Messages()[index]; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void BUFFERED_TREE_INTERNAL_PAGE_TYPE::AppendMessage(const Message &message) {
+  Messages()[buffer_size_++] = message;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BUFFERED_TREE_INTERNAL_PAGE_TYPE::BusiestChild(const KeyComparator &comparator) const -> int {
+  std::vector<int> counts(GetSize(), 0);
+  for (int i = 0; i < buffer_size_; i++) {
+    ++counts[ChildIndex(Messages()[i].key_, Messages()[i].value_, comparator)];
+  }
+  return static_cast<int>(std::max_element(counts.begin(), counts.end()) - counts.begin());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BUFFERED_TREE_INTERNAL_PAGE_TYPE::TakeMessages(int index, size_t limit, const KeyComparator &comparator,
+                                                    std::vector<Message> *messages) {
+  int kept = 0;
+  size_t taken = 0;
+  for (int i = 0; i < buffer_size_; i++) {
+    const Message &message = Messages()[i];
+    if (taken < limit && ChildIndex(message.key_, message.value_, comparator) == index) {
+      messages->push_back(message);
+      ++taken;
+    } else {
+      Messages()[kept++] = message;
+    }
+  }
+  buffer_size_ = kept;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BUFFERED_TREE_INTERNAL_PAGE_TYPE::MoveHalfTo(BufferedTreeInternalPage *recipient,
+                                                  const KeyComparator &comparator) -> MappingType {
+  int keep = GetSize() / 2;
+  MappingType separator = Pivots()[keep];
+  std::copy(Pivots() + keep, Pivots() + GetSize(), recipient->Pivots());
+  std::copy(Children() + keep, Children() + GetSize(), recipient->Children());
+  recipient->SetSize(GetSize() - keep);
+  SetSize(keep);
+
+  int kept = 0;
+  for (int i = 0; i < buffer_size_; i++) {
+    const Message &message = Messages()[i];
+    int result = comparator(message.key_, separator.first);
+    if (result < 0 || (result == 0 && CompareRid(message.value_, separator.second) < 0)) {
+      Messages()[kept++] = message;
+    } else {
+      recipient->AppendMessage(message);
+    }
+  }
+  buffer_size_ = kept;
+  return separator;
+}
+
+template class BufferedTreeInternalPage<GenericKey<4>, RID, GenericComparator<4>>;
+template class BufferedTreeInternalPage<GenericKey<8>, RID, GenericComparator<8>>;
+template class BufferedTreeInternalPage<GenericKey<16>, RID, GenericComparator<16>>;
+template class BufferedTreeInternalPage<GenericKey<32>, RID, GenericComparator<32>>;
+template class BufferedTreeInternalPage<GenericKey<64>, RID, GenericComparator<64>>;
+template class BufferedTreeInternalPage<GenericKey<128>, RID, GenericComparator<128>>;
+
+}  // namespace bustub
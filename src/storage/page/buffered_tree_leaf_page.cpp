@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffered_tree_leaf_page.cpp
+//
+// Identification: src/storage/page/buffered_tree_leaf_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+
+#include "storage/page/buffered_tree_leaf_page.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+void BUFFERED_TREE_LEAF_PAGE_TYPE::Init(int max_size) {
+  SetPageType(IndexPageType::LEAF_PAGE);
+  SetSize(0);
+  SetMaxSize(max_size);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BUFFERED_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType { return array_[index].first; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BUFFERED_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType { return array_[index].second; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BUFFERED_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int {
+  auto it = std::lower_bound(array_, array_ + GetSize(), key,
+                             [&](const MappingType &entry, const KeyType &k) { return comparator(entry.first, k) < 0; });
+  return static_cast<int>(it - array_);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BUFFERED_TREE_LEAF_PAGE_TYPE::EntryIndex(const KeyType &key, const ValueType &value,
+                                              const KeyComparator &comparator) const -> int {
+  auto it = std::lower_bound(array_, array_ + GetSize(), key, [&](const MappingType &entry, const KeyType &k) {
+    int result = comparator(entry.first, k);
+    return result < 0 || (result == 0 && CompareRid(entry.second, value) < 0);
+  });
+  return static_cast<int>(it - array_);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BUFFERED_TREE_LEAF_PAGE_TYPE::Apply(const Message &message, const KeyComparator &comparator) -> bool {
+  int index = EntryIndex(message.key_, message.value_, comparator);
+  bool found = index < GetSize() && comparator(array_[index].first, message.key_) == 0 &&
+               array_[index].second == message.value_;
+  if (message.op_ == BufferedTreeOp::DELETE) {
+    if (found) {
+      std::move(array_ + index + 1, array_ + GetSize(), array_ + index);
+      IncreaseSize(-1);
+    }
+    return true;
+  }
+  if (found) {
+    return true;
+  }
+  if (GetSize() >= GetMaxSize()) {
+    return false;
+  }
+  std::move_backward(array_ + index, array_ + GetSize(), array_ + GetSize() + 1);
+  array_[index] = MappingType(message.key_, message.value_);
+  IncreaseSize(1);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BUFFERED_TREE_LEAF_PAGE_TYPE::MoveHalfTo(BufferedTreeLeafPage *recipient) {
+  int keep = GetSize() / 2;
+  std::copy(array_ + keep, array_ + GetSize(), recipient->array_);
+  recipient->SetSize(GetSize() - keep);
+  SetSize(keep);
+}
+
+template class BufferedTreeLeafPage<GenericKey<4>, RID, GenericComparator<4>>;
+template class BufferedTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
+template class BufferedTreeLeafPage<GenericKey<16>, RID, GenericComparator<16>>;
+template class BufferedTreeLeafPage<GenericKey<32>, RID, GenericComparator<32>>;
+template class BufferedTreeLeafPage<GenericKey<64>, RID, GenericComparator<64>>;
+template class BufferedTreeLeafPage<GenericKey<128>, RID, GenericComparator<128>>;
+
+}  // namespace bustub
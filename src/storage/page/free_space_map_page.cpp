@@ -0,0 +1,44 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map_page.cpp
+//
+// Identification: src/storage/page/free_space_map_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/free_space_map_page.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+void FreeSpaceMapPage::Init() {
+  next_page_id_ = INVALID_PAGE_ID;
+  size_ = 0;
+}
+
+auto FreeSpaceMapPage::PageIdAt(uint32_t index) const -> page_id_t {
+  BUSTUB_ASSERT(index < size_, "index out of range");
+  return page_ids_[index];
+}
+
+auto FreeSpaceMapPage::SpaceClassAt(uint32_t index) const -> uint8_t {
+  BUSTUB_ASSERT(index < size_, "index out of range");
+  return space_classes_[index];
+}
+
+void FreeSpaceMapPage::SetSpaceClassAt(uint32_t index, uint8_t space_class) {
+  BUSTUB_ASSERT(index < size_, "index out of range");
+  space_classes_[index] = space_class;
+}
+
+void FreeSpaceMapPage::Append(page_id_t page_id, uint8_t space_class) {
+  BUSTUB_ASSERT(!IsFull(), "free space map page is full");
+  page_ids_[size_] = page_id;
+  space_classes_[size_] = space_class;
+  size_++;
+}
+
+}  // namespace bustub
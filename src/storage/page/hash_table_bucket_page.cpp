@@ -11,7 +11,18 @@
 //===----------------------------------------------------------------------===//
 
 #include "storage/page/hash_table_bucket_page.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+
 #include "common/logger.h"
+#include "container/hash/hash_function.h"
 #include "common/util/hash_util.h"
 #include "storage/index/generic_key.h"
 #include "storage/index/hash_comparator.h"
@@ -20,66 +31,164 @@
 namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) -> bool {
-  return false;
+void HASH_TABLE_BUCKET_TYPE::Init() {
+  static_assert(offsetof(HASH_TABLE_BUCKET_TYPE, array_) + BUCKET_ARRAY_SIZE * sizeof(MappingType) <= BUSTUB_PAGE_SIZE);
+  overflow_page_id_ = INVALID_PAGE_ID;
+}
+
+/*
+ * Slots are taken front to back and a removed pair only leaves a tombstone, so
+ * the occupied slots form a prefix of the bucket and probes stop at the first
+ * group without an occupied slot.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) const -> bool {
+  uint8_t fingerprint = Fingerprint(key);
+  bool found = false;
+  for (uint32_t group = 0; group < BUCKET_GROUP_COUNT && GroupMask(occupied_, group) != 0; group++) {
+    for (uint32_t matches = MatchGroup(group, fingerprint); matches != 0; matches &= matches - 1) {
+      uint32_t bucket_idx = group * BUCKET_GROUP_SIZE + __builtin_ctz(matches);
+      if (cmp(array_[bucket_idx].first, key) == 0) {
+        result->push_back(array_[bucket_idx].second);
+        found = true;
+      }
+    }
+  }
+  return found;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::Insert(KeyType key, ValueType value, KeyComparator cmp) -> bool {
+  uint8_t fingerprint = Fingerprint(key);
+  // the first free slot, a tombstone or the end of the occupied prefix
+  uint32_t free_idx = BUCKET_ARRAY_SIZE;
+  for (uint32_t group = 0; group < BUCKET_GROUP_COUNT; group++) {
+    uint32_t free_slots = ~GroupMask(readable_, group) & ((1U << BUCKET_GROUP_SIZE) - 1);
+    if (free_slots != 0) {
+      free_idx = std::min<uint32_t>(free_idx, group * BUCKET_GROUP_SIZE + __builtin_ctz(free_slots));
+    }
+    if (GroupMask(occupied_, group) == 0) {
+      break;
+    }
+    for (uint32_t matches = MatchGroup(group, fingerprint); matches != 0; matches &= matches - 1) {
+      uint32_t bucket_idx = group * BUCKET_GROUP_SIZE + __builtin_ctz(matches);
+      if (cmp(array_[bucket_idx].first, key) == 0 && array_[bucket_idx].second == value) {
+        return false;
+      }
+    }
+  }
+  if (free_idx >= BUCKET_ARRAY_SIZE) {
+    return false;
+  }
+  array_[free_idx] = MappingType(key, value);
+  fingerprints_[free_idx] = fingerprint;
+  SetOccupied(free_idx);
+  SetReadable(free_idx);
   return true;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::Remove(KeyType key, ValueType value, KeyComparator cmp) -> bool {
+  uint8_t fingerprint = Fingerprint(key);
+  for (uint32_t group = 0; group < BUCKET_GROUP_COUNT && GroupMask(occupied_, group) != 0; group++) {
+    for (uint32_t matches = MatchGroup(group, fingerprint); matches != 0; matches &= matches - 1) {
+      uint32_t bucket_idx = group * BUCKET_GROUP_SIZE + __builtin_ctz(matches);
+      if (cmp(array_[bucket_idx].first, key) == 0 && array_[bucket_idx].second == value) {
+        RemoveAt(bucket_idx);
+        return true;
+      }
+    }
+  }
   return false;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::KeyAt(uint32_t bucket_idx) const -> KeyType {
-  return {};
+  return array_[bucket_idx].first;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::ValueAt(uint32_t bucket_idx) const -> ValueType {
-  return {};
+  return array_[bucket_idx].second;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::RemoveAt(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::RemoveAt(uint32_t bucket_idx) {
+  readable_[bucket_idx / 8] &= static_cast<char>(~(1 << (bucket_idx % 8)));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsOccupied(uint32_t bucket_idx) const -> bool {
-  return false;
+  return (occupied_[bucket_idx / 8] & (1 << (bucket_idx % 8))) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::SetOccupied(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::SetOccupied(uint32_t bucket_idx) {
+  occupied_[bucket_idx / 8] |= static_cast<char>(1 << (bucket_idx % 8));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsReadable(uint32_t bucket_idx) const -> bool {
-  return false;
+  return (readable_[bucket_idx / 8] & (1 << (bucket_idx % 8))) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::SetReadable(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::SetReadable(uint32_t bucket_idx) {
+  readable_[bucket_idx / 8] |= static_cast<char>(1 << (bucket_idx % 8));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::IsFull() -> bool {
-  return false;
+auto HASH_TABLE_BUCKET_TYPE::IsFull() const -> bool {
+  return NumReadable() == BUCKET_ARRAY_SIZE;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::NumReadable() -> uint32_t {
-  return 0;
+auto HASH_TABLE_BUCKET_TYPE::NumReadable() const -> uint32_t {
+  uint32_t count = 0;
+  for (char bits : readable_) {
+    count += __builtin_popcount(static_cast<unsigned char>(bits));
+  }
+  return count;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::IsEmpty() -> bool {
-  return false;
+auto HASH_TABLE_BUCKET_TYPE::IsEmpty() const -> bool {
+  return std::all_of(std::begin(readable_), std::end(readable_), [](char bits) { return bits == 0; });
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::Fingerprint(KeyType key) -> uint8_t {
+  // the extendible hash table takes the low bits of the hash for the directory
+  return static_cast<uint8_t>(HashFunction<KeyType>().GetHash(key) >> 56);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::MatchGroup(uint32_t group, uint8_t fingerprint) const -> uint32_t {
+  const uint8_t *fingerprints = fingerprints_ + group * BUCKET_GROUP_SIZE;
+#if defined(__SSE2__)
+  __m128i probe = _mm_set1_epi8(static_cast<char>(fingerprint));
+  __m128i slots = _mm_loadu_si128(reinterpret_cast<const __m128i *>(fingerprints));
+  auto matches = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(slots, probe)));
+#else
+  uint32_t matches = 0;
+  for (uint32_t i = 0; i < BUCKET_GROUP_SIZE; i++) {
+    matches |= static_cast<uint32_t>(fingerprints[i] == fingerprint) << i;
+  }
+#endif
+  return matches & GroupMask(readable_, group);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::GroupMask(const char *bitmap, uint32_t group) -> uint32_t {
+  static_assert(BUCKET_GROUP_SIZE == 8 * sizeof(uint16_t));
+  // the bitmaps are little endian: slot i is bit i % 8 of byte i / 8
+  uint16_t mask;
+  std::memcpy(&mask, bitmap + group * BUCKET_GROUP_SIZE / 8, sizeof(mask));
+  return mask;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::PrintBucket() {
+void HASH_TABLE_BUCKET_TYPE::PrintBucket() const {
   uint32_t size = 0;
   uint32_t taken = 0;
   uint32_t free = 0;
@@ -108,6 +217,7 @@ template class HashTableBucketPage<GenericKey<8>, RID, GenericComparator<8>>;
 template class HashTableBucketPage<GenericKey<16>, RID, GenericComparator<16>>;
 template class HashTableBucketPage<GenericKey<32>, RID, GenericComparator<32>>;
 template class HashTableBucketPage<GenericKey<64>, RID, GenericComparator<64>>;
+template class HashTableBucketPage<GenericKey<128>, RID, GenericComparator<128>>;
 
 // template class HashTableBucketPage<hash_t, TmpTuple, HashComparator>;
 
@@ -24,31 +24,59 @@ auto HashTableDirectoryPage::GetLSN() const -> lsn_t { return lsn_; }
 
 void HashTableDirectoryPage::SetLSN(lsn_t lsn) { lsn_ = lsn; }
 
-auto HashTableDirectoryPage::GetGlobalDepth() -> uint32_t { return global_depth_; }
+auto HashTableDirectoryPage::GetGlobalDepth() const -> uint32_t { return global_depth_; }
 
-auto HashTableDirectoryPage::GetGlobalDepthMask() -> uint32_t { return 0; }
+auto HashTableDirectoryPage::GetGlobalDepthMask() const -> uint32_t { return (1U << global_depth_) - 1; }
 
-void HashTableDirectoryPage::IncrGlobalDepth() {}
+void HashTableDirectoryPage::IncrGlobalDepth() {
+  assert(Size() * 2 <= DIRECTORY_ARRAY_SIZE);
+  uint32_t size = Size();
+  std::copy(local_depths_, local_depths_ + size, local_depths_ + size);
+  std::copy(bucket_page_ids_, bucket_page_ids_ + size, bucket_page_ids_ + size);
+  global_depth_++;
+}
 
 void HashTableDirectoryPage::DecrGlobalDepth() { global_depth_--; }
 
-auto HashTableDirectoryPage::GetBucketPageId(uint32_t bucket_idx) -> page_id_t { return 0; }
+auto HashTableDirectoryPage::GetBucketPageId(uint32_t bucket_idx) const -> page_id_t {
+  return bucket_page_ids_[bucket_idx];
+}
 
-void HashTableDirectoryPage::SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id) {}
+void HashTableDirectoryPage::SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id) {
+  bucket_page_ids_[bucket_idx] = bucket_page_id;
+}
 
-auto HashTableDirectoryPage::Size() -> uint32_t { return 0; }
+auto HashTableDirectoryPage::GetSplitImageIndex(uint32_t bucket_idx) const -> uint32_t {
+  return bucket_idx ^ GetLocalHighBit(bucket_idx);
+}
 
-auto HashTableDirectoryPage::CanShrink() -> bool { return false; }
+auto HashTableDirectoryPage::Size() const -> uint32_t { return 1U << global_depth_; }
 
-auto HashTableDirectoryPage::GetLocalDepth(uint32_t bucket_idx) -> uint32_t { return 0; }
+auto HashTableDirectoryPage::CanShrink() const -> bool {
+  if (global_depth_ == 0) {
+    return false;
+  }
+  return std::all_of(local_depths_, local_depths_ + Size(), [&](uint8_t depth) { return depth < global_depth_; });
+}
 
-void HashTableDirectoryPage::SetLocalDepth(uint32_t bucket_idx, uint8_t local_depth) {}
+auto HashTableDirectoryPage::GetLocalDepth(uint32_t bucket_idx) const -> uint32_t { return local_depths_[bucket_idx]; }
 
-void HashTableDirectoryPage::IncrLocalDepth(uint32_t bucket_idx) {}
+auto HashTableDirectoryPage::GetLocalDepthMask(uint32_t bucket_idx) const -> uint32_t {
+  return (1U << local_depths_[bucket_idx]) - 1;
+}
+
+void HashTableDirectoryPage::SetLocalDepth(uint32_t bucket_idx, uint8_t local_depth) {
+  local_depths_[bucket_idx] = local_depth;
+}
 
-void HashTableDirectoryPage::DecrLocalDepth(uint32_t bucket_idx) {}
+void HashTableDirectoryPage::IncrLocalDepth(uint32_t bucket_idx) { local_depths_[bucket_idx]++; }
 
-auto HashTableDirectoryPage::GetLocalHighBit(uint32_t bucket_idx) -> uint32_t { return 0; }
+void HashTableDirectoryPage::DecrLocalDepth(uint32_t bucket_idx) { local_depths_[bucket_idx]--; }
+
+auto HashTableDirectoryPage::GetLocalHighBit(uint32_t bucket_idx) const -> uint32_t {
+  uint32_t local_depth = local_depths_[bucket_idx];
+  return local_depth == 0 ? 0 : 1U << (local_depth - 1);
+}
 
 /**
  * VerifyIntegrity - Use this for debugging but **DO NOT CHANGE**
@@ -60,7 +88,7 @@ auto HashTableDirectoryPage::GetLocalHighBit(uint32_t bucket_idx) -> uint32_t {
  * (2) Each bucket has precisely 2^(GD - LD) pointers pointing to it.
  * (3) The LD is the same at each index with the same bucket_page_id
  */
-void HashTableDirectoryPage::VerifyIntegrity() {
+void HashTableDirectoryPage::VerifyIntegrity() const {
   //  build maps of {bucket_page_id : pointer_count} and {bucket_page_id : local_depth}
   std::unordered_map<page_id_t, uint32_t> page_id_to_count = std::unordered_map<page_id_t, uint32_t>();
   std::unordered_map<page_id_t, uint32_t> page_id_to_ld = std::unordered_map<page_id_t, uint32_t>();
@@ -102,7 +130,7 @@ void HashTableDirectoryPage::VerifyIntegrity() {
   }
 }
 
-void HashTableDirectoryPage::PrintDirectory() {
+void HashTableDirectoryPage::PrintDirectory() const {
   LOG_DEBUG("======== DIRECTORY (global_depth_: %u) ========", global_depth_);
   LOG_DEBUG("| bucket_idx | page_id | local_depth |");
   for (uint32_t idx = 0; idx < static_cast<uint32_t>(0x1 << global_depth_); idx++) {
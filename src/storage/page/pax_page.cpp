@@ -0,0 +1,625 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_page.cpp
+//
+// Identification: src/storage/page/pax_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/pax_page.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "common/exception.h"
+#include "storage/page/overflow_page.h"
+#include "storage/table/free_space_map.h"
+#include "storage/table/toast_store.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the bytes of the varchar value of a column in the tuple data, as stored in the page */
+auto VarcharSize(const char *data, const Column &column) -> uint32_t {
+  uint32_t offset = *reinterpret_cast<const uint32_t *>(data + column.GetOffset());
+  uint32_t length = *reinterpret_cast<const uint32_t *>(data + offset);
+  if (length == BUSTUB_VALUE_NULL) {
+    return sizeof(uint32_t);
+  }
+  return (length & TOAST_FLAG) != 0 ? TOAST_POINTER_SIZE : sizeof(uint32_t) + length;
+}
+
+/** @return the varchar value of a column in the tuple data, its length and its characters */
+auto VarcharData(const char *data, const Column &column) -> const char * {
+  return data + *reinterpret_cast<const uint32_t *>(data + column.GetOffset());
+}
+
+auto IsIntegerType(TypeId type) -> bool {
+  return type == TypeId::SMALLINT || type == TypeId::INTEGER || type == TypeId::BIGINT || type == TypeId::TIMESTAMP;
+}
+
+auto ToInt64(const Value &value) -> int64_t {
+  switch (value.GetTypeId()) {
+    case TypeId::TINYINT:
+      return value.GetAs<int8_t>();
+    case TypeId::SMALLINT:
+      return value.GetAs<int16_t>();
+    case TypeId::INTEGER:
+      return value.GetAs<int32_t>();
+    default:
+      return value.GetAs<int64_t>();
+  }
+}
+
+auto FromInt64(TypeId type, int64_t value) -> Value {
+  switch (type) {
+    case TypeId::SMALLINT:
+      return ValueFactory::GetSmallIntValue(static_cast<int16_t>(value));
+    case TypeId::INTEGER:
+      return ValueFactory::GetIntegerValue(static_cast<int32_t>(value));
+    case TypeId::TIMESTAMP:
+      return ValueFactory::GetTimestampValue(value);
+    default:
+      return ValueFactory::GetBigIntValue(value);
+  }
+}
+
+/** @return whether a difference to the base fits in a code of width bytes */
+auto FitsCode(int64_t delta, uint8_t width) -> bool {
+  if (width >= sizeof(int64_t)) {
+    return true;
+  }
+  int64_t bound = int64_t{1} << (8 * width - 1);
+  return delta >= -bound && delta < bound;
+}
+
+void WriteCode(char *code, int64_t delta, uint8_t width) {
+  switch (width) {
+    case 1:
+      *reinterpret_cast<int8_t *>(code) = static_cast<int8_t>(delta);
+      break;
+    case 2:
+      *reinterpret_cast<int16_t *>(code) = static_cast<int16_t>(delta);
+      break;
+    case 4:
+      *reinterpret_cast<int32_t *>(code) = static_cast<int32_t>(delta);
+      break;
+    default:
+      *reinterpret_cast<int64_t *>(code) = delta;
+  }
+}
+
+auto ReadCode(const char *code, uint8_t width) -> int64_t {
+  switch (width) {
+    case 1:
+      return *reinterpret_cast<const int8_t *>(code);
+    case 2:
+      return *reinterpret_cast<const int16_t *>(code);
+    case 4:
+      return *reinterpret_cast<const int32_t *>(code);
+    default:
+      return *reinterpret_cast<const int64_t *>(code);
+  }
+}
+
+/** @return the encoding of a column whose values are stored as in a tuple */
+auto PlainEncoding(const Column &column) -> PaxColumnEncoding {
+  PaxColumnEncoding encoding{};
+  encoding.encoding_ = PaxEncoding::Plain;
+  encoding.width_ = column.GetFixedLength();
+  return encoding;
+}
+
+/** @return the encoding a column of an empty page starts out with */
+auto InitialEncoding(const Column &column) -> PaxColumnEncoding {
+  PaxColumnEncoding encoding{};
+  if (!column.IsInlined()) {
+    encoding.encoding_ = PaxEncoding::Dictionary;
+    encoding.width_ = sizeof(uint16_t) * 2;
+  } else if (IsIntegerType(column.GetType())) {
+    encoding.encoding_ = PaxEncoding::FrameOfReference;
+    encoding.width_ = column.GetFixedLength() / 2;
+  } else {
+    encoding = PlainEncoding(column);
+  }
+  return encoding;
+}
+
+}  // namespace
+
+void PaxPage::Init(const Schema &schema) {
+  std::vector<PaxColumnEncoding> encodings;
+  for (const auto &column : schema.GetColumns()) {
+    encodings.push_back(InitialEncoding(column));
+  }
+  next_page_id_ = INVALID_PAGE_ID;
+  num_tuples_ = 0;
+  num_deleted_tuples_ = 0;
+  capacity_ = ComputeCapacity(schema, encodings, BUSTUB_PAGE_SIZE - PAX_PAGE_HEADER_SIZE, true);
+  free_space_pointer_ = BUSTUB_PAGE_SIZE;
+  flags_ = 0;
+  std::copy(encodings.begin(), encodings.end(), Encodings());
+  fixed_end_ = ColumnStart(schema, schema.GetColumnCount());
+  memset(page_start_ + ColumnStart(schema, 0), 0, fixed_end_ - ColumnStart(schema, 0));
+}
+
+auto PaxPage::GetFreeSpace() const -> size_t {
+  if (num_tuples_ == capacity_ || (flags_ & PAX_PAGE_CLOSED) != 0) {
+    return 0;
+  }
+  return FREE_SPACE_CLASS_SIZE + free_space_pointer_ - fixed_end_;
+}
+
+auto PaxPage::GetTupleSpace(const Tuple &tuple, const Schema &schema) -> size_t {
+  size_t space = FREE_SPACE_CLASS_SIZE;
+  for (auto column_idx : schema.GetUnlinedColumns()) {
+    space += VarcharSize(tuple.data_.data(), schema.GetColumn(column_idx));
+  }
+  return space;
+}
+
+auto PaxPage::InsertTuple(const TupleMeta &meta, const Tuple &tuple, const Schema &schema)
+    -> std::optional<uint16_t> {
+  if (num_tuples_ == capacity_ || (flags_ & PAX_PAGE_CLOSED) != 0) {
+    return std::nullopt;
+  }
+
+  // an integer out of the range of the codes of its column makes the column plain, in a page with fewer rows
+  std::vector<PaxColumnEncoding> encodings(Encodings(), Encodings() + schema.GetColumnCount());
+  bool relayout = false;
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    const auto &column = schema.GetColumn(i);
+    if (encodings[i].encoding_ == PaxEncoding::FrameOfReference) {
+      auto value = tuple.GetValue(&schema, i);
+      if (!value.IsNull() && !Fits(i, value)) {
+        encodings[i] = PlainEncoding(column);
+        relayout = true;
+      }
+    }
+  }
+  if (relayout && !Relayout(schema, encodings, num_tuples_ + 1)) {
+    flags_ |= PAX_PAGE_CLOSED;
+    return std::nullopt;
+  }
+
+  // a varchar some tuple in the page has takes no room
+  std::vector<std::optional<uint16_t>> shared(schema.GetColumnCount());
+  size_t varlen_size = 0;
+  for (auto column_idx : schema.GetUnlinedColumns()) {
+    const auto &column = schema.GetColumn(column_idx);
+    auto size = VarcharSize(tuple.data_.data(), column);
+    shared[column_idx] = FindVarchar(schema, column_idx, VarcharData(tuple.data_.data(), column), size);
+    varlen_size += shared[column_idx].has_value() ? 0 : size;
+  }
+  if (varlen_size > static_cast<size_t>(free_space_pointer_ - fixed_end_)) {
+    return std::nullopt;
+  }
+
+  auto slot = num_tuples_;
+  Metas()[slot] = meta;
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    const auto &column = schema.GetColumn(i);
+    if (column.IsInlined()) {
+      auto value = tuple.GetValue(&schema, i);
+      SetNull(schema, i, slot, value.IsNull());
+      if (value.IsNull()) {
+        memset(ValueAt(schema, i, slot), 0, Encodings()[i].width_);
+      } else {
+        WriteFixed(schema, i, slot, value);
+      }
+      continue;
+    }
+    auto size = VarcharSize(tuple.data_.data(), column);
+    const char *data = VarcharData(tuple.data_.data(), column);
+    SetNull(schema, i, slot, *reinterpret_cast<const uint32_t *>(data) == BUSTUB_VALUE_NULL);
+    if (!shared[i].has_value()) {
+      free_space_pointer_ -= size;
+      memcpy(page_start_ + free_space_pointer_, data, size);
+      shared[i] = free_space_pointer_;
+    }
+    *reinterpret_cast<VarEntry *>(ValueAt(schema, i, slot)) = VarEntry(*shared[i], size);
+  }
+  num_tuples_++;
+  return slot;
+}
+
+void PaxPage::UpdateTupleMeta(const TupleMeta &meta, const RID &rid, const Schema &schema) {
+  auto slot = rid.GetSlotNum();
+  if (slot >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  auto &old_meta = Metas()[slot];
+  if (old_meta.is_deleted_ && !meta.is_deleted_) {
+    // vacuum leaves the varchars of a tuple it dropped pointing past the page, the fixed-size values stay
+    for (auto column_idx : schema.GetUnlinedColumns()) {
+      if (reinterpret_cast<const VarEntry *>(ValueAt(schema, column_idx, slot))->first == BUSTUB_PAGE_SIZE) {
+        throw bustub::Exception("Tuple was vacuumed");
+      }
+    }
+    num_deleted_tuples_--;
+  }
+  if (!old_meta.is_deleted_ && meta.is_deleted_) {
+    num_deleted_tuples_++;
+  }
+  old_meta = meta;
+}
+
+auto PaxPage::GetTuple(const RID &rid, const Schema &schema) const -> std::pair<TupleMeta, Tuple> {
+  auto slot = rid.GetSlotNum();
+  if (slot >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  // the fixed part of the tuple, then the varlen values in column order, as the Tuple constructor lays them out
+  uint32_t size = schema.GetLength();
+  for (auto column_idx : schema.GetUnlinedColumns()) {
+    size += reinterpret_cast<const VarEntry *>(ValueAt(schema, column_idx, slot))->second;
+  }
+  Tuple tuple(rid);
+  tuple.data_.resize(size);
+  uint32_t offset = schema.GetLength();
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    const auto &column = schema.GetColumn(i);
+    const char *value = ValueAt(schema, i, slot);
+    char *field = tuple.data_.data() + column.GetOffset();
+    if (!column.IsInlined()) {
+      auto [var_offset, var_size] = *reinterpret_cast<const VarEntry *>(value);
+      *reinterpret_cast<uint32_t *>(field) = offset;
+      memcpy(tuple.data_.data() + offset, page_start_ + var_offset, var_size);
+      offset += var_size;
+    } else if (Encodings()[i].encoding_ == PaxEncoding::Plain) {
+      memcpy(field, value, column.GetFixedLength());
+    } else if (IsNull(schema, i, slot)) {
+      ValueFactory::GetNullValueByType(column.GetType()).SerializeTo(field);
+    } else {
+      ReadFixed(schema, i, slot).SerializeTo(field);
+    }
+  }
+  return std::make_pair(Metas()[slot], std::move(tuple));
+}
+
+auto PaxPage::GetTupleMeta(const RID &rid) const -> TupleMeta {
+  auto slot = rid.GetSlotNum();
+  if (slot >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  return Metas()[slot];
+}
+
+void PaxPage::UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid, const Schema &schema) {
+  auto slot = rid.GetSlotNum();
+  if (slot >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+
+  // find a place for every varchar before anything is changed, a value that has none yet goes to the free space
+  std::vector<VarEntry> entries(schema.GetColumnCount());
+  size_t varlen_size = 0;
+  for (auto column_idx : schema.GetUnlinedColumns()) {
+    const auto &column = schema.GetColumn(column_idx);
+    auto size = VarcharSize(tuple.data_.data(), column);
+    const char *data = VarcharData(tuple.data_.data(), column);
+    auto old_entry = *reinterpret_cast<const VarEntry *>(ValueAt(schema, column_idx, slot));
+    if (old_entry.second == size && memcmp(page_start_ + old_entry.first, data, size) == 0) {
+      entries[column_idx] = old_entry;
+    } else if (auto offset = FindVarchar(schema, column_idx, data, size); offset.has_value()) {
+      entries[column_idx] = VarEntry(*offset, size);
+    } else if (old_entry.second == size && !IsVarcharShared(schema, column_idx, slot, old_entry.first)) {
+      entries[column_idx] = old_entry;
+    } else {
+      entries[column_idx] = VarEntry(0, size);
+      varlen_size += size;
+    }
+  }
+  std::vector<PaxColumnEncoding> encodings(Encodings(), Encodings() + schema.GetColumnCount());
+  bool relayout = false;
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    if (encodings[i].encoding_ == PaxEncoding::FrameOfReference) {
+      auto value = tuple.GetValue(&schema, i);
+      if (!value.IsNull() && !Fits(i, value)) {
+        encodings[i] = PlainEncoding(schema.GetColumn(i));
+        relayout = true;
+      }
+    }
+  }
+  if (relayout && !Relayout(schema, encodings, num_tuples_)) {
+    throw bustub::Exception("Tuple does not fit in the page");
+  }
+  if (varlen_size > static_cast<size_t>(free_space_pointer_ - fixed_end_)) {
+    throw bustub::Exception("Tuple does not fit in the page");
+  }
+  // the old values left behind are dropped by the next vacuum
+  for (auto column_idx : schema.GetUnlinedColumns()) {
+    if (entries[column_idx].first == 0) {
+      free_space_pointer_ -= entries[column_idx].second;
+      entries[column_idx].first = free_space_pointer_;
+    }
+  }
+
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    const auto &column = schema.GetColumn(i);
+    if (column.IsInlined()) {
+      auto value = tuple.GetValue(&schema, i);
+      SetNull(schema, i, slot, value.IsNull());
+      if (value.IsNull()) {
+        memset(ValueAt(schema, i, slot), 0, Encodings()[i].width_);
+      } else {
+        WriteFixed(schema, i, slot, value);
+      }
+      continue;
+    }
+    const char *data = VarcharData(tuple.data_.data(), column);
+    SetNull(schema, i, slot, *reinterpret_cast<const uint32_t *>(data) == BUSTUB_VALUE_NULL);
+    memcpy(page_start_ + entries[i].first, data, entries[i].second);
+    *reinterpret_cast<VarEntry *>(ValueAt(schema, i, slot)) = entries[i];
+  }
+  // with the values written, restoring a vacuumed tuple is fine
+  UpdateTupleMeta(meta, rid, schema);
+}
+
+auto PaxPage::IsNull(const Schema &schema, uint32_t column_idx, uint16_t slot) const -> bool {
+  auto bits = reinterpret_cast<const uint8_t *>(page_start_ + ColumnStart(schema, column_idx))[slot / 8];
+  return (bits & (1 << (slot % 8))) != 0;
+}
+
+auto PaxPage::GetValue(const Schema &schema, uint32_t column_idx, uint16_t slot, const ToastStore *toast) const
+    -> Value {
+  const auto &column = schema.GetColumn(column_idx);
+  if (IsNull(schema, column_idx, slot)) {
+    return ValueFactory::GetNullValueByType(column.GetType());
+  }
+  if (column.IsInlined()) {
+    return ReadFixed(schema, column_idx, slot);
+  }
+  auto offset = reinterpret_cast<const VarEntry *>(ValueAt(schema, column_idx, slot))->first;
+  if (toast != nullptr) {
+    return toast->ReadVarchar(page_start_ + offset);
+  }
+  return Value::DeserializeFrom(page_start_ + offset, column.GetType());
+}
+
+auto PaxPage::MatchEquals(const Schema &schema, uint32_t column_idx, const Value &value,
+                          std::vector<bool> *matches) const -> bool {
+  const auto &encoding = Encodings()[column_idx];
+  auto matches_if = [&](auto &&pred) {
+    for (uint16_t slot = 0; slot < num_tuples_; slot++) {
+      (*matches)[slot] = (*matches)[slot] && !IsNull(schema, column_idx, slot) && pred(slot);
+    }
+  };
+
+  // nothing equals null
+  if (value.IsNull()) {
+    matches_if([](uint16_t) { return false; });
+    return true;
+  }
+  switch (encoding.encoding_) {
+    case PaxEncoding::FrameOfReference: {
+      if (!IsIntegerType(value.GetTypeId()) && value.GetTypeId() != TypeId::TINYINT) {
+        return false;
+      }
+      // the value is encoded once, and the codes compared as bytes
+      int64_t delta = ToInt64(value) - encoding.base_;
+      if (!encoding.has_base_ || !FitsCode(delta, encoding.width_)) {
+        matches_if([](uint16_t) { return false; });
+        return true;
+      }
+      char code[sizeof(int64_t)];
+      WriteCode(code, delta, encoding.width_);
+      matches_if([&](uint16_t slot) { return memcmp(ValueAt(schema, column_idx, slot), code, encoding.width_) == 0; });
+      return true;
+    }
+    case PaxEncoding::Dictionary: {
+      if (value.GetTypeId() != TypeId::VARCHAR) {
+        return false;
+      }
+      // equal values share their data, so the data is compared once per offset and the offsets after that
+      std::vector<char> data(sizeof(uint32_t) + value.GetLength());
+      value.SerializeTo(data.data());
+      std::unordered_map<uint16_t, bool> equal;
+      matches_if([&](uint16_t slot) {
+        auto [offset, size] = *reinterpret_cast<const VarEntry *>(ValueAt(schema, column_idx, slot));
+        bool toasted = size == TOAST_POINTER_SIZE &&
+                       (*reinterpret_cast<const uint32_t *>(page_start_ + offset) & TOAST_FLAG) != 0;
+        if (toasted) {
+          return true;
+        }
+        if (size != data.size()) {
+          return false;
+        }
+        auto it = equal.find(offset);
+        if (it == equal.end()) {
+          it = equal.emplace(offset, memcmp(page_start_ + offset, data.data(), size) == 0).first;
+        }
+        return it->second;
+      });
+      return true;
+    }
+    default:
+      if (value.GetTypeId() != schema.GetColumn(column_idx).GetType() &&
+          !(IsIntegerType(value.GetTypeId()) && IsIntegerType(schema.GetColumn(column_idx).GetType()))) {
+        return false;
+      }
+      matches_if(
+          [&](uint16_t slot) { return ReadFixed(schema, column_idx, slot).CompareEquals(value) == CmpBool::CmpTrue; });
+      return true;
+  }
+}
+
+auto PaxPage::Compact(const Schema &schema) -> size_t {
+  size_t free_space = free_space_pointer_ - fixed_end_;
+  // equal values of live tuples share their data, every piece of it is moved once, the one at the end of the page
+  // first, so that nothing is overwritten before it is moved
+  std::vector<VarEntry> live;
+  for (uint16_t slot = 0; slot < num_tuples_; slot++) {
+    for (auto column_idx : schema.GetUnlinedColumns()) {
+      auto &entry = *reinterpret_cast<VarEntry *>(ValueAt(schema, column_idx, slot));
+      if (Metas()[slot].IsDeleteCommitted()) {
+        entry = VarEntry(BUSTUB_PAGE_SIZE, 0);
+      } else {
+        live.push_back(entry);
+      }
+    }
+  }
+  std::sort(live.begin(), live.end(), std::greater<>());
+  live.erase(std::unique(live.begin(), live.end()), live.end());
+  std::unordered_map<uint16_t, uint16_t> moved_to;
+  uint16_t next_offset = BUSTUB_PAGE_SIZE;
+  for (auto [offset, size] : live) {
+    next_offset -= size;
+    if (offset != next_offset) {
+      memmove(page_start_ + next_offset, page_start_ + offset, size);
+    }
+    moved_to[offset] = next_offset;
+  }
+  for (uint16_t slot = 0; slot < num_tuples_; slot++) {
+    for (auto column_idx : schema.GetUnlinedColumns()) {
+      auto &entry = *reinterpret_cast<VarEntry *>(ValueAt(schema, column_idx, slot));
+      if (entry.second > 0) {
+        entry.first = moved_to[entry.first];
+      }
+    }
+  }
+  free_space_pointer_ = next_offset;
+  // the room gained may be enough for a page closed to inserts to be laid out again
+  flags_ &= ~PAX_PAGE_CLOSED;
+  return free_space_pointer_ - fixed_end_ - free_space;
+}
+
+auto PaxPage::ComputeCapacity(const Schema &schema, const std::vector<PaxColumnEncoding> &encodings, size_t room,
+                              bool reserve_varlen) -> uint16_t {
+  // a row takes its meta, its values in the minipages and a bit in every null bitmap, the encodings, the padding
+  // in front of them and the rounding of the bitmaps to whole bytes take the rest
+  size_t row_bits = 8 * sizeof(TupleMeta);
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    const auto &column = schema.GetColumn(i);
+    row_bits += 8 * encodings[i].width_ + 1;
+    if (reserve_varlen && !column.IsInlined()) {
+      row_bits += 8 * (column.GetVariableLength() / 2);
+    }
+  }
+  size_t overhead = schema.GetColumnCount() * (sizeof(PaxColumnEncoding) + 1) + alignof(int64_t);
+  if (room <= overhead) {
+    return 1;
+  }
+  return static_cast<uint16_t>(std::clamp<size_t>(8 * (room - overhead) / row_bits, 1, UINT16_MAX));
+}
+
+auto PaxPage::Relayout(const Schema &schema, const std::vector<PaxColumnEncoding> &encodings, uint32_t min_capacity)
+    -> bool {
+  // the rows the page would have been given with these encodings, as far as they fit in front of the varlen data
+  auto capacity = std::min(ComputeCapacity(schema, encodings, BUSTUB_PAGE_SIZE - PAX_PAGE_HEADER_SIZE, true),
+                           ComputeCapacity(schema, encodings, free_space_pointer_ - PAX_PAGE_HEADER_SIZE, false));
+  if (capacity < min_capacity) {
+    return false;
+  }
+
+  alignas(int64_t) char copy[BUSTUB_PAGE_SIZE];
+  memcpy(copy, page_start_, BUSTUB_PAGE_SIZE);
+  const auto *old_page = reinterpret_cast<const PaxPage *>(copy);
+  capacity_ = capacity;
+  std::copy(encodings.begin(), encodings.end(), Encodings());
+  fixed_end_ = ColumnStart(schema, schema.GetColumnCount());
+  if (fixed_end_ > free_space_pointer_) {
+    memcpy(page_start_, copy, BUSTUB_PAGE_SIZE);
+    return false;
+  }
+  memcpy(Metas(), old_page->Metas(), num_tuples_ * sizeof(TupleMeta));
+  memset(page_start_ + ColumnStart(schema, 0), 0, fixed_end_ - ColumnStart(schema, 0));
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    for (uint16_t slot = 0; slot < num_tuples_; slot++) {
+      bool is_null = old_page->IsNull(schema, i, slot);
+      SetNull(schema, i, slot, is_null);
+      if (!schema.GetColumn(i).IsInlined()) {
+        memcpy(ValueAt(schema, i, slot), old_page->ValueAt(schema, i, slot), VAR_ENTRY_SIZE);
+      } else if (!is_null) {
+        WriteFixed(schema, i, slot, old_page->ReadFixed(schema, i, slot));
+      }
+    }
+  }
+  return true;
+}
+
+auto PaxPage::Fits(uint32_t column_idx, const Value &value) const -> bool {
+  const auto &encoding = Encodings()[column_idx];
+  if (encoding.encoding_ != PaxEncoding::FrameOfReference || !encoding.has_base_) {
+    return true;
+  }
+  return FitsCode(ToInt64(value) - encoding.base_, encoding.width_);
+}
+
+auto PaxPage::ColumnStart(const Schema &schema, uint32_t column_idx) const -> uint32_t {
+  uint32_t start = EncodingsStart() + schema.GetColumnCount() * sizeof(PaxColumnEncoding);
+  for (uint32_t i = 0; i < column_idx; i++) {
+    start += BitmapSize() + capacity_ * Encodings()[i].width_;
+  }
+  return start;
+}
+
+auto PaxPage::ValueAt(const Schema &schema, uint32_t column_idx, uint16_t slot) -> char * {
+  return page_start_ + ColumnStart(schema, column_idx) + BitmapSize() + slot * Encodings()[column_idx].width_;
+}
+
+auto PaxPage::ValueAt(const Schema &schema, uint32_t column_idx, uint16_t slot) const -> const char * {
+  return page_start_ + ColumnStart(schema, column_idx) + BitmapSize() + slot * Encodings()[column_idx].width_;
+}
+
+void PaxPage::SetNull(const Schema &schema, uint32_t column_idx, uint16_t slot, bool is_null) {
+  auto &bits = reinterpret_cast<uint8_t *>(page_start_ + ColumnStart(schema, column_idx))[slot / 8];
+  bits = is_null ? bits | (1 << (slot % 8)) : bits & ~(1 << (slot % 8));
+}
+
+auto PaxPage::ReadFixed(const Schema &schema, uint32_t column_idx, uint16_t slot) const -> Value {
+  const auto &encoding = Encodings()[column_idx];
+  auto type = schema.GetColumn(column_idx).GetType();
+  if (encoding.encoding_ == PaxEncoding::FrameOfReference) {
+    return FromInt64(type, encoding.base_ + ReadCode(ValueAt(schema, column_idx, slot), encoding.width_));
+  }
+  return Value::DeserializeFrom(ValueAt(schema, column_idx, slot), type);
+}
+
+void PaxPage::WriteFixed(const Schema &schema, uint32_t column_idx, uint16_t slot, const Value &value) {
+  auto &encoding = Encodings()[column_idx];
+  if (encoding.encoding_ != PaxEncoding::FrameOfReference) {
+    value.SerializeTo(ValueAt(schema, column_idx, slot));
+    return;
+  }
+  if (!encoding.has_base_) {
+    encoding.has_base_ = true;
+    encoding.base_ = ToInt64(value);
+  }
+  WriteCode(ValueAt(schema, column_idx, slot), ToInt64(value) - encoding.base_, encoding.width_);
+}
+
+auto PaxPage::FindVarchar(const Schema &schema, uint32_t column_idx, const char *data, uint32_t size) const
+    -> std::optional<uint16_t> {
+  std::unordered_set<uint16_t> checked;
+  for (uint16_t slot = 0; slot < num_tuples_; slot++) {
+    auto [offset, entry_size] = *reinterpret_cast<const VarEntry *>(ValueAt(schema, column_idx, slot));
+    if (entry_size != size || !checked.insert(offset).second) {
+      continue;
+    }
+    if (memcmp(page_start_ + offset, data, size) == 0) {
+      return offset;
+    }
+  }
+  return std::nullopt;
+}
+
+auto PaxPage::IsVarcharShared(const Schema &schema, uint32_t column_idx, uint16_t slot, uint16_t offset) const
+    -> bool {
+  for (uint16_t other = 0; other < num_tuples_; other++) {
+    auto entry = *reinterpret_cast<const VarEntry *>(ValueAt(schema, column_idx, other));
+    if (other != slot && entry.first == offset && entry.second > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace bustub
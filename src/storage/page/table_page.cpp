@@ -28,6 +28,11 @@ void TablePage::Init() {
   num_deleted_tuples_ = 0;
 }
 
+auto TablePage::GetFreeSpace() const -> size_t {
+  size_t slot_end_offset = num_tuples_ > 0 ? std::get<0>(tuple_info_[num_tuples_ - 1]) : BUSTUB_PAGE_SIZE;
+  return slot_end_offset - TABLE_PAGE_HEADER_SIZE - TUPLE_INFO_SIZE * num_tuples_;
+}
+
 auto TablePage::GetNextTupleOffset(const TupleMeta &meta, const Tuple &tuple) const -> std::optional<uint16_t> {
   size_t slot_end_offset;
   if (num_tuples_ > 0) {
@@ -44,13 +49,13 @@ auto TablePage::GetNextTupleOffset(const TupleMeta &meta, const Tuple &tuple) co
   return tuple_offset;
 }
 
-auto TablePage::InsertTuple(const TupleMeta &meta, const Tuple &tuple) -> std::optional<uint16_t> {
+auto TablePage::InsertTuple(const TupleMeta &meta, const Tuple &tuple, bool moved_in) -> std::optional<uint16_t> {
   auto tuple_offset = GetNextTupleOffset(meta, tuple);
   if (tuple_offset == std::nullopt) {
     return std::nullopt;
   }
   auto tuple_id = num_tuples_;
-  tuple_info_[tuple_id] = std::make_tuple(*tuple_offset, tuple.GetLength(), meta);
+  tuple_info_[tuple_id] = std::make_tuple(*tuple_offset, tuple.GetLength() | (moved_in ? TUPLE_MOVED_IN : 0), meta);
   num_tuples_++;
   memcpy(page_start_ + *tuple_offset, tuple.data_.data(), tuple.GetLength());
   return tuple_id;
@@ -62,6 +67,12 @@ void TablePage::UpdateTupleMeta(const TupleMeta &meta, const RID &rid) {
     throw bustub::Exception("Tuple ID out of range");
   }
   auto &[offset, size, old_meta] = tuple_info_[tuple_id];
+  if (old_meta.is_deleted_ && !meta.is_deleted_) {
+    if ((size & TUPLE_SIZE_MASK) == 0) {
+      throw bustub::Exception("Tuple was vacuumed");
+    }
+    num_deleted_tuples_--;
+  }
   if (!old_meta.is_deleted_ && meta.is_deleted_) {
     num_deleted_tuples_++;
   }
@@ -75,12 +86,21 @@ auto TablePage::GetTuple(const RID &rid) const -> std::pair<TupleMeta, Tuple> {
   }
   auto &[offset, size, meta] = tuple_info_[tuple_id];
   Tuple tuple;
-  tuple.data_.resize(size);
-  memmove(tuple.data_.data(), page_start_ + offset, size);
+  tuple.data_.resize(size & TUPLE_SIZE_MASK);
+  memmove(tuple.data_.data(), page_start_ + offset, size & TUPLE_SIZE_MASK);
   tuple.rid_ = rid;
   return std::make_pair(meta, std::move(tuple));
 }
 
+auto TablePage::GetTupleView(const RID &rid, const Schema *schema) const -> std::pair<TupleMeta, TupleView> {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  auto &[offset, size, meta] = tuple_info_[tuple_id];
+  return std::make_pair(meta, TupleView(page_start_ + offset, size & TUPLE_SIZE_MASK, schema, rid));
+}
+
 auto TablePage::GetTupleMeta(const RID &rid) const -> TupleMeta {
   auto tuple_id = rid.GetSlotNum();
   if (tuple_id >= num_tuples_) {
@@ -91,19 +111,100 @@ auto TablePage::GetTupleMeta(const RID &rid) const -> TupleMeta {
 }
 
 void TablePage::UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid) {
+  if (!UpdateTupleInPlace(meta, tuple, rid)) {
+    throw bustub::Exception("Tuple does not fit in the page");
+  }
+}
+
+auto TablePage::UpdateTupleInPlace(const TupleMeta &meta, const Tuple &tuple, RID rid) -> bool {
   auto tuple_id = rid.GetSlotNum();
   if (tuple_id >= num_tuples_) {
     throw bustub::Exception("Tuple ID out of range");
   }
   auto &[offset, size, old_meta] = tuple_info_[tuple_id];
-  if (size != tuple.GetLength()) {
-    throw bustub::Exception("Tuple size mismatch");
+  uint16_t flags = size & TUPLE_MOVED_IN;
+  if (size == (tuple.GetLength() | flags)) {
+    memcpy(page_start_ + offset, tuple.data_.data(), tuple.GetLength());
+  } else if (!Relayout(tuple_id, tuple.data_.data(), tuple.GetLength(), flags)) {
+    return false;
   }
-  if (!old_meta.is_deleted_ && meta.is_deleted_) {
-    num_deleted_tuples_++;
+  UpdateTupleMeta(meta, rid);
+  return true;
+}
+
+auto TablePage::SetForward(const RID &rid, const RID &target) -> bool {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
   }
-  tuple_info_[tuple_id] = std::make_tuple(offset, size, meta);
-  memcpy(page_start_ + offset, tuple.data_.data(), tuple.GetLength());
+  return Relayout(tuple_id, reinterpret_cast<const char *>(&target), sizeof(RID), TUPLE_FORWARDED);
+}
+
+auto TablePage::GetForward(const RID &rid) const -> std::optional<RID> {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  auto &[offset, size, meta] = tuple_info_[tuple_id];
+  if ((size & TUPLE_FORWARDED) == 0) {
+    return std::nullopt;
+  }
+  RID target;
+  memcpy(&target, page_start_ + offset, sizeof(RID));
+  return target;
+}
+
+auto TablePage::IsMovedIn(const RID &rid) const -> bool {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  return (std::get<1>(tuple_info_[tuple_id]) & TUPLE_MOVED_IN) != 0;
+}
+
+auto TablePage::Relayout(uint16_t tuple_id, const char *data, uint16_t size, uint16_t flags) -> bool {
+  size_t total = TABLE_PAGE_HEADER_SIZE + TUPLE_INFO_SIZE * num_tuples_ + size;
+  for (uint16_t i = 0; i < num_tuples_; i++) {
+    total += i == tuple_id ? 0 : std::get<1>(tuple_info_[i]) & TUPLE_SIZE_MASK;
+  }
+  if (total > BUSTUB_PAGE_SIZE) {
+    return false;
+  }
+  alignas(RID) char copy[BUSTUB_PAGE_SIZE];
+  memcpy(copy, page_start_, BUSTUB_PAGE_SIZE);
+  uint16_t next_offset = BUSTUB_PAGE_SIZE;
+  for (uint16_t i = 0; i < num_tuples_; i++) {
+    auto &[offset, slot_size, meta] = tuple_info_[i];
+    if (i == tuple_id) {
+      next_offset -= size;
+      memcpy(page_start_ + next_offset, data, size);
+      slot_size = size | flags;
+    } else {
+      next_offset -= slot_size & TUPLE_SIZE_MASK;
+      memcpy(page_start_ + next_offset, copy + offset, slot_size & TUPLE_SIZE_MASK);
+    }
+    offset = next_offset;
+  }
+  return true;
+}
+
+auto TablePage::Compact() -> size_t {
+  size_t free_space = GetFreeSpace();
+  // the data of every slot moves towards the end of the page by the bytes dropped from the slots before it, in
+  // slot order nothing is overwritten before it is moved
+  uint16_t next_offset = BUSTUB_PAGE_SIZE;
+  for (uint16_t tuple_id = 0; tuple_id < num_tuples_; tuple_id++) {
+    auto &[offset, size, meta] = tuple_info_[tuple_id];
+    if (meta.IsDeleteCommitted()) {
+      size = 0;
+    }
+    next_offset -= size & TUPLE_SIZE_MASK;
+    if (offset != next_offset && (size & TUPLE_SIZE_MASK) > 0) {
+      memmove(page_start_ + next_offset, page_start_ + offset, size & TUPLE_SIZE_MASK);
+    }
+    offset = next_offset;
+  }
+  return GetFreeSpace() - free_space;
 }
 
 }  // namespace bustub
@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_page.cpp
+//
+// Identification: src/storage/page/tmp_tuple_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/tmp_tuple_page.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace bustub {
+
+void TmpTuplePage::Init(page_id_t page_id, uint32_t page_size) {
+  page_id_ = page_id;
+  lsn_ = INVALID_LSN;
+  free_space_pointer_ = page_size;
+}
+
+auto TmpTuplePage::Insert(const Tuple &tuple, TmpTuple *out) -> bool {
+  uint32_t size = sizeof(uint32_t) + tuple.GetLength();
+  if (GetFreeSpace() < size) {
+    return false;
+  }
+  free_space_pointer_ -= size;
+  tuple.SerializeTo(page_start_ + free_space_pointer_);
+  *out = TmpTuple(page_id_, free_space_pointer_);
+  return true;
+}
+
+auto TmpTuplePage::GetTupleOffsets(uint32_t page_size) const -> std::vector<uint32_t> {
+  // every tuple is appended below the one before it, so they are found from the last one up
+  std::vector<uint32_t> offsets;
+  for (uint32_t offset = free_space_pointer_; offset < page_size;
+       offset += sizeof(uint32_t) + *reinterpret_cast<const uint32_t *>(page_start_ + offset)) {
+    offsets.push_back(offset);
+  }
+  std::reverse(offsets.begin(), offsets.end());
+  return offsets;
+}
+
+auto TmpTuplePage::GetTuple(size_t offset) const -> Tuple {
+  Tuple tuple;
+  tuple.DeserializeFrom(page_start_ + offset);
+  return tuple;
+}
+
+auto TmpTuplePage::GetTupleView(size_t offset, const Schema *schema) const -> TupleView {
+  uint32_t length = *reinterpret_cast<const uint32_t *>(page_start_ + offset);
+  return {page_start_ + offset + sizeof(uint32_t), length, schema, RID{}};
+}
+
+}  // namespace bustub
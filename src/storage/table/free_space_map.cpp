@@ -0,0 +1,168 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.cpp
+//
+// Identification: src/storage/table/free_space_map.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/free_space_map.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+#include "storage/page/free_space_map_page.h"
+#include "storage/page/page_guard.h"
+
+namespace bustub {
+
+FreeSpaceMap::FreeSpaceMap(BufferPoolManager *bpm) : bpm_(bpm), tree_(2, 0) {
+  auto guard = bpm_->NewPageGuarded(&first_page_id_);
+  BUSTUB_ENSURE(first_page_id_ != INVALID_PAGE_ID, "cannot allocate page");
+  guard.AsMut<FreeSpaceMapPage>()->Init();
+  map_page_ids_.push_back(first_page_id_);
+}
+
+FreeSpaceMap::FreeSpaceMap(BufferPoolManager *bpm, page_id_t first_page_id)
+    : bpm_(bpm), first_page_id_(first_page_id), tree_(2, 0) {
+  page_id_t map_page_id = first_page_id_;
+  while (map_page_id != INVALID_PAGE_ID) {
+    map_page_ids_.push_back(map_page_id);
+    auto guard = bpm_->FetchPageRead(map_page_id);
+    const auto *map_page = guard.As<FreeSpaceMapPage>();
+    for (uint32_t i = 0; i < map_page->GetSize(); i++) {
+      if (page_ids_.size() == capacity_) {
+        Grow();
+      }
+      page_index_[map_page->PageIdAt(i)] = page_ids_.size();
+      page_ids_.push_back(map_page->PageIdAt(i));
+      space_classes_.push_back(map_page->SpaceClassAt(i));
+      checked_out_.push_back(false);
+      UpdateTree(page_ids_.size() - 1);
+    }
+    map_page_id = map_page->GetNextPageId();
+  }
+}
+
+auto FreeSpaceMap::ToSpaceClass(size_t free_space) -> uint8_t {
+  return static_cast<uint8_t>(std::min<size_t>(free_space / FREE_SPACE_CLASS_SIZE, UINT8_MAX));
+}
+
+void FreeSpaceMap::AddPage(page_id_t page_id, size_t free_space) {
+  std::scoped_lock<std::mutex> guard(latch_);
+  auto space_class = ToSpaceClass(free_space);
+
+  // the last page of the map is full, chain a new one
+  auto map_guard = bpm_->FetchPageWrite(map_page_ids_.back());
+  if (map_guard.As<FreeSpaceMapPage>()->IsFull()) {
+    page_id_t map_page_id = INVALID_PAGE_ID;
+    auto new_guard = bpm_->NewPageGuarded(&map_page_id);
+    BUSTUB_ENSURE(map_page_id != INVALID_PAGE_ID, "cannot allocate page");
+    new_guard.AsMut<FreeSpaceMapPage>()->Init();
+    map_guard.AsMut<FreeSpaceMapPage>()->SetNextPageId(map_page_id);
+    map_guard.Drop();
+    new_guard.Drop();
+    map_page_ids_.push_back(map_page_id);
+    map_guard = bpm_->FetchPageWrite(map_page_id);
+  }
+  map_guard.AsMut<FreeSpaceMapPage>()->Append(page_id, space_class);
+
+  if (page_ids_.size() == capacity_) {
+    Grow();
+  }
+  page_index_[page_id] = page_ids_.size();
+  page_ids_.push_back(page_id);
+  space_classes_.push_back(space_class);
+  checked_out_.push_back(true);
+  UpdateTree(page_ids_.size() - 1);
+}
+
+void FreeSpaceMap::UpdatePage(page_id_t page_id, size_t free_space) {
+  std::scoped_lock<std::mutex> guard(latch_);
+  auto index = page_index_.at(page_id);
+  SetSpaceClass(index, ToSpaceClass(free_space));
+  UpdateTree(index);
+}
+
+auto FreeSpaceMap::CheckOutPage(size_t size) -> std::optional<page_id_t> {
+  std::scoped_lock<std::mutex> guard(latch_);
+  // round up, a page of that class has at least size bytes of room
+  size_t needed = (size + FREE_SPACE_CLASS_SIZE - 1) / FREE_SPACE_CLASS_SIZE;
+  if (needed > tree_[1]) {
+    return std::nullopt;
+  }
+  size_t node = 1;
+  while (node < capacity_) {
+    node = tree_[2 * node] >= needed ? 2 * node : 2 * node + 1;
+  }
+  size_t index = node - capacity_;
+  checked_out_[index] = true;
+  UpdateTree(index);
+  return page_ids_[index];
+}
+
+auto FreeSpaceMap::TryCheckOutPage(page_id_t page_id) -> bool {
+  std::scoped_lock<std::mutex> guard(latch_);
+  auto index = page_index_.at(page_id);
+  if (checked_out_[index]) {
+    return false;
+  }
+  checked_out_[index] = true;
+  UpdateTree(index);
+  return true;
+}
+
+void FreeSpaceMap::ReturnPage(page_id_t page_id, size_t free_space) {
+  std::scoped_lock<std::mutex> guard(latch_);
+  auto index = page_index_.at(page_id);
+  BUSTUB_ASSERT(checked_out_[index], "page is not checked out");
+  SetSpaceClass(index, ToSpaceClass(free_space));
+  checked_out_[index] = false;
+  UpdateTree(index);
+}
+
+auto FreeSpaceMap::GetPageIndex(page_id_t page_id) -> size_t {
+  std::scoped_lock<std::mutex> guard(latch_);
+  return page_index_.at(page_id);
+}
+
+auto FreeSpaceMap::GetPageId(size_t page_index) -> page_id_t {
+  std::scoped_lock<std::mutex> guard(latch_);
+  return page_index < page_ids_.size() ? page_ids_[page_index] : INVALID_PAGE_ID;
+}
+
+auto FreeSpaceMap::GetNumPages() -> size_t {
+  std::scoped_lock<std::mutex> guard(latch_);
+  return page_ids_.size();
+}
+
+void FreeSpaceMap::SetSpaceClass(size_t index, uint8_t space_class) {
+  if (space_classes_[index] == space_class) {
+    return;
+  }
+  space_classes_[index] = space_class;
+  auto map_guard = bpm_->FetchPageWrite(map_page_ids_[index / FREE_SPACE_MAP_PAGE_CAPACITY]);
+  map_guard.AsMut<FreeSpaceMapPage>()->SetSpaceClassAt(index % FREE_SPACE_MAP_PAGE_CAPACITY, space_class);
+}
+
+void FreeSpaceMap::UpdateTree(size_t index) {
+  size_t node = capacity_ + index;
+  tree_[node] = checked_out_[index] ? 0 : space_classes_[index];
+  for (node /= 2; node > 0; node /= 2) {
+    tree_[node] = std::max(tree_[2 * node], tree_[2 * node + 1]);
+  }
+}
+
+void FreeSpaceMap::Grow() {
+  std::vector<uint8_t> tree(4 * capacity_, 0);
+  std::copy(tree_.begin() + capacity_, tree_.end(), tree.begin() + 2 * capacity_);
+  capacity_ *= 2;
+  for (size_t node = capacity_ - 1; node > 0; node--) {
+    tree[node] = std::max(tree[2 * node], tree[2 * node + 1]);
+  }
+  tree_ = std::move(tree);
+}
+
+}  // namespace bustub
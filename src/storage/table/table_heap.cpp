@@ -10,9 +10,13 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
+#include <exception>
 #include <mutex>  // NOLINT
+#include <thread>  // NOLINT
 #include <utility>
+#include <vector>
 
 #include "common/config.h"
 #include "common/exception.h"
@@ -21,106 +25,554 @@
 #include "concurrency/transaction.h"
 #include "fmt/format.h"
 #include "storage/page/page_guard.h"
+#include "storage/page/pax_page.h"
 #include "storage/page/table_page.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
 
-TableHeap::TableHeap(BufferPoolManager *bpm) : bpm_(bpm) {
+TableHeap::TableHeap(BufferPoolManager *bpm, TableFormat format, const Schema *schema)
+    : bpm_(bpm), format_(format), free_space_map_(bpm), toast_(bpm) {
+  BUSTUB_ASSERT(format_ != TableFormat::Pax || schema != nullptr, "a PAX table needs its schema");
+  if (schema != nullptr) {
+    schema_ = std::make_unique<Schema>(*schema);
+  }
   // Initialize the first table page.
   auto guard = bpm->NewPageGuarded(&first_page_id_);
   last_page_id_ = first_page_id_;
-  auto first_page = guard.AsMut<TablePage>();
-  BUSTUB_ASSERT(first_page != nullptr,
+  BUSTUB_ASSERT(guard.GetData() != nullptr,
                 "Couldn't create a page for the table heap. Have you completed the buffer pool manager project?");
-  first_page->Init();
+  size_t free_space;
+  if (format_ == TableFormat::Pax) {
+    auto first_page = guard.AsMut<PaxPage>();
+    first_page->Init(*schema_);
+    free_space = first_page->GetFreeSpace();
+  } else {
+    auto first_page = guard.AsMut<TablePage>();
+    first_page->Init();
+    free_space = first_page->GetFreeSpace();
+  }
+  free_space_map_.AddPage(first_page_id_, free_space);
+  free_space_map_.ReturnPage(first_page_id_, free_space);
+  page_num_tuples_.push_back(0);
+  if (schema_ != nullptr) {
+    page_zones_.emplace_back(*schema_);
+  }
+}
+
+TableHeap::TableHeap(BufferPoolManager *bpm, page_id_t first_page_id, page_id_t free_space_map_page_id,
+                     TableFormat format, const Schema *schema)
+    : bpm_(bpm),
+      format_(format),
+      first_page_id_(first_page_id),
+      free_space_map_(bpm, free_space_map_page_id),
+      toast_(bpm) {
+  BUSTUB_ASSERT(format_ != TableFormat::Pax || schema != nullptr, "a PAX table needs its schema");
+  if (schema != nullptr) {
+    schema_ = std::make_unique<Schema>(*schema);
+  }
+  // the header of a PaxPage starts as that of a TablePage, so either reads the chain and the counts
+  page_id_t page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    auto guard = bpm_->FetchPageRead(page_id);
+    auto page = guard.As<TablePage>();
+    last_page_id_ = page_id;
+    page_num_tuples_.push_back(page->GetNumTuples());
+    if (schema_ != nullptr) {
+      auto &zone = page_zones_.emplace_back(*schema_);
+      for (uint32_t slot = 0; slot < page->GetNumTuples(); slot++) {
+        RID rid{page_id, slot};
+        if (format_ == TableFormat::Row && page->IsMovedIn(rid)) {
+          continue;
+        }
+        auto [meta, tuple] =
+            format_ == TableFormat::Pax ? guard.As<PaxPage>()->GetTuple(rid, *schema_) : page->GetTuple(rid);
+        // the values of a moved tuple are where its slot forwards to, and count for the page of the slot
+        if (auto moved_to = format_ == TableFormat::Pax ? std::nullopt : page->GetForward(rid); moved_to.has_value()) {
+          tuple = GetTuple(*moved_to).second;
+        }
+        if (!meta.is_deleted_) {
+          zone.Add(*schema_, tuple);
+        }
+      }
+    }
+    // which of them were vacuumed is not known, compacting a page twice only costs the time
+    if (page->GetNumDeletedTuples() > 0) {
+      pages_to_vacuum_.insert(page_id);
+    }
+    page_id = page->GetNextPageId();
+  }
+  BUSTUB_ENSURE(page_num_tuples_.size() == free_space_map_.GetNumPages(), "free space map does not match the table");
+}
+
+TableHeap::~TableHeap() { StopVacuum(); }
+
+auto TableHeap::AppendPage() -> page_id_t {
+  std::scoped_lock<std::mutex> guard(latch_);
+  page_id_t next_page_id = INVALID_PAGE_ID;
+  auto next_page_guard = bpm_->NewPageGuarded(&next_page_id);
+  BUSTUB_ENSURE(next_page_id != INVALID_PAGE_ID, "cannot allocate page");
+  size_t free_space;
+  if (format_ == TableFormat::Pax) {
+    auto next_page = next_page_guard.AsMut<PaxPage>();
+    next_page->Init(*schema_);
+    free_space = next_page->GetFreeSpace();
+  } else {
+    auto next_page = next_page_guard.AsMut<TablePage>();
+    next_page->Init();
+    free_space = next_page->GetFreeSpace();
+  }
+
+  auto last_page_guard = bpm_->FetchPageWrite(last_page_id_);
+  last_page_guard.AsMut<TablePage>()->SetNextPageId(next_page_id);
+
+  last_page_id_ = next_page_id;
+  free_space_map_.AddPage(next_page_id, free_space);
+  page_num_tuples_.push_back(0);
+  if (schema_ != nullptr) {
+    page_zones_.emplace_back(*schema_);
+  }
+  return next_page_id;
 }
 
 auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManager *lock_mgr, Transaction *txn,
                             table_oid_t oid) -> std::optional<RID> {
-  std::unique_lock<std::mutex> guard(latch_);
-  auto page_guard = bpm_->FetchPageWrite(last_page_id_);
+  auto toasted = Toast(tuple);
+  return InsertStoredTuple(meta, toasted.has_value() ? *toasted : tuple, false, lock_mgr, txn, oid);
+}
+
+auto TableHeap::InsertStoredTuple(const TupleMeta &meta, const Tuple &stored, bool moved_in, LockManager *lock_mgr,
+                                  Transaction *txn, table_oid_t oid) -> RID {
+  page_id_t page_id;
+  WritePageGuard page_guard;
+  std::optional<uint16_t> slot_id;
   while (true) {
-    auto page = page_guard.AsMut<TablePage>();
-    if (page->GetNextTupleOffset(meta, tuple) != std::nullopt) {
+    // the page is this insert's alone until it is returned, concurrent inserts fill other pages
+    page_id = free_space_map_.CheckOutPage(GetTupleSpace(stored)).value_or(INVALID_PAGE_ID);
+    if (page_id == INVALID_PAGE_ID) {
+      page_id = AppendPage();
+    }
+    page_guard = bpm_->FetchPageWrite(page_id);
+    size_t free_space;
+    if (format_ == TableFormat::Pax) {
+      auto page = page_guard.AsMut<PaxPage>();
+      slot_id = page->InsertTuple(meta, stored, *schema_);
+      free_space = page->GetFreeSpace();
+    } else {
+      auto page = page_guard.AsMut<TablePage>();
+      slot_id = page->InsertTuple(meta, stored, moved_in);
+      free_space = page->GetFreeSpace();
+    }
+    if (slot_id != std::nullopt) {
       break;
     }
 
     // if there's no tuple in the page, and we can't insert the tuple, then this tuple is too large.
-    BUSTUB_ENSURE(page->GetNumTuples() != 0, "tuple is too large, cannot insert");
+    // Otherwise the map was read back from disk behind the page, and now it is corrected.
+    bool empty = page_guard.As<TablePage>()->GetNumTuples() == 0;
+    page_guard.Drop();
+    free_space_map_.ReturnPage(page_id, free_space);
+    BUSTUB_ENSURE(!empty, "tuple is too large, cannot insert");
+  }
+  auto num_tuples = page_guard.As<TablePage>()->GetNumTuples();
+  auto free_space = format_ == TableFormat::Pax ? page_guard.As<PaxPage>()->GetFreeSpace()
+                                                : page_guard.As<TablePage>()->GetFreeSpace();
 
-    page_id_t next_page_id = INVALID_PAGE_ID;
-    auto npg = bpm_->NewPage(&next_page_id);
-    BUSTUB_ENSURE(next_page_id != INVALID_PAGE_ID, "cannot allocate page");
+  if (lock_mgr != nullptr) {
+    BUSTUB_ENSURE(lock_mgr->LockRow(txn, LockManager::LockMode::EXCLUSIVE, oid, RID{page_id, *slot_id}),
+                  "failed to lock when inserting new tuple");
+  }
 
-    page->SetNextPageId(next_page_id);
+  page_guard.Drop();
 
-    auto next_page = reinterpret_cast<TablePage *>(npg->GetData());
-    next_page->Init();
+  // no page latch is held here, page allocation takes latch_ before the latch of the last page
+  {
+    std::scoped_lock<std::mutex> guard(latch_);
+    auto page_index = free_space_map_.GetPageIndex(page_id);
+    page_num_tuples_[page_index] = num_tuples;
+    if (schema_ != nullptr) {
+      page_zones_[page_index].Add(*schema_, stored);
+    }
+  }
+  free_space_map_.ReturnPage(page_id, free_space);
 
-    page_guard.Drop();
+  return {page_id, *slot_id};
+}
 
-    // acquire latch here as TSAN complains. Given we only have one insertion thread, this is fine.
-    npg->WLatch();
-    auto next_page_guard = WritePageGuard{bpm_, npg};
+auto TableHeap::InsertTuples(const TupleMeta &meta, const std::vector<Tuple> &tuples, LockManager *lock_mgr,
+                             Transaction *txn, table_oid_t oid) -> std::vector<RID> {
+  // the tuples are only copied if some of them have varchars to move to overflow pages
+  std::vector<Tuple> toasted;
+  for (size_t i = 0; i < tuples.size(); i++) {
+    auto toasted_tuple = Toast(tuples[i]);
+    if (toasted_tuple.has_value() && toasted.empty()) {
+      toasted.assign(tuples.begin(), tuples.begin() + i);
+    }
+    if (toasted_tuple.has_value() || !toasted.empty()) {
+      toasted.push_back(toasted_tuple.has_value() ? std::move(*toasted_tuple) : tuples[i]);
+    }
+  }
+  const auto &stored = toasted.empty() ? tuples : toasted;
 
-    last_page_id_ = next_page_id;
-    page_guard = std::move(next_page_guard);
+  std::vector<RID> rids;
+  rids.reserve(stored.size());
+  size_t remaining_space = 0;
+  for (const auto &tuple : stored) {
+    remaining_space += GetTupleSpace(tuple);
   }
-  auto last_page_id = last_page_id_;
 
-  auto page = page_guard.AsMut<TablePage>();
-  auto slot_id = *page->InsertTuple(meta, tuple);
+  size_t next = 0;
+  while (next < stored.size()) {
+    // ask for room for the whole rest of the batch, up to what an empty page has, so that a large batch fills
+    // empty pages rather than the holes a few tuples fit in. How many rows an empty PAX page takes depends on
+    // the schema, there only the next tuple is asked for.
+    size_t wanted =
+        format_ == TableFormat::Pax ? 0 : std::min<size_t>(remaining_space, FREE_SPACE_CLASS_SIZE * UINT8_MAX);
+    wanted = std::max(wanted, GetTupleSpace(stored[next]));
+    page_id_t page_id = free_space_map_.CheckOutPage(wanted).value_or(INVALID_PAGE_ID);
+    if (page_id == INVALID_PAGE_ID) {
+      page_id = AppendPage();
+    }
 
-  // only allow one insertion at a time, otherwise it will deadlock.
-  guard.unlock();
+    auto page_guard = bpm_->FetchPageWrite(page_id);
+    size_t first = next;
+    std::vector<RID> page_rids;
+    while (next < stored.size()) {
+      auto slot_id = format_ == TableFormat::Pax
+                         ? page_guard.AsMut<PaxPage>()->InsertTuple(meta, stored[next], *schema_)
+                         : page_guard.AsMut<TablePage>()->InsertTuple(meta, stored[next]);
+      if (slot_id == std::nullopt) {
+        break;
+      }
+      page_rids.emplace_back(page_id, *slot_id);
+      remaining_space -= GetTupleSpace(stored[next]);
+      next++;
+    }
+    auto num_tuples = page_guard.As<TablePage>()->GetNumTuples();
+    auto free_space = format_ == TableFormat::Pax ? page_guard.As<PaxPage>()->GetFreeSpace()
+                                                  : page_guard.As<TablePage>()->GetFreeSpace();
 
-  if (lock_mgr != nullptr) {
-    BUSTUB_ENSURE(lock_mgr->LockRow(txn, LockManager::LockMode::EXCLUSIVE, oid, RID{last_page_id, slot_id}),
-                  "failed to lock when inserting new tuple");
-  }
+    if (next == first) {
+      // as in InsertTuple, either the tuple is too large or the map was behind the page
+      bool empty = num_tuples == 0;
+      page_guard.Drop();
+      free_space_map_.ReturnPage(page_id, free_space);
+      BUSTUB_ENSURE(!empty, "tuple is too large, cannot insert");
+      continue;
+    }
 
-  page_guard.Drop();
+    if (lock_mgr != nullptr) {
+      BUSTUB_ENSURE(lock_mgr->LockRows(txn, LockManager::LockMode::EXCLUSIVE, oid, page_rids),
+                    "failed to lock when inserting new tuples");
+    }
+
+    page_guard.Drop();
 
-  return RID(last_page_id, slot_id);
+    // the values are read out of the tuples before latch_ is taken
+    std::optional<PageZone> zone;
+    if (schema_ != nullptr) {
+      zone.emplace(*schema_);
+      for (size_t i = first; i < next; i++) {
+        zone->Add(*schema_, stored[i]);
+      }
+    }
+    {
+      std::scoped_lock<std::mutex> guard(latch_);
+      auto page_index = free_space_map_.GetPageIndex(page_id);
+      page_num_tuples_[page_index] = num_tuples;
+      if (zone.has_value()) {
+        page_zones_[page_index].Merge(*zone);
+      }
+    }
+    free_space_map_.ReturnPage(page_id, free_space);
+    rids.insert(rids.end(), page_rids.begin(), page_rids.end());
+  }
+  return rids;
 }
 
 void TableHeap::UpdateTupleMeta(const TupleMeta &meta, RID rid) {
   auto page_guard = bpm_->FetchPageWrite(rid.GetPageId());
-  auto page = page_guard.AsMut<TablePage>();
-  page->UpdateTupleMeta(meta, rid);
+  std::optional<RID> moved_to;
+  if (format_ == TableFormat::Pax) {
+    page_guard.AsMut<PaxPage>()->UpdateTupleMeta(meta, rid, *schema_);
+  } else {
+    auto page = page_guard.AsMut<TablePage>();
+    page->UpdateTupleMeta(meta, rid);
+    moved_to = page->GetForward(rid);
+  }
+  page_guard.Drop();
+  if (meta.IsDeleteCommitted()) {
+    AddPageToVacuum(rid.GetPageId());
+  }
+  // the place a tuple was moved to is deleted and vacuumed with it
+  if (moved_to.has_value()) {
+    UpdateTupleMeta(meta, *moved_to);
+  }
 }
 
 auto TableHeap::GetTuple(RID rid) -> std::pair<TupleMeta, Tuple> {
   auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
-  auto page = page_guard.As<TablePage>();
-  auto [meta, tuple] = page->GetTuple(rid);
+  auto [meta, tuple] = format_ == TableFormat::Pax ? page_guard.As<PaxPage>()->GetTuple(rid, *schema_)
+                                                   : page_guard.As<TablePage>()->GetTuple(rid);
+  auto moved_to = format_ == TableFormat::Pax ? std::nullopt : page_guard.As<TablePage>()->GetForward(rid);
+  page_guard.Drop();
+  // the meta of a moved tuple is that of its own slot
+  if (moved_to.has_value()) {
+    tuple = GetTuple(*moved_to).second;
+  }
   tuple.rid_ = rid;
-  return std::make_pair(meta, std::move(tuple));
+  return std::make_pair(meta, Detoast(std::move(tuple)));
 }
 
 auto TableHeap::GetTupleMeta(RID rid) -> TupleMeta {
   auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
-  auto page = page_guard.As<TablePage>();
-  return page->GetTupleMeta(rid);
+  if (format_ == TableFormat::Pax) {
+    return page_guard.As<PaxPage>()->GetTupleMeta(rid);
+  }
+  return page_guard.As<TablePage>()->GetTupleMeta(rid);
 }
 
 auto TableHeap::MakeIterator() -> TableIterator {
+  // tuples inserted from now on are not scanned, wherever they land
   std::unique_lock<std::mutex> guard(latch_);
-  auto last_page_id = last_page_id_;
+  auto page_num_tuples = page_num_tuples_;
   guard.unlock();
 
-  auto page_guard = bpm_->FetchPageRead(last_page_id);
-  auto page = page_guard.As<TablePage>();
-  return {this, {first_page_id_, 0}, {last_page_id, page->GetNumTuples()}};
+  return {this, {first_page_id_, 0}, std::move(page_num_tuples)};
 }
 
-auto TableHeap::MakeEagerIterator() -> TableIterator { return {this, {first_page_id_, 0}, {INVALID_PAGE_ID, 0}}; }
+auto TableHeap::MakeEagerIterator() -> TableIterator { return {this, {first_page_id_, 0}, {}}; }
+
+auto TableHeap::MakePartitionedIterators(size_t num_partitions) -> std::vector<TableIterator> {
+  BUSTUB_ASSERT(num_partitions > 0, "cannot split a scan into no partitions");
+  std::unique_lock<std::mutex> guard(latch_);
+  auto page_num_tuples = page_num_tuples_;
+  guard.unlock();
+
+  // every partition gets a range of pages as even as it can be, the page directory knows where each one starts
+  size_t num_pages = page_num_tuples.size();
+  std::vector<TableIterator> iterators;
+  iterators.reserve(num_partitions);
+  for (size_t i = 0; i < num_partitions; i++) {
+    size_t begin = num_pages * i / num_partitions;
+    size_t end = num_pages * (i + 1) / num_partitions;
+    page_id_t page_id = begin < end ? free_space_map_.GetPageId(begin) : INVALID_PAGE_ID;
+    iterators.emplace_back(this, RID{page_id, 0}, page_num_tuples, begin, end);
+  }
+  return iterators;
+}
 
 void TableHeap::UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid) {
+  auto toasted = Toast(tuple);
+  const Tuple &stored = toasted.has_value() ? *toasted : tuple;
+  // the overflow pages of the old values are freed once they are no longer referred to
+  std::vector<page_id_t> old_toast_page_ids;
+  if (format_ == TableFormat::Pax) {
+    // as in UpdateRowTupleInPage, the room the update takes goes to the free space map
+    bool checked_out = free_space_map_.TryCheckOutPage(rid.GetPageId());
+    auto page_guard = bpm_->FetchPageWrite(rid.GetPageId());
+    auto page = page_guard.AsMut<PaxPage>();
+    old_toast_page_ids = GetToastPageIds(page->GetTuple(rid, *schema_).second);
+    std::exception_ptr error;
+    try {
+      page->UpdateTupleInPlaceUnsafe(meta, stored, rid, *schema_);
+    } catch (const Exception &e) {
+      error = std::current_exception();
+    }
+    auto free_space = page->GetFreeSpace();
+    page_guard.Drop();
+    if (checked_out) {
+      free_space_map_.ReturnPage(rid.GetPageId(), free_space);
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  } else {
+    old_toast_page_ids = UpdateRowTuple(meta, stored, rid);
+  }
+  auto new_toast_page_ids = GetToastPageIds(stored);
+  for (auto page_id : old_toast_page_ids) {
+    if (std::find(new_toast_page_ids.begin(), new_toast_page_ids.end(), page_id) == new_toast_page_ids.end()) {
+      toast_.Free(page_id);
+    }
+  }
+  if (schema_ != nullptr) {
+    std::scoped_lock<std::mutex> guard(latch_);
+    page_zones_[free_space_map_.GetPageIndex(rid.GetPageId())].Add(*schema_, tuple);
+  }
+  if (meta.IsDeleteCommitted()) {
+    AddPageToVacuum(rid.GetPageId());
+  }
+}
+
+auto TableHeap::UpdateRowTuple(const TupleMeta &meta, const Tuple &stored, RID rid) -> std::vector<page_id_t> {
+  std::vector<page_id_t> old_toast_page_ids;
+  std::optional<RID> moved_to;
+  bool updated = UpdateRowTupleInPage(meta, stored, rid, &old_toast_page_ids, &moved_to);
+
+  // a tuple moved out before stays where it was if it still fits there, and is left to vacuum if not
+  if (moved_to.has_value()) {
+    std::optional<RID> unused;
+    if (updated || !UpdateRowTupleInPage(meta, stored, *moved_to, &old_toast_page_ids, &unused)) {
+      UpdateTupleMeta({meta.insert_txn_id_, meta.delete_txn_id_, true}, *moved_to);
+      old_toast_page_ids.clear();
+    } else {
+      updated = true;
+    }
+  }
+  if (updated) {
+    return old_toast_page_ids;
+  }
+
+  // the tuple moves to a page with room, and its slot forwards to it so that its rid and the index entries on it
+  // stay as they are
+  auto target = InsertStoredTuple(meta, stored, true, nullptr, nullptr, 0);
+  auto page_guard = bpm_->FetchPageWrite(rid.GetPageId());
+  auto page = page_guard.AsMut<TablePage>();
+  if (!page->SetForward(rid, target)) {
+    throw bustub::Exception("Tuple does not fit in the page");
+  }
+  page->UpdateTupleMeta(meta, rid);
+  return old_toast_page_ids;
+}
+
+auto TableHeap::UpdateRowTupleInPage(const TupleMeta &meta, const Tuple &stored, RID rid,
+                                     std::vector<page_id_t> *old_toast_page_ids, std::optional<RID> *moved_to)
+    -> bool {
+  // the room the update gains or takes goes to the free space map, unless an insert has the page and does it
+  bool checked_out = free_space_map_.TryCheckOutPage(rid.GetPageId());
   auto page_guard = bpm_->FetchPageWrite(rid.GetPageId());
   auto page = page_guard.AsMut<TablePage>();
-  page->UpdateTupleInPlaceUnsafe(meta, tuple, rid);
+  *moved_to = page->GetForward(rid);
+  if (!moved_to->has_value()) {
+    *old_toast_page_ids = GetToastPageIds(page->GetTuple(rid).second);
+  }
+  bool updated = page->UpdateTupleInPlace(meta, stored, rid);
+  auto free_space = page->GetFreeSpace();
+  page_guard.Drop();
+  if (checked_out) {
+    free_space_map_.ReturnPage(rid.GetPageId(), free_space);
+  }
+  return updated;
+}
+
+auto TableHeap::PageMayMatch(size_t page_index, const std::function<bool(const PageZone &)> &filter) -> bool {
+  std::scoped_lock<std::mutex> guard(latch_);
+  return page_zones_.empty() || filter(page_zones_[page_index]);
+}
+
+void TableHeap::AddPageToVacuum(page_id_t page_id) {
+  std::scoped_lock<std::mutex> guard(latch_);
+  pages_to_vacuum_.insert(page_id);
+}
+
+auto TableHeap::Vacuum(size_t max_pages) -> size_t {
+  std::scoped_lock<std::mutex> vacuum_lock(vacuum_latch_);
+  std::vector<page_id_t> page_ids;
+  {
+    std::scoped_lock<std::mutex> guard(latch_);
+    auto it = pages_to_vacuum_.begin();
+    while (it != pages_to_vacuum_.end() && page_ids.size() < max_pages) {
+      page_ids.push_back(*it);
+      it = pages_to_vacuum_.erase(it);
+    }
+  }
+
+  size_t gained = 0;
+  for (auto page_id : page_ids) {
+    // checking the page out keeps inserts away from it, and lets the room gained go back to the map exactly
+    if (!free_space_map_.TryCheckOutPage(page_id)) {
+      AddPageToVacuum(page_id);
+      continue;
+    }
+    auto page_guard = bpm_->FetchPageWrite(page_id);
+    size_t free_space;
+    // the overflow pages of the deleted tuples go with them
+    std::vector<page_id_t> toast_page_ids;
+    bool has_varchars = schema_ != nullptr && !schema_->GetUnlinedColumns().empty();
+    if (format_ == TableFormat::Pax) {
+      auto page = page_guard.AsMut<PaxPage>();
+      for (uint32_t slot = 0; has_varchars && slot < page->GetNumTuples(); slot++) {
+        auto [meta, tuple] = page->GetTuple({page_id, slot}, *schema_);
+        if (meta.IsDeleteCommitted()) {
+          auto ids = GetToastPageIds(tuple);
+          toast_page_ids.insert(toast_page_ids.end(), ids.begin(), ids.end());
+        }
+      }
+      gained += page->Compact(*schema_);
+      free_space = page->GetFreeSpace();
+    } else {
+      auto page = page_guard.AsMut<TablePage>();
+      for (uint32_t slot = 0; has_varchars && slot < page->GetNumTuples(); slot++) {
+        // a forwarding slot has a rid for data, the values are where it points
+        auto [meta, tuple] = page->GetTuple({page_id, slot});
+        if (meta.IsDeleteCommitted() && !page->GetForward({page_id, slot}).has_value()) {
+          auto ids = GetToastPageIds(tuple);
+          toast_page_ids.insert(toast_page_ids.end(), ids.begin(), ids.end());
+        }
+      }
+      gained += page->Compact();
+      free_space = page->GetFreeSpace();
+    }
+    page_guard.Drop();
+    free_space_map_.ReturnPage(page_id, free_space);
+    for (auto toast_page_id : toast_page_ids) {
+      toast_.Free(toast_page_id);
+    }
+  }
+  return gained;
+}
+
+void TableHeap::StartVacuum() {
+  StopVacuum();
+  enable_vacuum_ = true;
+  vacuum_thread_ = new std::thread(&TableHeap::RunVacuum, this);
+}
+
+void TableHeap::StopVacuum() {
+  enable_vacuum_ = false;
+  if (vacuum_thread_ != nullptr) {
+    vacuum_thread_->join();
+    delete vacuum_thread_;
+    vacuum_thread_ = nullptr;
+  }
+}
+
+auto TableHeap::GetTupleSpace(const Tuple &tuple) const -> size_t {
+  if (format_ == TableFormat::Pax) {
+    return PaxPage::GetTupleSpace(tuple, *schema_);
+  }
+  return TablePage::GetTupleSpace(tuple);
+}
+
+auto TableHeap::Toast(const Tuple &tuple) -> std::optional<Tuple> {
+  if (schema_ == nullptr || tuple.GetLength() <= TOAST_TUPLE_THRESHOLD) {
+    return std::nullopt;
+  }
+  return toast_.Toast(tuple, *schema_);
+}
+
+auto TableHeap::Detoast(Tuple tuple) const -> Tuple {
+  if (schema_ == nullptr || tuple.GetLength() <= schema_->GetLength() ||
+      !ToastStore::IsToasted(tuple.GetData(), *schema_)) {
+    return tuple;
+  }
+  return toast_.Detoast(tuple, *schema_);
+}
+
+auto TableHeap::GetToastPageIds(const Tuple &stored) const -> std::vector<page_id_t> {
+  // a vacuumed tuple has no varchars left, not even their lengths
+  if (schema_ == nullptr || stored.GetLength() <= schema_->GetLength()) {
+    return {};
+  }
+  return ToastStore::GetToastPageIds(stored.GetData(), *schema_);
+}
+
+void TableHeap::RunVacuum() {
+  while (enable_vacuum_) {
+    std::this_thread::sleep_for(table_vacuum_interval);
+    Vacuum(TABLE_VACUUM_PAGES_PER_ROUND);
+  }
 }
 
 }  // namespace bustub
@@ -10,8 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
 #include <optional>
+#include <utility>
 
 #include "common/config.h"
 #include "common/exception.h"
@@ -20,51 +22,199 @@
 
 namespace bustub {
 
-TableIterator::TableIterator(TableHeap *table_heap, RID rid, RID stop_at_rid)
-    : table_heap_(table_heap), rid_(rid), stop_at_rid_(stop_at_rid) {
-  // If the rid doesn't correspond to a tuple (i.e., the table has just been initialized), then
-  // we set rid_ to invalid.
-  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
-  auto page = page_guard.As<TablePage>();
-  if (rid_.GetSlotNum() >= page->GetNumTuples()) {
-    rid_ = RID{INVALID_PAGE_ID, 0};
-  }
+TableIterator::TableIterator(TableHeap *table_heap, RID rid, std::vector<uint16_t> stop_at_num_tuples,
+                             size_t page_index, size_t end_page_index)
+    : table_heap_(table_heap),
+      rid_(rid),
+      page_index_(page_index),
+      end_page_index_(end_page_index),
+      stop_at_num_tuples_(std::move(stop_at_num_tuples)) {
+  LoadPage(rid.GetPageId(), rid.GetSlotNum());
 }
 
-auto TableIterator::GetTuple() -> std::pair<TupleMeta, Tuple> { return table_heap_->GetTuple(rid_); }
+auto TableIterator::GetTuple() -> std::pair<TupleMeta, Tuple> {
+  if (page_tuples_.empty()) {
+    auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
+    page_tuples_start_ = rid_.GetSlotNum();
+    std::vector<bool> forwarded;
+    for (uint32_t slot = page_tuples_start_; slot < end_slot_; slot++) {
+      RID rid{rid_.GetPageId(), slot};
+      if (table_heap_->format_ == TableFormat::Pax) {
+        page_tuples_.push_back(page_guard.As<PaxPage>()->GetTuple(rid, *table_heap_->schema_));
+        forwarded.push_back(false);
+        continue;
+      }
+      // a tuple moved in is read through the slot that forwards to it, here it reads as deleted
+      auto page = page_guard.As<TablePage>();
+      auto &[meta, tuple] = page_tuples_.emplace_back(page->GetTuple(rid));
+      meta.is_deleted_ = meta.is_deleted_ || page->IsMovedIn(rid);
+      forwarded.push_back(page->GetForward(rid).has_value());
+    }
+    page_guard.Drop();
+    for (size_t i = 0; i < page_tuples_.size(); i++) {
+      auto &[meta, tuple] = page_tuples_[i];
+      if (forwarded[i]) {
+        tuple = table_heap_->GetTuple(tuple.GetRid()).second;
+      } else if (!meta.is_deleted_) {
+        tuple = table_heap_->Detoast(std::move(tuple));
+      }
+    }
+  }
+  return page_tuples_[rid_.GetSlotNum() - page_tuples_start_];
+}
 
 auto TableIterator::GetRID() -> RID { return rid_; }
 
 auto TableIterator::IsEnd() -> bool { return rid_.GetPageId() == INVALID_PAGE_ID; }
 
 auto TableIterator::operator++() -> TableIterator & {
-  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
-  auto page = page_guard.As<TablePage>();
   auto next_tuple_id = rid_.GetSlotNum() + 1;
+  if (next_tuple_id < end_slot_) {
+    rid_ = RID{rid_.GetPageId(), next_tuple_id};
+    return *this;
+  }
+  page_index_++;
+  LoadPage(next_page_id_, 0);
+  return *this;
+}
 
-  if (stop_at_rid_.GetPageId() != INVALID_PAGE_ID) {
-    BUSTUB_ASSERT(
-        /* case 1: cursor before the page of the stop tuple */ rid_.GetPageId() < stop_at_rid_.GetPageId() ||
-            /* case 2: cursor at the page before the tuple */
-            (rid_.GetPageId() == stop_at_rid_.GetPageId() && next_tuple_id <= stop_at_rid_.GetSlotNum()),
-        "iterate out of bound");
+void TableIterator::SetPageFilter(std::function<bool(const PageZone &)> filter) {
+  page_filter_ = std::move(filter);
+  if (!IsEnd()) {
+    LoadPage(rid_.GetPageId(), rid_.GetSlotNum());
+  }
+}
+
+auto TableIterator::NextPage(std::vector<Tuple> *tuples, const Schema *schema,
+                             const std::function<bool(const TupleView &)> &keep) -> bool {
+  if (IsEnd()) {
+    return false;
+  }
+  {
+    auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
+    // the tuples of a PAX page are matched on their encoded values first, and only those left are put together
+    std::vector<bool> matches;
+    if (table_heap_->format_ == TableFormat::Pax && !equality_filter_.empty()) {
+      auto page = page_guard.As<PaxPage>();
+      matches.assign(page->GetNumTuples(), true);
+      for (const auto &[column_idx, value] : equality_filter_) {
+        page->MatchEquals(*table_heap_->schema_, column_idx, value, &matches);
+      }
+    }
+    for (uint32_t slot = rid_.GetSlotNum(); slot < end_slot_; slot++) {
+      RID rid{rid_.GetPageId(), slot};
+      if (table_heap_->format_ == TableFormat::Pax) {
+        // the tuple is only in one piece once put together, the view is over that copy
+        auto page = page_guard.As<PaxPage>();
+        if ((!matches.empty() && !matches[slot]) || page->GetTupleMeta(rid).is_deleted_) {
+          continue;
+        }
+        auto tuple = page->GetTuple(rid, *table_heap_->schema_).second;
+        TupleView view(tuple.GetData(), tuple.GetLength(), schema, rid);
+        view.SetToastStore(&table_heap_->toast_);
+        if (!keep || keep(view)) {
+          tuples->push_back(table_heap_->Detoast(std::move(tuple)));
+        }
+        continue;
+      }
+      // the filter reads the varchars in overflow pages it looks at, only the tuples kept are read back whole
+      ReadPageGuard moved_guard;
+      auto found = GetRowTupleView(page_guard.As<TablePage>(), rid, schema, &moved_guard);
+      if (found.has_value() && !found->first.is_deleted_ && (!keep || keep(found->second))) {
+        tuples->push_back(table_heap_->Detoast(found->second.ToTuple()));
+      }
+    }
   }
+  page_index_++;
+  LoadPage(next_page_id_, 0);
+  return true;
+}
 
-  rid_ = RID{rid_.GetPageId(), next_tuple_id};
+auto TableIterator::NextPageColumns(const Schema &schema, const std::vector<uint32_t> &column_ids,
+                                    std::vector<std::vector<Value>> *columns, std::vector<RID> *rids) -> bool {
+  if (IsEnd()) {
+    return false;
+  }
+  {
+    auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
+    for (uint32_t slot = rid_.GetSlotNum(); slot < end_slot_; slot++) {
+      RID rid{rid_.GetPageId(), slot};
+      if (table_heap_->format_ == TableFormat::Pax) {
+        auto page = page_guard.As<PaxPage>();
+        if (page->GetTupleMeta(rid).is_deleted_) {
+          continue;
+        }
+        for (size_t i = 0; i < column_ids.size(); i++) {
+          (*columns)[i].push_back(page->GetValue(schema, column_ids[i], slot, &table_heap_->toast_));
+        }
+      } else {
+        ReadPageGuard moved_guard;
+        auto found = GetRowTupleView(page_guard.As<TablePage>(), rid, &schema, &moved_guard);
+        if (!found.has_value() || found->first.is_deleted_) {
+          continue;
+        }
+        for (size_t i = 0; i < column_ids.size(); i++) {
+          (*columns)[i].push_back(found->second.GetValue(column_ids[i]));
+        }
+      }
+      if (rids != nullptr) {
+        rids->push_back(rid);
+      }
+    }
+  }
+  page_index_++;
+  LoadPage(next_page_id_, 0);
+  return true;
+}
 
-  if (rid_ == stop_at_rid_) {
-    rid_ = RID{INVALID_PAGE_ID, 0};
-  } else if (next_tuple_id < page->GetNumTuples()) {
-    // that's fine
-  } else {
-    auto next_page_id = page->GetNextPageId();
-    // if next page is invalid, RID is set to invalid page; otherwise, it's the first tuple in that page.
-    rid_ = RID{next_page_id, 0};
+auto TableIterator::GetRowTupleView(const TablePage *page, RID rid, const Schema *schema, ReadPageGuard *moved_guard)
+    -> std::optional<std::pair<TupleMeta, TupleView>> {
+  if (page->IsMovedIn(rid)) {
+    return std::nullopt;
+  }
+  auto [meta, view] = page->GetTupleView(rid, schema);
+  // only read latches are taken while another is held, so latching the page a tuple moved to is safe
+  if (auto moved_to = page->GetForward(rid); moved_to.has_value()) {
+    *moved_guard = table_heap_->bpm_->FetchPageRead(moved_to->GetPageId());
+    auto moved_view = moved_guard->As<TablePage>()->GetTupleView(*moved_to, schema).second;
+    view = TupleView(moved_view.GetData(), moved_view.GetLength(), schema, rid);
   }
+  view.SetToastStore(&table_heap_->toast_);
+  return std::make_pair(meta, view);
+}
 
-  page_guard.Drop();
+auto TableIterator::NumTuplesToScan(uint32_t num_tuples) const -> uint32_t {
+  if (stop_at_num_tuples_.empty()) {
+    return num_tuples;
+  }
+  return std::min<uint32_t>(num_tuples, stop_at_num_tuples_[page_index_]);
+}
 
-  return *this;
+void TableIterator::LoadPage(page_id_t page_id, uint32_t slot) {
+  page_tuples_.clear();
+  // pages appended after the iterator was created are not scanned
+  while (page_id != INVALID_PAGE_ID && page_index_ < end_page_index_ &&
+         (stop_at_num_tuples_.empty() || page_index_ < stop_at_num_tuples_.size())) {
+    // a page the filter rules out is not fetched, the free space map knows the page after it
+    if (page_filter_ && !table_heap_->PageMayMatch(page_index_, page_filter_)) {
+      page_index_++;
+      page_id = table_heap_->free_space_map_.GetPageId(page_index_);
+      slot = 0;
+      continue;
+    }
+    auto page_guard = table_heap_->bpm_->FetchPageRead(page_id);
+    auto page = page_guard.As<TablePage>();
+    end_slot_ = NumTuplesToScan(page->GetNumTuples());
+    next_page_id_ = page->GetNextPageId();
+    if (slot < end_slot_) {
+      rid_ = RID{page_id, slot};
+      return;
+    }
+    page_id = next_page_id_;
+    page_index_++;
+    slot = 0;
+  }
+  rid_ = RID{INVALID_PAGE_ID, 0};
 }
 
 }  // namespace bustub
@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_file_manager.cpp
+//
+// Identification: src/storage/table/tmp_file_manager.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/tmp_file_manager.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+TmpTupleFile::~TmpTupleFile() {
+  for (auto page_id : page_ids_) {
+    bpm_->DeletePage(page_id);
+  }
+}
+
+auto TmpTupleFile::Append(const Tuple &tuple) -> TmpTuple {
+  TmpTuple tmp_tuple(INVALID_PAGE_ID, 0);
+  if (!page_ids_.empty()) {
+    auto guard = bpm_->FetchPageWrite(page_ids_.back());
+    if (guard.AsMut<TmpTuplePage>()->Insert(tuple, &tmp_tuple)) {
+      num_tuples_++;
+      return tmp_tuple;
+    }
+  }
+  page_id_t page_id = INVALID_PAGE_ID;
+  auto guard = bpm_->NewPageGuarded(&page_id);
+  if (page_id == INVALID_PAGE_ID) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate temporary page");
+  }
+  page_ids_.push_back(page_id);
+  auto page = guard.AsMut<TmpTuplePage>();
+  page->Init(page_id, BUSTUB_PAGE_SIZE);
+  if (!page->Insert(tuple, &tmp_tuple)) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "Tuple too large for a temporary page");
+  }
+  num_tuples_++;
+  return tmp_tuple;
+}
+
+auto TmpTupleFile::GetTuple(const TmpTuple &tmp_tuple) const -> Tuple {
+  auto guard = bpm_->FetchPageRead(tmp_tuple.GetPageId());
+  return guard.As<TmpTuplePage>()->GetTuple(tmp_tuple.GetOffset());
+}
+
+auto TmpTupleFile::GetTupleView(const TmpTuple &tmp_tuple, const Schema *schema, ReadPageGuard *guard) const
+    -> TupleView {
+  *guard = bpm_->FetchPageRead(tmp_tuple.GetPageId());
+  return guard->As<TmpTuplePage>()->GetTupleView(tmp_tuple.GetOffset(), schema);
+}
+
+void TmpTupleFile::ReadPage(size_t page_index, std::vector<Tuple> *tuples) const {
+  auto guard = bpm_->FetchPageRead(page_ids_[page_index]);
+  auto page = guard.As<TmpTuplePage>();
+  for (auto offset : page->GetTupleOffsets(BUSTUB_PAGE_SIZE)) {
+    tuples->push_back(page->GetTuple(offset));
+  }
+}
+
+auto TmpFileManager::CreateFile() -> TmpTupleFile * {
+  std::scoped_lock<std::mutex> guard(latch_);
+  return files_.emplace_back(std::make_unique<TmpTupleFile>(bpm_)).get();
+}
+
+void TmpFileManager::DropFile(TmpTupleFile *file) {
+  std::unique_ptr<TmpTupleFile> dropped;
+  {
+    std::scoped_lock<std::mutex> guard(latch_);
+    auto it = std::find_if(files_.begin(), files_.end(), [&](const auto &owned) { return owned.get() == file; });
+    BUSTUB_ASSERT(it != files_.end(), "file not created by this manager");
+    dropped = std::move(*it);
+    files_.erase(it);
+  }
+}
+
+auto TmpFileManager::GetNumPages() -> size_t {
+  std::scoped_lock<std::mutex> guard(latch_);
+  size_t num_pages = 0;
+  for (const auto &file : files_) {
+    num_pages += file->GetNumPages();
+  }
+  return num_pages;
+}
+
+}  // namespace bustub
@@ -0,0 +1,180 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// toast_store.cpp
+//
+// Identification: src/storage/table/toast_store.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/toast_store.h"
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the varchar of a column in the tuple data, its length first */
+auto VarcharData(const char *data, const Column &column) -> const char * {
+  return data + *reinterpret_cast<const uint32_t *>(data + column.GetOffset());
+}
+
+/** @return whether the length of a varchar says it is in overflow pages, the null length has the flag set too */
+auto IsToastedLength(uint32_t length) -> bool { return length != BUSTUB_VALUE_NULL && (length & TOAST_FLAG) != 0; }
+
+/** @return the bytes a varchar takes in its tuple */
+auto VarcharSize(const char *varchar) -> uint32_t {
+  uint32_t length = *reinterpret_cast<const uint32_t *>(varchar);
+  if (length == BUSTUB_VALUE_NULL) {
+    return sizeof(uint32_t);
+  }
+  return IsToastedLength(length) ? TOAST_POINTER_SIZE : sizeof(uint32_t) + length;
+}
+
+}  // namespace
+
+auto ToastStore::Toast(const Tuple &tuple, const Schema &schema) -> Tuple {
+  const char *data = tuple.GetData();
+  const auto &unlined = schema.GetUnlinedColumns();
+  std::vector<bool> toast(unlined.size(), false);
+  uint32_t length = tuple.GetLength();
+  // the largest values go first, so that as few as possible leave the tuple
+  while (length > TOAST_TUPLE_THRESHOLD) {
+    std::optional<size_t> largest;
+    uint32_t largest_size = TOAST_POINTER_SIZE;
+    for (size_t i = 0; i < unlined.size(); i++) {
+      auto size = VarcharSize(VarcharData(data, schema.GetColumn(unlined[i])));
+      if (!toast[i] && size > largest_size) {
+        largest = i;
+        largest_size = size;
+      }
+    }
+    if (!largest.has_value()) {
+      break;
+    }
+    toast[*largest] = true;
+    length -= largest_size - TOAST_POINTER_SIZE;
+  }
+  if (std::none_of(toast.begin(), toast.end(), [](bool moved) { return moved; })) {
+    return tuple;
+  }
+
+  Tuple toasted(tuple.GetRid());
+  toasted.data_.assign(data, data + schema.GetLength());
+  for (size_t i = 0; i < unlined.size(); i++) {
+    const auto &column = schema.GetColumn(unlined[i]);
+    const char *varchar = VarcharData(data, column);
+    uint32_t offset = toasted.data_.size();
+    memcpy(toasted.data_.data() + column.GetOffset(), &offset, sizeof(uint32_t));
+    if (!toast[i]) {
+      toasted.data_.insert(toasted.data_.end(), varchar, varchar + VarcharSize(varchar));
+      continue;
+    }
+    uint32_t value_length = *reinterpret_cast<const uint32_t *>(varchar);
+    page_id_t page_id = Store(varchar + sizeof(uint32_t), value_length);
+    uint32_t flagged_length = value_length | TOAST_FLAG;
+    toasted.data_.resize(offset + TOAST_POINTER_SIZE);
+    memcpy(toasted.data_.data() + offset, &flagged_length, sizeof(uint32_t));
+    memcpy(toasted.data_.data() + offset + sizeof(uint32_t), &page_id, sizeof(page_id_t));
+  }
+  return toasted;
+}
+
+auto ToastStore::Detoast(const Tuple &tuple, const Schema &schema) const -> Tuple {
+  const char *data = tuple.GetData();
+  Tuple detoasted(tuple.GetRid());
+  detoasted.data_.assign(data, data + schema.GetLength());
+  for (auto column_idx : schema.GetUnlinedColumns()) {
+    const auto &column = schema.GetColumn(column_idx);
+    const char *varchar = VarcharData(data, column);
+    uint32_t offset = detoasted.data_.size();
+    memcpy(detoasted.data_.data() + column.GetOffset(), &offset, sizeof(uint32_t));
+    uint32_t length = *reinterpret_cast<const uint32_t *>(varchar);
+    if (!IsToastedLength(length)) {
+      detoasted.data_.insert(detoasted.data_.end(), varchar, varchar + VarcharSize(varchar));
+      continue;
+    }
+    length &= ~TOAST_FLAG;
+    detoasted.data_.resize(offset + sizeof(uint32_t) + length);
+    memcpy(detoasted.data_.data() + offset, &length, sizeof(uint32_t));
+    Load(*reinterpret_cast<const page_id_t *>(varchar + sizeof(uint32_t)), length,
+         detoasted.data_.data() + offset + sizeof(uint32_t));
+  }
+  return detoasted;
+}
+
+auto ToastStore::ReadVarchar(const char *varchar) const -> Value {
+  uint32_t length = *reinterpret_cast<const uint32_t *>(varchar);
+  if (!IsToastedLength(length)) {
+    return Value::DeserializeFrom(varchar, TypeId::VARCHAR);
+  }
+  length &= ~TOAST_FLAG;
+  std::string chars(length, '\0');
+  Load(*reinterpret_cast<const page_id_t *>(varchar + sizeof(uint32_t)), length, chars.data());
+  return {TypeId::VARCHAR, chars.data(), length, true};
+}
+
+void ToastStore::Free(page_id_t page_id) {
+  while (page_id != INVALID_PAGE_ID) {
+    auto guard = bpm_->FetchPageRead(page_id);
+    auto next_page_id = guard.As<OverflowPage>()->GetNextPageId();
+    guard.Drop();
+    bpm_->DeletePage(page_id);
+    page_id = next_page_id;
+  }
+}
+
+auto ToastStore::IsToasted(const char *data, const Schema &schema) -> bool {
+  const auto &unlined = schema.GetUnlinedColumns();
+  return std::any_of(unlined.begin(), unlined.end(), [&](uint32_t column_idx) {
+    return IsToastedLength(*reinterpret_cast<const uint32_t *>(VarcharData(data, schema.GetColumn(column_idx))));
+  });
+}
+
+auto ToastStore::GetToastPageIds(const char *data, const Schema &schema) -> std::vector<page_id_t> {
+  std::vector<page_id_t> page_ids;
+  for (auto column_idx : schema.GetUnlinedColumns()) {
+    const char *varchar = VarcharData(data, schema.GetColumn(column_idx));
+    if (IsToastedLength(*reinterpret_cast<const uint32_t *>(varchar))) {
+      page_ids.push_back(*reinterpret_cast<const page_id_t *>(varchar + sizeof(uint32_t)));
+    }
+  }
+  return page_ids;
+}
+
+auto ToastStore::Store(const char *data, uint32_t size) -> page_id_t {
+  // the chain is written from its end, so every page knows the one after it when it is written
+  page_id_t next_page_id = INVALID_PAGE_ID;
+  uint32_t num_pages = (size + OVERFLOW_PAGE_CAPACITY - 1) / OVERFLOW_PAGE_CAPACITY;
+  for (uint32_t i = num_pages; i-- > 0;) {
+    page_id_t page_id = INVALID_PAGE_ID;
+    auto guard = bpm_->NewPageGuarded(&page_id);
+    BUSTUB_ENSURE(page_id != INVALID_PAGE_ID, "cannot allocate page");
+    auto page = guard.AsMut<OverflowPage>();
+    page->Init();
+    page->SetNextPageId(next_page_id);
+    uint32_t start = i * OVERFLOW_PAGE_CAPACITY;
+    memcpy(page->GetData(), data + start, std::min(OVERFLOW_PAGE_CAPACITY, size - start));
+    next_page_id = page_id;
+  }
+  return next_page_id;
+}
+
+void ToastStore::Load(page_id_t page_id, uint32_t size, char *out) const {
+  for (uint32_t start = 0; start < size; start += OVERFLOW_PAGE_CAPACITY) {
+    auto guard = bpm_->FetchPageRead(page_id);
+    auto page = guard.As<OverflowPage>();
+    memcpy(out + start, page->GetData(), std::min(OVERFLOW_PAGE_CAPACITY, size - start));
+    page_id = page->GetNextPageId();
+  }
+}
+
+}  // namespace bustub
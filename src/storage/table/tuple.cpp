@@ -16,6 +16,7 @@
 #include <string>
 #include <vector>
 
+#include "storage/table/toast_store.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -79,17 +80,21 @@ auto Tuple::KeyFromTuple(const Schema &schema, const Schema &key_schema, const s
 }
 
 auto Tuple::GetDataPtr(const Schema *schema, const uint32_t column_idx) const -> const char * {
+  return GetDataPtr(data_.data(), schema, column_idx);
+}
+
+auto Tuple::GetDataPtr(const char *data, const Schema *schema, const uint32_t column_idx) -> const char * {
   assert(schema);
   const auto &col = schema->GetColumn(column_idx);
   bool is_inlined = col.IsInlined();
   // For inline type, data is stored where it is.
   if (is_inlined) {
-    return (data_.data() + col.GetOffset());
+    return (data + col.GetOffset());
   }
   // We read the relative offset from the tuple data.
-  int32_t offset = *reinterpret_cast<const int32_t *>(data_.data() + col.GetOffset());
+  int32_t offset = *reinterpret_cast<const int32_t *>(data + col.GetOffset());
   // And return the beginning address of the real data for the VARCHAR type.
-  return (data_.data() + offset);
+  return (data + offset);
 }
 
 auto Tuple::ToString(const Schema *schema) const -> std::string {
@@ -117,6 +122,20 @@ auto Tuple::ToString(const Schema *schema) const -> std::string {
   return os.str();
 }
 
+auto TupleView::GetValue(const uint32_t column_idx) const -> Value {
+  const TypeId column_type = schema_->GetColumn(column_idx).GetType();
+  if (toast_ != nullptr && !schema_->GetColumn(column_idx).IsInlined()) {
+    return toast_->ReadVarchar(Tuple::GetDataPtr(data_, schema_, column_idx));
+  }
+  return Value::DeserializeFrom(Tuple::GetDataPtr(data_, schema_, column_idx), column_type);
+}
+
+auto TupleView::ToTuple() const -> Tuple {
+  Tuple tuple(rid_);
+  tuple.data_.assign(data_, data_ + length_);
+  return tuple;
+}
+
 void Tuple::SerializeTo(char *storage) const {
   int32_t sz = data_.size();
   memcpy(storage, &sz, sizeof(int32_t));
@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.cpp
+//
+// Identification: src/storage/table/tuple_batch.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/tuple_batch.h"
+
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+void TupleBatch::Reset(size_t num_columns) {
+  // the vectors keep their capacity from batch to batch
+  columns_.resize(num_columns);
+  for (auto &column : columns_) {
+    column.clear();
+  }
+  rids_.clear();
+  selection_.clear();
+}
+
+void TupleBatch::AppendTuple(const Tuple &tuple, const Schema &schema, RID rid) {
+  for (size_t i = 0; i < columns_.size(); i++) {
+    columns_[i].push_back(tuple.GetValue(&schema, i));
+  }
+  selection_.push_back(rids_.size());
+  rids_.push_back(rid);
+}
+
+void TupleBatch::SelectAll() {
+  selection_.resize(rids_.size());
+  for (size_t i = 0; i < selection_.size(); i++) {
+    selection_[i] = i;
+  }
+}
+
+void TupleBatch::Select(const std::vector<Value> &matches) {
+  BUSTUB_ASSERT(matches.size() == selection_.size(), "a predicate value for every row selected");
+  size_t kept = 0;
+  for (size_t i = 0; i < selection_.size(); i++) {
+    if (!matches[i].IsNull() && matches[i].GetAs<bool>()) {
+      selection_[kept++] = selection_[i];
+    }
+  }
+  selection_.resize(kept);
+}
+
+auto TupleBatch::GetTuple(size_t i, const Schema &schema) const -> Tuple {
+  std::vector<Value> values;
+  values.reserve(columns_.size());
+  for (const auto &column : columns_) {
+    values.push_back(column[selection_[i]]);
+  }
+  return {std::move(values), &schema};
+}
+
+}  // namespace bustub
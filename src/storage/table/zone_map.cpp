@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map.cpp
+//
+// Identification: src/storage/table/zone_map.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/zone_map.h"
+
+namespace bustub {
+
+PageZone::PageZone(const Schema &schema) : columns_(schema.GetColumnCount()) {
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    columns_[i].tracked_ = schema.GetColumn(i).IsInlined();
+  }
+}
+
+void PageZone::Add(const Schema &schema, const Tuple &tuple) {
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    if (columns_[i].tracked_) {
+      AddValue(i, tuple.GetValue(&schema, i));
+    }
+  }
+}
+
+void PageZone::Merge(const PageZone &other) {
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    const auto &column = other.columns_[i];
+    if (!columns_[i].tracked_) {
+      continue;
+    }
+    columns_[i].null_count_ += column.null_count_;
+    if (column.min_.has_value()) {
+      AddValue(i, *column.min_);
+      AddValue(i, *column.max_);
+    }
+  }
+}
+
+void PageZone::AddValue(uint32_t column_idx, const Value &value) {
+  auto &column = columns_[column_idx];
+  if (value.IsNull()) {
+    column.null_count_++;
+    return;
+  }
+  if (!column.min_.has_value() || value.CompareLessThan(*column.min_) == CmpBool::CmpTrue) {
+    column.min_ = value;
+  }
+  if (!column.max_.has_value() || value.CompareGreaterThan(*column.max_) == CmpBool::CmpTrue) {
+    column.max_ = value;
+  }
+}
+
+}  // namespace bustub
@@ -17,6 +17,7 @@
 #include "common/logger.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_memory.h"
 #include "storage/page/hash_table_bucket_page.h"
 #include "storage/page/hash_table_directory_page.h"
 
@@ -113,4 +114,54 @@ TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, FullBucketTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(5, disk_manager.get());
+
+  page_id_t bucket_page_id = INVALID_PAGE_ID;
+  auto bucket_page =
+      reinterpret_cast<HashTableBucketPage<int, int, IntComparator> *>(bpm->NewPage(&bucket_page_id)->GetData());
+
+  // a full bucket has plenty of fingerprint collisions, every key still finds exactly its own values
+  using KeyType = int;
+  using ValueType = int;
+  const auto capacity = static_cast<int>(BUCKET_ARRAY_SIZE);
+  for (int i = 0; i < capacity; i++) {
+    ASSERT_TRUE(bucket_page->Insert(i / 2, i, IntComparator()));
+  }
+  ASSERT_TRUE(bucket_page->IsFull());
+  ASSERT_FALSE(bucket_page->Insert(capacity, capacity, IntComparator()));
+  for (int i = 0; i < capacity; i += 2) {
+    std::vector<int> result;
+    ASSERT_TRUE(bucket_page->GetValue(i / 2, IntComparator(), &result));
+    std::vector<int> expected{i};
+    if (i + 1 < capacity) {
+      expected.push_back(i + 1);
+    }
+    ASSERT_EQ(result, expected);
+  }
+  std::vector<int> result;
+  ASSERT_FALSE(bucket_page->GetValue(capacity, IntComparator(), &result));
+
+  // removed pairs leave tombstones that inserts take again
+  for (int i = 0; i < capacity; i += 3) {
+    ASSERT_TRUE(bucket_page->Remove(i / 2, i, IntComparator()));
+    ASSERT_FALSE(bucket_page->Remove(i / 2, i, IntComparator()));
+  }
+  ASSERT_FALSE(bucket_page->IsFull());
+  for (int i = 0; i < capacity; i += 3) {
+    ASSERT_TRUE(bucket_page->Insert(capacity + i, i, IntComparator()));
+  }
+  ASSERT_TRUE(bucket_page->IsFull());
+  for (int i = 0; i < capacity; i += 3) {
+    std::vector<int> result;
+    ASSERT_TRUE(bucket_page->GetValue(capacity + i, IntComparator(), &result));
+    ASSERT_EQ(result, std::vector<int>{i});
+  }
+
+  bpm->UnpinPage(bucket_page_id, true);
+  delete bpm;
+}
+
 }  // namespace bustub
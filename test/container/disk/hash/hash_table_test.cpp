@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <thread>  // NOLINT
 #include <vector>
 
@@ -18,6 +19,7 @@
 #include "container/disk/hash/disk_extendible_hash_table.h"
 #include "gtest/gtest.h"
 #include "murmur3/MurmurHash3.h"
+#include "storage/disk/disk_manager_memory.h"
 
 namespace bustub {
 
@@ -117,4 +119,125 @@ TEST(HashTableTest, DISABLED_SampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTableTest, GrowShrinkTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // enough pairs for many buckets, so the directory grows
+  const int total = 20000;
+  for (int i = 0; i < total; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  ASSERT_FALSE(ht.Insert(nullptr, 7, 7));
+  ht.VerifyIntegrity();
+  ASSERT_GT(ht.GetGlobalDepth(), 4);
+
+  for (int i = 0; i < total; i++) {
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+    ASSERT_EQ(res, std::vector<int>{i});
+  }
+
+  // emptied buckets are merged away, and the directory shrinks back
+  for (int i = 0; i < total; i++) {
+    ASSERT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  ASSERT_FALSE(ht.Remove(nullptr, 7, 7));
+  ht.VerifyIntegrity();
+  ASSERT_EQ(ht.GetGlobalDepth(), 0);
+  std::vector<int> res;
+  ASSERT_FALSE(ht.GetValue(nullptr, 7, &res));
+
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, DuplicateKeyTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // equal keys cannot be split apart, the pairs of a key that fill more than a bucket go to overflow pages
+  const int copies = 2000;
+  for (int i = 0; i < copies; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, 7, i));
+    ASSERT_TRUE(ht.Insert(nullptr, i + 100, i));
+  }
+  ASSERT_FALSE(ht.Insert(nullptr, 7, copies - 1));
+  ht.VerifyIntegrity();
+
+  std::vector<int> res;
+  ASSERT_TRUE(ht.GetValue(nullptr, 7, &res));
+  std::sort(res.begin(), res.end());
+  ASSERT_EQ(res.size(), copies);
+  for (int i = 0; i < copies; i++) {
+    ASSERT_EQ(res[i], i);
+    std::vector<int> other;
+    ASSERT_TRUE(ht.GetValue(nullptr, i + 100, &other));
+    ASSERT_EQ(other, std::vector<int>{i});
+  }
+
+  // the overflow pages go as they empty, and the directory shrinks back
+  for (int i = 0; i < copies; i++) {
+    ASSERT_TRUE(ht.Remove(nullptr, 7, i));
+    ASSERT_TRUE(ht.Remove(nullptr, i + 100, i));
+  }
+  ASSERT_FALSE(ht.Remove(nullptr, 7, 0));
+  ht.VerifyIntegrity();
+  ASSERT_EQ(ht.GetGlobalDepth(), 0);
+  res.clear();
+  ASSERT_FALSE(ht.GetValue(nullptr, 7, &res));
+
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, ConcurrentTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // each thread owns the keys that are equal to its id modulo the number of threads, and checks them
+  // while the others split and merge buckets around it
+  const int num_threads = 4;
+  const int per_thread = 3000;
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid] {
+      for (int round = 0; round < 2; round++) {
+        for (int i = tid; i < per_thread * num_threads; i += num_threads) {
+          ASSERT_TRUE(ht.Insert(nullptr, i, i));
+          ASSERT_TRUE(ht.Insert(nullptr, i, -i - 1));
+        }
+        for (int i = tid; i < per_thread * num_threads; i += num_threads) {
+          std::vector<int> res;
+          ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+          std::sort(res.begin(), res.end());
+          ASSERT_EQ(res, (std::vector<int>{-i - 1, i}));
+          ASSERT_TRUE(ht.Remove(nullptr, i, -i - 1));
+        }
+        if (round == 0) {
+          for (int i = tid; i < per_thread * num_threads; i += num_threads) {
+            ASSERT_TRUE(ht.Remove(nullptr, i, i));
+          }
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  ht.VerifyIntegrity();
+  for (int i = 0; i < per_thread * num_threads; i++) {
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+    ASSERT_EQ(res, std::vector<int>{i});
+  }
+
+  delete bpm;
+}
+
 }  // namespace bustub
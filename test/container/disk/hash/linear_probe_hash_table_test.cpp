@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// linear_probe_hash_table_test.cpp
+//
+// Identification: test/container/disk/hash/linear_probe_hash_table_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "container/disk/hash/linear_probe_hash_table.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, IncrementalResizeTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 10, HashFunction<int>());
+  size_t initial_size = ht.GetSize();
+
+  // every pair stays visible while the table grows, in whichever layout it is in
+  const int total = 20000;
+  bool resized = false;
+  for (int i = 0; i < total; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+    resized = resized || ht.IsResizing();
+    if (i % 1000 == 999) {
+      for (int j = 0; j <= i; j += 7) {
+        std::vector<int> res;
+        ASSERT_TRUE(ht.GetValue(nullptr, j, &res)) << "key " << j;
+        ASSERT_EQ(res, std::vector<int>{j});
+      }
+    }
+  }
+  ASSERT_TRUE(resized);
+  ASSERT_GE(ht.GetSize(), initial_size * 32);
+  ASSERT_FALSE(ht.Insert(nullptr, 7, 7));
+
+  // a second value per key, and removes of the first, also carry the migration along
+  for (int i = 0; i < total; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, -i - 1));
+  }
+  for (int i = 0; i < total; i += 2) {
+    ASSERT_TRUE(ht.Remove(nullptr, i, i));
+    ASSERT_FALSE(ht.Remove(nullptr, i, i));
+  }
+  for (int i = 0; i < total; i++) {
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+    std::sort(res.begin(), res.end());
+    ASSERT_EQ(res, i % 2 == 0 ? std::vector<int>{-i - 1} : (std::vector<int>{-i - 1, i})) << "key " << i;
+  }
+
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, DirectoryPagesTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  // as many blocks as one header page lists, the next resize needs directory pages
+  using KeyType = int;
+  using ValueType = int;
+  const size_t num_buckets = HASH_TABLE_HEADER_MAX_BLOCKS * BLOCK_ARRAY_SIZE;
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), num_buckets, HashFunction<int>());
+  size_t initial_size = ht.GetSize();
+  const int total = 3000;
+  for (int i = 0; i < total; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  ht.Resize(initial_size);
+  ASSERT_TRUE(ht.IsResizing());
+  ASSERT_EQ(ht.GetSize(), 2 * initial_size);
+
+  // every insert moves a block over, so the old layout is drained by the last of these
+  for (size_t i = 0; i < HASH_TABLE_HEADER_MAX_BLOCKS; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, static_cast<int>(i), -1));
+  }
+  ASSERT_FALSE(ht.IsResizing());
+  for (int i = 0; i < total; i++) {
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+    std::sort(res.begin(), res.end());
+    ASSERT_EQ(res, static_cast<size_t>(i) < HASH_TABLE_HEADER_MAX_BLOCKS ? (std::vector<int>{-1, i})
+                                                                         : std::vector<int>{i})
+        << "key " << i;
+    ASSERT_TRUE(ht.Remove(nullptr, i, i));
+  }
+
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, ConcurrentReadTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 10, HashFunction<int>());
+
+  // readers keep finding the first keys while a writer grows the table under them
+  const int total = 4000;
+  const int stable = 100;
+  for (int i = 0; i < stable; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int tid = 0; tid < 2; tid++) {
+    readers.emplace_back([&] {
+      while (!done) {
+        for (int i = 0; i < stable; i++) {
+          std::vector<int> res;
+          ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+          ASSERT_EQ(res, std::vector<int>{i});
+        }
+      }
+    });
+  }
+  for (int i = stable; i < total; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  delete bpm;
+}
+
+}  // namespace bustub
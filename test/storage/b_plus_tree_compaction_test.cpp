@@ -0,0 +1,269 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_compaction_test.cpp
+//
+// Identification: test/storage/b_plus_tree_compaction_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>  // NOLINT
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using bustub::DiskManagerUnlimitedMemory;
+
+namespace {
+
+using Tree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+using InternalPage = BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
+using LeafPage = BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
+
+// number of leaves, counted along the leaf chain from the leftmost one
+auto CountLeaves(Tree *tree, BufferPoolManager *bpm) -> int {
+  page_id_t page_id = tree->GetRootPageId();
+  if (page_id == INVALID_PAGE_ID) {
+    return 0;
+  }
+  ReadPageGuard guard = bpm->FetchPageRead(page_id);
+  while (!guard.As<BPlusTreePage>()->IsLeafPage()) {
+    page_id = guard.As<InternalPage>()->ValueAt(0);
+    guard = bpm->FetchPageRead(page_id);
+  }
+  int count = 1;
+  while (guard.As<LeafPage>()->GetNextPageId() != INVALID_PAGE_ID) {
+    page_id = guard.As<LeafPage>()->GetNextPageId();
+    guard = bpm->FetchPageRead(page_id);
+    ++count;
+  }
+  return count;
+}
+
+void CheckKeys(Tree *tree, int64_t max_key, const std::function<bool(int64_t)> &present) {
+  GenericKey<8> index_key;
+  std::vector<int64_t> expected;
+  for (int64_t key = 0; key < max_key; key++) {
+    std::vector<RID> rids;
+    index_key.SetFromInteger(key);
+    ASSERT_EQ(tree->GetValue(index_key, &rids), present(key)) << "key " << key;
+    if (present(key)) {
+      ASSERT_EQ(rids[0].GetSlotNum(), key);
+      expected.push_back(key);
+    }
+  }
+
+  std::vector<int64_t> scanned;
+  for (auto it = tree->Begin(); !it.IsEnd(); ++it) {
+    scanned.push_back((*it).second.GetSlotNum());
+  }
+  ASSERT_EQ(scanned, expected);
+
+  scanned.clear();
+  for (auto it = tree->RBegin(); !it.IsEnd(); ++it) {
+    scanned.push_back((*it).second.GetSlotNum());
+  }
+  std::reverse(scanned.begin(), scanned.end());
+  ASSERT_EQ(scanned, expected);
+}
+
+}  // namespace
+
+TEST(BPlusTreeTests, CompactionTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  Tree tree("foo_pk", header_page->GetPageId(), bpm, comparator, 8, 6);
+
+  std::vector<int64_t> keys(3000);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  GenericKey<8> index_key;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, key));
+  }
+  int leaves = CountLeaves(&tree, bpm);
+
+  // removes leave the pages in place
+  for (auto key : keys) {
+    if (key % 10 != 0) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key, nullptr);
+    }
+  }
+  ASSERT_EQ(CountLeaves(&tree, bpm), leaves);
+  CheckKeys(&tree, 3000, [](int64_t key) { return key % 10 == 0; });
+
+  // compaction merges them
+  ASSERT_GT(tree.Compact(0.5), 0);
+  ASSERT_LT(CountLeaves(&tree, bpm), leaves / 4);
+  CheckKeys(&tree, 3000, [](int64_t key) { return key % 10 == 0; });
+  // leaves under parents merged in the last pass may have become mergeable siblings, passes settle quickly
+  int passes = 0;
+  while (tree.Compact(0.5) > 0) {
+    ASSERT_LT(++passes, 5);
+  }
+
+  // the tree still grows after it shrank
+  for (int64_t key = 3000; key < 3500; key++) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, key));
+  }
+  CheckKeys(&tree, 3500, [](int64_t key) { return key % 10 == 0 || key >= 3000; });
+
+  // an empty tree drops its root
+  for (int64_t key = 0; key < 3500; key++) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, nullptr);
+  }
+  ASSERT_FALSE(tree.IsEmpty());
+  while (tree.Compact() > 0) {
+  }
+  ASSERT_TRUE(tree.IsEmpty());
+  CheckKeys(&tree, 3500, [](int64_t key) { return false; });
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
+TEST(BPlusTreeTests, NonUniqueRemoveTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  Tree tree("foo_pk", header_page->GetPageId(), bpm, comparator, 4, 4, false);
+
+  GenericKey<8> index_key;
+  for (int64_t key = 0; key < 50; key++) {
+    index_key.SetFromInteger(key);
+    for (int32_t slot = 0; slot < 5; slot++) {
+      tree.Insert(index_key, RID(static_cast<page_id_t>(key), slot));
+    }
+  }
+
+  // remove single pairs of even keys, every pair of keys divisible by 5
+  for (int64_t key = 0; key < 50; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, RID(static_cast<page_id_t>(key), 1), nullptr);
+    tree.Remove(index_key, RID(static_cast<page_id_t>(key), 3), nullptr);
+  }
+  for (int64_t key = 0; key < 50; key += 5) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, nullptr);
+  }
+  tree.Compact(0.5);
+
+  for (int64_t key = 0; key < 50; key++) {
+    std::vector<RID> rids;
+    index_key.SetFromInteger(key);
+    tree.GetValue(index_key, &rids);
+    std::vector<RID> expected;
+    for (int32_t slot = 0; slot < 5 && key % 5 != 0; slot++) {
+      if (key % 2 != 0 || (slot != 1 && slot != 3)) {
+        expected.emplace_back(static_cast<page_id_t>(key), slot);
+      }
+    }
+    ASSERT_EQ(rids, expected) << "key " << key;
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
+TEST(BPlusTreeTests, BackgroundCompactionTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(100, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  Tree tree("foo_pk", header_page->GetPageId(), bpm, comparator, 8, 6);
+
+  const int64_t total = 4000;
+  GenericKey<8> index_key;
+  for (int64_t key = 0; key < total; key++) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, key));
+  }
+  int leaves = CountLeaves(&tree, bpm);
+
+  auto interval = btree_compaction_interval;
+  btree_compaction_interval = std::chrono::milliseconds(5);
+  tree.StartCompaction(0.5);
+
+  // every fourth key stays, scans and lookups of those run while the others are removed and merged away
+  std::atomic<bool> done{false};
+  std::thread remover([&] {
+    GenericKey<8> key_to_remove;
+    std::vector<int64_t> keys;
+    for (int64_t key = 0; key < total; key++) {
+      if (key % 4 != 0) {
+        keys.push_back(key);
+      }
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+    for (auto key : keys) {
+      key_to_remove.SetFromInteger(key);
+      tree.Remove(key_to_remove, nullptr);
+    }
+    done = true;
+  });
+  std::thread scanner([&] {
+    while (!done) {
+      int64_t last = -1;
+      int64_t kept = 0;
+      for (auto it = tree.Begin(); !it.IsEnd(); ++it) {
+        int64_t key = (*it).second.GetSlotNum();
+        ASSERT_GT(key, last);
+        last = key;
+        kept += key % 4 == 0 ? 1 : 0;
+      }
+      ASSERT_EQ(kept, total / 4);
+    }
+  });
+  std::thread reader([&] {
+    GenericKey<8> key_to_find;
+    while (!done) {
+      for (int64_t key = 0; key < total; key += 4) {
+        std::vector<RID> rids;
+        key_to_find.SetFromInteger(key);
+        ASSERT_TRUE(tree.GetValue(key_to_find, &rids));
+      }
+    }
+  });
+  remover.join();
+  scanner.join();
+  reader.join();
+
+  // give the background thread a chance to see the last removes
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  tree.StopCompaction();
+  btree_compaction_interval = interval;
+  tree.Compact(0.5);
+
+  ASSERT_LT(CountLeaves(&tree, bpm), leaves / 2);
+  CheckKeys(&tree, total, [](int64_t key) { return key % 4 == 0; });
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
+}  // namespace bustub
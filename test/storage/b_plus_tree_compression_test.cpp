@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_compression_test.cpp
+//
+// Identification: test/storage/b_plus_tree_compression_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using bustub::DiskManagerUnlimitedMemory;
+
+// walk down the leftmost path, then count the leaves through the sibling links
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto CountLeaves(BPlusTree<KeyType, ValueType, KeyComparator> *tree, BufferPoolManager *bpm) -> int {
+  page_id_t page_id = tree->GetRootPageId();
+  while (true) {
+    ReadPageGuard guard = bpm->FetchPageRead(page_id);
+    auto page = guard.As<BPlusTreePage>();
+    if (page->IsLeafPage()) {
+      break;
+    }
+    page_id = guard.As<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>()->ValueAt(0);
+  }
+  int leaves = 0;
+  while (page_id != INVALID_PAGE_ID) {
+    ReadPageGuard guard = bpm->FetchPageRead(page_id);
+    page_id = guard.As<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>>()->GetNextPageId();
+    ++leaves;
+  }
+  return leaves;
+}
+
+TEST(BPlusTreeTests, SuffixTruncationTest) {
+  // a bigint in a 64 byte key leaves 56 zero bytes that are not stored
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<64> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  BPlusTree<GenericKey<64>, RID, GenericComparator<64>> tree("foo_pk", header_page->GetPageId(), bpm, comparator);
+  GenericKey<64> index_key;
+  RID rid;
+  auto *transaction = new Transaction(0);
+
+  int64_t scale = 10000;
+  for (int64_t key = 1; key <= scale; key++) {
+    rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.Insert(index_key, rid, transaction));
+  }
+
+  std::vector<RID> rids;
+  for (int64_t key = 1; key <= scale; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.GetValue(index_key, &rids));
+    ASSERT_EQ(rids.size(), 1);
+    ASSERT_EQ(rids[0].GetSlotNum(), key);
+  }
+  index_key.SetFromInteger(scale + 1);
+  rids.clear();
+  EXPECT_FALSE(tree.GetValue(index_key, &rids));
+
+  // uncompressed, a leaf holds at most this many entries
+  int uncompressed_capacity = (BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(std::pair<GenericKey<64>, RID>);
+  EXPECT_LT(CountLeaves(&tree, bpm), scale / uncompressed_capacity);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
+
+TEST(BPlusTreeTests, PrefixCompressionTest) {
+  // composite keys sharing their first two columns, inserted in random order
+  auto key_schema = ParseCreateStatement("a bigint,b bigint,c bigint");
+  GenericComparator<32> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  BPlusTree<GenericKey<32>, RID, GenericComparator<32>> tree("foo_pk", header_page->GetPageId(), bpm, comparator);
+  GenericKey<32> index_key;
+  RID rid;
+  auto *transaction = new Transaction(0);
+
+  auto make_key = [&](int64_t a, int64_t c) {
+    Tuple tuple({Value(TypeId::BIGINT, a), Value(TypeId::BIGINT, a), Value(TypeId::BIGINT, c)}, key_schema.get());
+    index_key.SetFromKey(tuple);
+  };
+
+  int64_t scale = 5000;
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < scale; key++) {
+    keys.push_back(key * 0x10001);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  for (auto key : keys) {
+    rid.Set(0, key & 0xFFFFFFFF);
+    make_key(0x0123456789ABCDEF, key);
+    ASSERT_TRUE(tree.Insert(index_key, rid, transaction));
+  }
+  make_key(0x0123456789ABCDEF, keys[0]);
+  EXPECT_FALSE(tree.Insert(index_key, rid, transaction));
+
+  std::vector<RID> rids;
+  for (auto key : keys) {
+    rids.clear();
+    make_key(0x0123456789ABCDEF, key);
+    ASSERT_TRUE(tree.GetValue(index_key, &rids));
+    ASSERT_EQ(rids.size(), 1);
+    ASSERT_EQ(rids[0].GetSlotNum(), key & 0xFFFFFFFF);
+
+    rids.clear();
+    make_key(0x0123456789ABCDEE, key);
+    ASSERT_FALSE(tree.GetValue(index_key, &rids));
+  }
+
+  int uncompressed_capacity = (BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(std::pair<GenericKey<32>, RID>);
+  EXPECT_LT(CountLeaves(&tree, bpm), scale / uncompressed_capacity);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
+
+}  // namespace bustub
@@ -295,6 +295,63 @@ TEST(BPlusTreeConcurrentTest, DISABLED_DeleteTest2) {
   delete bpm;
 }
 
+TEST(BPlusTreeConcurrentTest, GetValuesInsertTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // small nodes, so that the inserts split leaves and replace the root while the lookups run
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm, comparator, 3, 4);
+  std::vector<int64_t> perserved_keys;
+  std::vector<int64_t> dynamic_keys;
+  for (int64_t i = 1; i <= 2000; i++) {
+    (i % 2 == 0 ? perserved_keys : dynamic_keys).push_back(i);
+  }
+  InsertHelper(&tree, perserved_keys);
+
+  auto lookup_task = [&](int tid) {
+    auto *transaction = new Transaction(static_cast<txn_id_t>(tid));
+    std::vector<GenericKey<8>> keys(perserved_keys.size());
+    for (size_t i = 0; i < perserved_keys.size(); i++) {
+      keys[i].SetFromInteger(perserved_keys[i]);
+    }
+    for (int round = 0; round < 20; round++) {
+      std::vector<std::vector<RID>> results;
+      tree.GetValues(keys, &results, transaction);
+      for (size_t i = 0; i < perserved_keys.size(); i++) {
+        ASSERT_EQ(results[i].size(), 1);
+        ASSERT_EQ(results[i][0].GetSlotNum(), perserved_keys[i]);
+      }
+    }
+    delete transaction;
+  };
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 2; i++) {
+    threads.emplace_back(InsertHelperSplit, &tree, dynamic_keys, 2, i);
+    threads.emplace_back(lookup_task, i);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  int64_t size = 0;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+    size++;
+  }
+  EXPECT_EQ(size, 2000);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
 TEST(BPlusTreeConcurrentTest, DISABLED_MixTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <random>
 
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
@@ -184,4 +185,108 @@ TEST(BPlusTreeTests, nsertTest3) {
   delete transaction;
   delete bpm;
 }
+TEST(BPlusTreeTests, InsertDuplicateTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  // create a non-unique b+ tree, small pages make runs of equal keys span several leaves
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", header_page->GetPageId(), bpm, comparator, 3, 3,
+                                                           false);
+  GenericKey<8> index_key;
+  // create transaction
+  auto *transaction = new Transaction(0);
+
+  std::vector<std::pair<int64_t, RID>> entries;
+  for (int64_t key = 1; key <= 5; key++) {
+    for (int32_t page = 0; page < 10; page++) {
+      entries.emplace_back(key, RID(page, static_cast<uint32_t>(key)));
+    }
+  }
+  std::shuffle(entries.begin(), entries.end(), std::mt19937(15445));
+  for (const auto &[key, rid] : entries) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, rid, transaction));
+  }
+  // only the exact (key, rid) pair is a duplicate
+  index_key.SetFromInteger(3);
+  EXPECT_FALSE(tree.Insert(index_key, RID(4, 3), transaction));
+
+  std::vector<RID> rids;
+  for (int64_t key = 1; key <= 5; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.GetValue(index_key, &rids));
+    ASSERT_EQ(rids.size(), 10);
+    // duplicates come back in rid order
+    for (int32_t page = 0; page < 10; page++) {
+      EXPECT_EQ(rids[page].GetPageId(), page);
+      EXPECT_EQ(rids[page].GetSlotNum(), key);
+    }
+  }
+  rids.clear();
+  index_key.SetFromInteger(6);
+  EXPECT_FALSE(tree.GetValue(index_key, &rids));
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
+TEST(BPlusTreeTests, InsertBatchTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", header_page->GetPageId(), bpm, comparator, 4, 5);
+  GenericKey<8> index_key;
+  // create transaction
+  auto *transaction = new Transaction(0);
+
+  // two batches whose keys interleave, with a duplicate inside the second one
+  for (int64_t start : {0, 1}) {
+    std::vector<std::pair<GenericKey<8>, RID>> entries;
+    for (int64_t key = start; key < 400; key += 2) {
+      index_key.SetFromInteger(key);
+      entries.emplace_back(index_key, RID(0, static_cast<uint32_t>(key)));
+    }
+    if (start == 1) {
+      entries.push_back(entries.back());
+    }
+    std::shuffle(entries.begin(), entries.end(), std::mt19937(15445));
+    EXPECT_EQ(tree.InsertBatch(entries, transaction), 200);
+  }
+
+  std::vector<GenericKey<8>> keys;
+  for (int64_t key = 450; key >= -50; key -= 5) {
+    index_key.SetFromInteger(key);
+    keys.push_back(index_key);
+  }
+  std::vector<std::vector<RID>> results;
+  tree.GetValues(keys, &results, transaction);
+  ASSERT_EQ(results.size(), keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    int64_t key = 450 - static_cast<int64_t>(i) * 5;
+    if (key < 0 || key >= 400) {
+      EXPECT_TRUE(results[i].empty());
+      continue;
+    }
+    ASSERT_EQ(results[i].size(), 1);
+    EXPECT_EQ(results[i][0].GetSlotNum(), key);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
 }  // namespace bustub
@@ -0,0 +1,214 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_iterator_test.cpp
+//
+// Identification: test/storage/b_plus_tree_iterator_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <thread>  // NOLINT
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using bustub::DiskManagerUnlimitedMemory;
+
+TEST(BPlusTreeTests, ReverseScanTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", header_page->GetPageId(), bpm, comparator, 3, 4);
+  GenericKey<8> index_key;
+  RID rid;
+  auto *transaction = new Transaction(0);
+
+  EXPECT_TRUE(tree.Begin() == tree.End());
+  EXPECT_TRUE(tree.RBegin() == tree.End());
+
+  int64_t scale = 500;
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= scale; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  for (auto key : keys) {
+    rid.Set(0, key);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+
+  int64_t current_key = 1;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key++;
+  }
+  EXPECT_EQ(current_key, scale + 1);
+
+  current_key = scale;
+  for (auto iterator = tree.RBegin(); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key--;
+  }
+  EXPECT_EQ(current_key, 0);
+
+  // descending from a key, and from a key that is not in the tree
+  index_key.SetFromInteger(250);
+  current_key = 250;
+  for (auto iterator = tree.RBegin(index_key); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key--;
+  }
+  EXPECT_EQ(current_key, 0);
+  index_key.SetFromInteger(scale + 100);
+  EXPECT_EQ((*tree.RBegin(index_key)).second.GetSlotNum(), scale);
+
+  // bounded ranges in both directions
+  GenericKey<8> bound_key;
+  index_key.SetFromInteger(100);
+  bound_key.SetFromInteger(200);
+  current_key = 100;
+  for (auto iterator = tree.Begin(index_key, bound_key); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key++;
+  }
+  EXPECT_EQ(current_key, 201);
+
+  current_key = 200;
+  for (auto iterator = tree.RBegin(bound_key, index_key); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key--;
+  }
+  EXPECT_EQ(current_key, 99);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
+
+TEST(BPlusTreeTests, BatchScanTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  // non-unique, so that runs of equal keys span leaves
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", header_page->GetPageId(), bpm, comparator, 4, 5,
+                                                           false);
+  GenericKey<8> index_key;
+  RID rid;
+  auto *transaction = new Transaction(0);
+
+  int64_t scale = 100;
+  int64_t copies = 7;
+  for (int64_t copy = copies - 1; copy >= 0; copy--) {
+    for (int64_t key = 0; key < scale; key++) {
+      rid.Set(copy, key);
+      index_key.SetFromInteger(key);
+      ASSERT_TRUE(tree.Insert(index_key, rid, transaction));
+    }
+  }
+
+  std::vector<std::pair<GenericKey<8>, RID>> batch;
+  auto iterator = tree.Begin();
+  size_t batches = 0;
+  while (iterator.NextBatch(&batch)) {
+    ++batches;
+  }
+  EXPECT_TRUE(iterator.IsEnd());
+  ASSERT_EQ(batch.size(), scale * copies);
+  EXPECT_GT(batches, 1);
+  for (size_t i = 0; i < batch.size(); i++) {
+    EXPECT_EQ(batch[i].second.GetSlotNum(), i / copies);
+    EXPECT_EQ(batch[i].second.GetPageId(), i % copies);
+  }
+
+  // every copy of key 50 and below, in descending (key, rid) order
+  batch.clear();
+  index_key.SetFromInteger(50);
+  iterator = tree.RBegin(index_key);
+  while (iterator.NextBatch(&batch)) {
+  }
+  ASSERT_EQ(batch.size(), 51 * copies);
+  for (size_t i = 0; i < batch.size(); i++) {
+    EXPECT_EQ(batch[i].second.GetSlotNum(), 50 - i / copies);
+    EXPECT_EQ(batch[i].second.GetPageId(), copies - 1 - i % copies);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
+
+TEST(BPlusTreeTests, ConcurrentScanTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", header_page->GetPageId(), bpm, comparator, 3, 4);
+
+  // even keys are there from the start, odd keys are inserted while scanning
+  int64_t scale = 1000;
+  for (int64_t key = 0; key < scale; key += 2) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, key));
+  }
+
+  std::thread inserter([&]() {
+    std::vector<int64_t> keys;
+    for (int64_t key = 1; key < scale; key += 2) {
+      keys.push_back(key);
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+    for (auto key : keys) {
+      GenericKey<8> index_key;
+      index_key.SetFromInteger(key);
+      tree.Insert(index_key, RID(0, key));
+    }
+  });
+
+  for (int round = 0; round < 10; round++) {
+    bool reverse = round % 2 == 1;
+    int64_t evens = 0;
+    int64_t last = reverse ? scale : -1;
+    for (auto iterator = reverse ? tree.RBegin() : tree.Begin(); iterator != tree.End(); ++iterator) {
+      int64_t key = (*iterator).second.GetSlotNum();
+      ASSERT_TRUE(reverse ? key < last : key > last);
+      last = key;
+      evens += key % 2 == 0 ? 1 : 0;
+    }
+    EXPECT_EQ(evens, scale / 2);
+  }
+  inserter.join();
+
+  int64_t current_key = scale - 1;
+  for (auto iterator = tree.RBegin(); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key--;
+  }
+  EXPECT_EQ(current_key, -1);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
+}  // namespace bustub
@@ -0,0 +1,173 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffered_tree_test.cpp
+//
+// Identification: test/storage/buffered_tree_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <random>
+#include <set>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/buffered_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using bustub::DiskManagerUnlimitedMemory;
+
+namespace {
+
+using Tree = BufferedTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+void CheckAgainst(Tree *tree, const std::map<int64_t, std::set<int64_t>> &expected, int64_t max_key) {
+  GenericKey<8> index_key;
+  for (int64_t key = 0; key < max_key; key++) {
+    index_key.SetFromInteger(key);
+    std::vector<RID> rids;
+    auto it = expected.find(key);
+    bool found = tree->GetValue(index_key, &rids);
+    if (it == expected.end() || it->second.empty()) {
+      ASSERT_FALSE(found) << "key " << key;
+      continue;
+    }
+    ASSERT_TRUE(found) << "key " << key;
+    ASSERT_EQ(rids.size(), it->second.size()) << "key " << key;
+    auto slot = it->second.begin();
+    for (const auto &rid : rids) {
+      ASSERT_EQ(rid.GetPageId(), key);
+      ASSERT_EQ(rid.GetSlotNum(), *slot++);
+    }
+  }
+}
+
+}  // namespace
+
+TEST(BufferedTreeTests, InsertLookupTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  // small pages, so buffers fill up and leaves and internal pages split
+  Tree tree("foo_pk", header_page->GetPageId(), bpm, comparator, 4, 4);
+  ASSERT_TRUE(tree.IsEmpty());
+
+  std::vector<int64_t> keys(5000);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+
+  std::map<int64_t, std::set<int64_t>> expected;
+  GenericKey<8> index_key;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(static_cast<page_id_t>(key), 0));
+    expected[key].insert(0);
+  }
+  ASSERT_FALSE(tree.IsEmpty());
+  CheckAgainst(&tree, expected, 5500);
+
+  // inserting a present pair again changes nothing
+  for (int64_t key = 0; key < 100; key++) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(static_cast<page_id_t>(key), 0));
+  }
+  CheckAgainst(&tree, expected, 5000);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
+TEST(BufferedTreeTests, DuplicateKeyTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  Tree tree("foo_pk", header_page->GetPageId(), bpm, comparator, 4, 4);
+
+  // every key gets several values, inserted in scattered order
+  std::vector<std::pair<int64_t, int64_t>> entries;
+  for (int64_t key = 0; key < 300; key++) {
+    for (int64_t slot = 0; slot < 1 + key % 7; slot++) {
+      entries.emplace_back(key, slot);
+    }
+  }
+  std::shuffle(entries.begin(), entries.end(), std::mt19937(15445));
+
+  std::map<int64_t, std::set<int64_t>> expected;
+  GenericKey<8> index_key;
+  for (auto [key, slot] : entries) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(static_cast<page_id_t>(key), slot));
+    expected[key].insert(slot);
+  }
+  CheckAgainst(&tree, expected, 300);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
+TEST(BufferedTreeTests, MixedInsertDeleteTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  Tree tree("foo_pk", header_page->GetPageId(), bpm, comparator, 4, 4);
+
+  // deleting from an empty tree is a no-op
+  GenericKey<8> index_key;
+  index_key.SetFromInteger(1);
+  tree.Remove(index_key, RID(1, 0));
+  ASSERT_TRUE(tree.IsEmpty());
+
+  // random operations on a small key space, so that deletes often meet buffered inserts of the same pair
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<int64_t> key_dist(0, 999);
+  std::uniform_int_distribution<int64_t> slot_dist(0, 2);
+  std::map<int64_t, std::set<int64_t>> expected;
+  for (int i = 0; i < 20000; i++) {
+    int64_t key = key_dist(gen);
+    int64_t slot = slot_dist(gen);
+    index_key.SetFromInteger(key);
+    if (gen() % 3 == 0) {
+      tree.Remove(index_key, RID(static_cast<page_id_t>(key), slot));
+      expected[key].erase(slot);
+    } else {
+      tree.Insert(index_key, RID(static_cast<page_id_t>(key), slot));
+      expected[key].insert(slot);
+    }
+    if (i % 5000 == 4999) {
+      CheckAgainst(&tree, expected, 1000);
+    }
+  }
+
+  // remove everything that is left
+  for (const auto &[key, slots] : expected) {
+    index_key.SetFromInteger(key);
+    for (auto slot : slots) {
+      tree.Remove(index_key, RID(static_cast<page_id_t>(key), slot));
+    }
+  }
+  CheckAgainst(&tree, {}, 1000);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
+}  // namespace bustub
@@ -10,27 +10,28 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <memory>
+#include <string>
 #include <vector>
 
+#include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
 #include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tmp_file_manager.h"
 #include "type/value_factory.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(TmpTuplePageTest, DISABLED_BasicTest) {
-  // There are many ways to do this assignment, and this is only one of them.
-  // If you don't like the TmpTuplePage idea, please feel free to delete this test case entirely.
-  // You will get full credit as long as you are correctly using a linear probe hash table.
-
-  TmpTuplePage page{};
+TEST(TmpTuplePageTest, BasicTest) {
+  std::vector<char> data(BUSTUB_PAGE_SIZE);
+  auto page = reinterpret_cast<TmpTuplePage *>(data.data());
   page_id_t page_id = 15445;
-  page.Init(page_id, BUSTUB_PAGE_SIZE);
+  page->Init(page_id, BUSTUB_PAGE_SIZE);
 
-  char *data = page.GetData();
-  ASSERT_EQ(*reinterpret_cast<page_id_t *>(data), page_id);
-  ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + sizeof(page_id_t) + sizeof(lsn_t)), BUSTUB_PAGE_SIZE);
+  ASSERT_EQ(*reinterpret_cast<page_id_t *>(data.data()), page_id);
+  ASSERT_EQ(*reinterpret_cast<uint32_t *>(data.data() + sizeof(page_id_t) + sizeof(lsn_t)), BUSTUB_PAGE_SIZE);
 
   std::vector<Column> columns;
   columns.emplace_back("A", TypeId::INTEGER);
@@ -41,11 +42,77 @@ TEST(TmpTuplePageTest, DISABLED_BasicTest) {
 
   Tuple tuple(values, &schema);
   TmpTuple tmp_tuple(INVALID_PAGE_ID, 0);
-  page.Insert(tuple, &tmp_tuple);
+  ASSERT_TRUE(page->Insert(tuple, &tmp_tuple));
+
+  ASSERT_EQ(*reinterpret_cast<uint32_t *>(data.data() + sizeof(page_id_t) + sizeof(lsn_t)), BUSTUB_PAGE_SIZE - 8);
+  ASSERT_EQ(*reinterpret_cast<uint32_t *>(data.data() + BUSTUB_PAGE_SIZE - 8), 4);
+  ASSERT_EQ(*reinterpret_cast<uint32_t *>(data.data() + BUSTUB_PAGE_SIZE - 4), 123);
+  ASSERT_EQ(tmp_tuple, TmpTuple(page_id, BUSTUB_PAGE_SIZE - 8));
+  ASSERT_EQ(page->GetTuple(tmp_tuple.GetOffset()).GetValue(&schema, 0).GetAs<int32_t>(), 123);
+  ASSERT_EQ(page->GetTupleView(tmp_tuple.GetOffset(), &schema).GetValue(0).GetAs<int32_t>(), 123);
+
+  // the page fills up, and hands its tuples back in the order they came in
+  size_t num_tuples = 1;
+  while (page->Insert(Tuple({ValueFactory::GetIntegerValue(num_tuples)}, &schema), &tmp_tuple)) {
+    num_tuples++;
+  }
+  ASSERT_LT(page->GetFreeSpace(), sizeof(uint32_t) + tuple.GetLength());
+  auto offsets = page->GetTupleOffsets(BUSTUB_PAGE_SIZE);
+  ASSERT_EQ(offsets.size(), num_tuples);
+  ASSERT_EQ(page->GetTuple(offsets[0]).GetValue(&schema, 0).GetAs<int32_t>(), 123);
+  for (size_t i = 1; i < num_tuples; i++) {
+    ASSERT_EQ(page->GetTuple(offsets[i]).GetValue(&schema, 0).GetAs<int32_t>(), i);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(TmpTuplePageTest, TmpFileTest) {
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 200}});
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(5, disk_manager.get());
+  auto make_tuple = [&](int i) {
+    return Tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(100 + i % 50, 'x'))},
+                 &schema);
+  };
+
+  // a file many times the size of the pool spills to disk, and reads back whole
+  TmpFileManager manager(bpm.get());
+  auto file = manager.CreateFile();
+  std::vector<TmpTuple> tmp_tuples;
+  for (int i = 0; i < 1000; i++) {
+    tmp_tuples.push_back(file->Append(make_tuple(i)));
+  }
+  ASSERT_EQ(file->GetNumTuples(), 1000);
+  ASSERT_GT(file->GetNumPages(), 5);
+  ASSERT_EQ(manager.GetNumPages(), file->GetNumPages());
+  std::vector<Tuple> tuples;
+  for (size_t i = 0; i < file->GetNumPages(); i++) {
+    file->ReadPage(i, &tuples);
+  }
+  ASSERT_EQ(tuples.size(), 1000);
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_EQ(tuples[i].GetValue(&schema, 0).GetAs<int32_t>(), i);
+    ASSERT_EQ(tuples[i].GetValue(&schema, 1).ToString(), std::string(100 + i % 50, 'x'));
+  }
+
+  // a tuple is read back from where it is, in place or copied
+  for (int i = 999; i >= 0; i -= 7) {
+    ASSERT_EQ(file->GetTuple(tmp_tuples[i]).GetValue(&schema, 0).GetAs<int32_t>(), i);
+    ReadPageGuard guard;
+    auto view = file->GetTupleView(tmp_tuples[i], &schema, &guard);
+    ASSERT_EQ(view.GetValue(1).ToString(), std::string(100 + i % 50, 'x'));
+  }
+
+  // a tuple larger than a page cannot be spilled
+  Schema wide_schema({Column{"a", TypeId::VARCHAR, 2 * BUSTUB_PAGE_SIZE}});
+  auto other = manager.CreateFile();
+  ASSERT_THROW(other->Append(Tuple({ValueFactory::GetVarcharValue(std::string(BUSTUB_PAGE_SIZE, 'y'))}, &wide_schema)),
+               Exception);
+  manager.DropFile(other);
 
-  ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + sizeof(page_id_t) + sizeof(lsn_t)), BUSTUB_PAGE_SIZE - 8);
-  ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + BUSTUB_PAGE_SIZE - 8), 4);
-  ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + BUSTUB_PAGE_SIZE - 4), 123);
+  // dropping a file frees its pages
+  manager.DropFile(file);
+  ASSERT_EQ(manager.GetNumPages(), 0);
 }
 
 }  // namespace bustub
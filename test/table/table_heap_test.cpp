@@ -0,0 +1,817 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_heap_test.cpp
+//
+// Identification: test/table/table_heap_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/exception.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/tuple.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+auto MakeTuple(const Schema *schema, size_t length) -> Tuple {
+  return Tuple({ValueFactory::GetVarcharValue(std::string(length, 'x'))}, schema);
+}
+
+auto CountPages(TableHeap *table, BufferPoolManager *bpm) -> size_t {
+  size_t count = 0;
+  for (page_id_t page_id = table->GetFirstPageId(); page_id != INVALID_PAGE_ID; count++) {
+    auto guard = bpm->FetchPageRead(page_id);
+    page_id = guard.As<TablePage>()->GetNextPageId();
+  }
+  return count;
+}
+
+auto CountTuples(TableIterator iter) -> size_t {
+  size_t count = 0;
+  for (; !iter.IsEnd(); ++iter) {
+    count++;
+  }
+  return count;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, FreeSpaceReuseTest) {
+  Schema schema({Column{"a", TypeId::VARCHAR, 2000}});
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  auto table = std::make_unique<TableHeap>(bpm.get());
+  const TupleMeta meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+
+  // two large tuples fill a page up to a third
+  for (int i = 0; i < 20; i++) {
+    ASSERT_NE(table->InsertTuple(meta, MakeTuple(&schema, 1500)), std::nullopt);
+  }
+  size_t pages = CountPages(table.get(), bpm.get());
+  ASSERT_EQ(pages, 10);
+
+  // small tuples fill the room the large ones left, from the first page on
+  auto rid = table->InsertTuple(meta, MakeTuple(&schema, 40));
+  ASSERT_EQ(rid->GetPageId(), table->GetFirstPageId());
+  for (int i = 1; i < 100; i++) {
+    ASSERT_NE(table->InsertTuple(meta, MakeTuple(&schema, 40)), std::nullopt);
+  }
+  ASSERT_EQ(CountPages(table.get(), bpm.get()), pages);
+  ASSERT_EQ(CountTuples(table->MakeIterator()), 120);
+
+  // the map is persisted, a table opened again goes on filling the same pages
+  auto reopened = std::make_unique<TableHeap>(bpm.get(), table->GetFirstPageId(), table->GetFreeSpaceMapPageId());
+  table.reset();
+  for (int i = 0; i < 30; i++) {
+    ASSERT_NE(reopened->InsertTuple(meta, MakeTuple(&schema, 40)), std::nullopt);
+  }
+  ASSERT_EQ(CountPages(reopened.get(), bpm.get()), pages);
+  ASSERT_EQ(CountTuples(reopened->MakeIterator()), 150);
+
+  // a tuple that fits nowhere gets a new page
+  ASSERT_NE(reopened->InsertTuple(meta, MakeTuple(&schema, 1500)), std::nullopt);
+  ASSERT_EQ(CountPages(reopened.get(), bpm.get()), pages + 1);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, IteratorStopsAtCreationTest) {
+  Schema schema({Column{"a", TypeId::VARCHAR, 2000}});
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  TableHeap table(bpm.get());
+  const TupleMeta meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+
+  // an empty table has nothing to scan
+  ASSERT_TRUE(table.MakeIterator().IsEnd());
+
+  for (int i = 0; i < 20; i++) {
+    ASSERT_NE(table.InsertTuple(meta, MakeTuple(&schema, 1500)), std::nullopt);
+  }
+
+  // every tuple scanned inserts one more, into the pages before and after the cursor
+  size_t scanned = 0;
+  for (auto iter = table.MakeIterator(); !iter.IsEnd(); ++iter) {
+    ASSERT_NE(table.InsertTuple(meta, MakeTuple(&schema, 40)), std::nullopt);
+    scanned++;
+  }
+  ASSERT_EQ(scanned, 20);
+  ASSERT_EQ(CountTuples(table.MakeEagerIterator()), 40);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, ConcurrentInsertTest) {
+  Schema schema({Column{"a", TypeId::VARCHAR, 2000}});
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  TableHeap table(bpm.get());
+  const TupleMeta meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+
+  // threads insert tuples of their own length, so every tuple read back tells which thread wrote it
+  const int num_threads = 8;
+  const int per_thread = 500;
+  std::vector<std::vector<RID>> rids(num_threads);
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid] {
+      for (int i = 0; i < per_thread; i++) {
+        auto rid = table.InsertTuple(meta, MakeTuple(&schema, 20 + tid));
+        ASSERT_NE(rid, std::nullopt);
+        rids[tid].push_back(*rid);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  std::set<int64_t> seen;
+  for (int tid = 0; tid < num_threads; tid++) {
+    for (const auto &rid : rids[tid]) {
+      ASSERT_TRUE(seen.insert(rid.Get()).second);
+      auto [tuple_meta, tuple] = table.GetTuple(rid);
+      ASSERT_EQ(tuple.GetValue(&schema, 0).ToString().size(), 20 + tid);
+    }
+  }
+  ASSERT_EQ(CountTuples(table.MakeIterator()), num_threads * per_thread);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, BatchInsertTest) {
+  Schema schema({Column{"a", TypeId::VARCHAR, 2000}});
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  auto table = std::make_unique<TableHeap>(bpm.get());
+  const TupleMeta meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+
+  // a page half filled by a single insert
+  ASSERT_NE(table->InsertTuple(meta, MakeTuple(&schema, 2000)), std::nullopt);
+
+  // a batch too large for the hole goes to fresh pages, each filled before the next one is started
+  std::vector<Tuple> tuples;
+  for (int i = 0; i < 300; i++) {
+    tuples.push_back(MakeTuple(&schema, 100 + i % 7));
+  }
+  auto rids = table->InsertTuples(meta, tuples);
+  ASSERT_EQ(rids.size(), tuples.size());
+  ASSERT_NE(rids[0].GetPageId(), table->GetFirstPageId());
+  std::vector<page_id_t> page_ids{rids[0].GetPageId()};
+  for (size_t i = 1; i < rids.size(); i++) {
+    if (rids[i].GetPageId() == rids[i - 1].GetPageId()) {
+      ASSERT_EQ(rids[i].GetSlotNum(), rids[i - 1].GetSlotNum() + 1);
+    } else {
+      page_ids.push_back(rids[i].GetPageId());
+    }
+  }
+  std::set<page_id_t> distinct(page_ids.begin(), page_ids.end());
+  ASSERT_EQ(distinct.size(), page_ids.size());
+  ASSERT_LT(page_ids.size(), 12);
+  distinct.insert(table->GetFirstPageId());
+  size_t pages = CountPages(table.get(), bpm.get());
+  ASSERT_EQ(pages, distinct.size());
+
+  for (size_t i = 0; i < rids.size(); i++) {
+    auto [tuple_meta, tuple] = table->GetTuple(rids[i]);
+    ASSERT_FALSE(tuple_meta.is_deleted_);
+    ASSERT_EQ(tuple.GetValue(&schema, 0).ToString(), std::string(100 + i % 7, 'x'));
+  }
+  ASSERT_EQ(CountTuples(table->MakeIterator()), 301);
+
+  // a small batch fits the holes left behind
+  rids = table->InsertTuples(meta, std::vector<Tuple>(5, MakeTuple(&schema, 40)));
+  ASSERT_EQ(rids.size(), 5);
+  ASSERT_EQ(CountPages(table.get(), bpm.get()), pages);
+  ASSERT_EQ(CountTuples(table->MakeIterator()), 306);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, VacuumTest) {
+  Schema schema({Column{"a", TypeId::VARCHAR, 2000}});
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  auto table = std::make_unique<TableHeap>(bpm.get());
+  const TupleMeta meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+  const TupleMeta deleted{INVALID_TXN_ID, INVALID_TXN_ID, true};
+
+  std::vector<RID> rids;
+  for (int i = 0; i < 200; i++) {
+    rids.push_back(*table->InsertTuple(meta, MakeTuple(&schema, 100 + i % 3)));
+  }
+  size_t pages = CountPages(table.get(), bpm.get());
+
+  // deletes only mark the tuples, the room comes back once the pages are vacuumed
+  for (int i = 0; i < 200; i++) {
+    if (i % 4 != 0) {
+      table->UpdateTupleMeta(deleted, rids[i]);
+    }
+  }
+  // a delete that has not committed may still be rolled back, so vacuum keeps the tuple
+  table->UpdateTupleMeta({INVALID_TXN_ID, 7, true}, rids[4]);
+  ASSERT_GT(table->Vacuum(1), 0);
+  ASSERT_GT(table->Vacuum(), 0);
+  ASSERT_EQ(table->Vacuum(), 0);
+  table->UpdateTupleMeta(meta, rids[4]);
+
+  // the tuples left keep their rids, the vacuumed ones their slots
+  for (int i = 0; i < 200; i++) {
+    auto [tuple_meta, tuple] = table->GetTuple(rids[i]);
+    ASSERT_EQ(tuple_meta.is_deleted_, i % 4 != 0);
+    if (i % 4 == 0) {
+      ASSERT_EQ(tuple.GetValue(&schema, 0).ToString(), std::string(100 + i % 3, 'x'));
+    }
+  }
+  ASSERT_THROW(table->UpdateTupleMeta(meta, rids[1]), Exception);
+  ASSERT_EQ(CountTuples(table->MakeIterator()), 200);
+
+  // and new tuples fill the room
+  for (int i = 0; i < 100; i++) {
+    ASSERT_NE(table->InsertTuple(meta, MakeTuple(&schema, 100)), std::nullopt);
+  }
+  ASSERT_EQ(CountPages(table.get(), bpm.get()), pages);
+
+  // background vacuum picks up deletes by itself
+  auto interval = table_vacuum_interval;
+  table_vacuum_interval = std::chrono::milliseconds(5);
+  table->StartVacuum();
+  for (int i = 0; i < 200; i += 4) {
+    table->UpdateTupleMeta(deleted, rids[i]);
+  }
+  for (int tries = 0; tries < 200 && table->GetTuple(rids[0]).second.GetLength() > 0; tries++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  table->StopVacuum();
+  table_vacuum_interval = interval;
+  ASSERT_EQ(table->GetTuple(rids[0]).second.GetLength(), 0);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, PageAtATimeIteratorTest) {
+  Schema schema({Column{"a", TypeId::VARCHAR, 2000}});
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  TableHeap table(bpm.get());
+  const TupleMeta meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+
+  // tuples of one size fill the pages one after the other, so rid order is insert order
+  std::vector<RID> rids;
+  for (int i = 0; i < 300; i++) {
+    rids.push_back(*table.InsertTuple(meta, MakeTuple(&schema, 80)));
+  }
+  for (int i = 0; i < 300; i += 3) {
+    table.UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[i]);
+  }
+
+  // tuple by tuple, every tuple is returned with its meta
+  size_t index = 0;
+  for (auto iter = table.MakeIterator(); !iter.IsEnd(); ++iter, ++index) {
+    ASSERT_EQ(iter.GetRID(), rids[index]);
+    auto [tuple_meta, tuple] = iter.GetTuple();
+    ASSERT_EQ(tuple.GetRid(), rids[index]);
+    ASSERT_EQ(tuple_meta.is_deleted_, index % 3 == 0);
+  }
+  ASSERT_EQ(index, 300);
+
+  // page by page, the tuples not deleted come in rid order, and the scan picks up where ++ left off
+  auto iter = table.MakeIterator();
+  ++iter;
+  std::vector<Tuple> tuples;
+  size_t pages = 0;
+  while (iter.NextPage(&tuples)) {
+    pages++;
+  }
+  ASSERT_EQ(pages, CountPages(&table, bpm.get()));
+  ASSERT_EQ(tuples.size(), 200);
+  index = 1;
+  for (const auto &tuple : tuples) {
+    ASSERT_EQ(tuple.GetRid(), rids[index]);
+    ASSERT_EQ(tuple.GetValue(&schema, 0).ToString(), std::string(80, 'x'));
+    index += index % 3 == 2 ? 2 : 1;
+  }
+  ASSERT_TRUE(iter.IsEnd());
+  ASSERT_FALSE(iter.NextPage(&tuples));
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, PartitionedIteratorTest) {
+  Schema schema({Column{"a", TypeId::VARCHAR, 2000}});
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  TableHeap table(bpm.get());
+  const TupleMeta meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+  std::vector<RID> rids;
+  for (int i = 0; i < 300; i++) {
+    rids.push_back(*table.InsertTuple(meta, MakeTuple(&schema, 80)));
+  }
+  size_t num_pages = CountPages(&table, bpm.get());
+
+  // the partitions scan disjoint ranges of pages in threads of their own, and every tuple once between them
+  auto iterators = table.MakePartitionedIterators(4);
+  ASSERT_EQ(iterators.size(), 4);
+  table.InsertTuple(meta, MakeTuple(&schema, 80));
+  std::vector<std::vector<Tuple>> partitions(iterators.size());
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < iterators.size(); i++) {
+    threads.emplace_back([&, i] {
+      while (iterators[i].NextPage(&partitions[i])) {
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  std::vector<RID> scanned;
+  for (const auto &partition : partitions) {
+    ASSERT_FALSE(partition.empty());
+    for (const auto &tuple : partition) {
+      scanned.push_back(tuple.GetRid());
+    }
+  }
+  ASSERT_EQ(scanned, rids);
+
+  // with more partitions than pages, some of them have nothing to scan
+  size_t count = 0;
+  size_t empty = 0;
+  for (auto &iter : table.MakePartitionedIterators(num_pages + 3)) {
+    empty += iter.IsEnd() ? 1 : 0;
+    for (; !iter.IsEnd(); ++iter) {
+      count++;
+    }
+  }
+  ASSERT_EQ(empty, 3);
+  ASSERT_EQ(count, 301);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, TupleViewTest) {
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 100}});
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  TableHeap table(bpm.get());
+  const TupleMeta meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+
+  std::vector<RID> rids;
+  for (int i = 0; i < 500; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(i % 20, 'y'))}, &schema);
+    rids.push_back(*table.InsertTuple(meta, tuple));
+  }
+
+  // a view reads the values in the page, and copies out the same tuple a read does
+  {
+    auto guard = bpm->FetchPageRead(rids[7].GetPageId());
+    auto [view_meta, view] = guard.As<TablePage>()->GetTupleView(rids[7], &schema);
+    ASSERT_FALSE(view_meta.is_deleted_);
+    ASSERT_EQ(view.GetRid(), rids[7]);
+    ASSERT_EQ(view.GetValue(0).GetAs<int32_t>(), 7);
+    ASSERT_EQ(view.GetValue(1).ToString(), std::string(7, 'y'));
+    auto copy = view.ToTuple();
+    auto [read_meta, read] = table.GetTuple(rids[7]);
+    ASSERT_EQ(copy.GetRid(), read.GetRid());
+    ASSERT_EQ(std::string(copy.GetData(), copy.GetLength()), std::string(read.GetData(), read.GetLength()));
+  }
+
+  // a scan copies out only the tuples it keeps
+  std::vector<Tuple> tuples;
+  auto iter = table.MakeIterator();
+  auto keep = [](const TupleView &view) { return view.GetValue(0).GetAs<int32_t>() % 10 == 3; };
+  while (iter.NextPage(&tuples, &schema, keep)) {
+  }
+  ASSERT_EQ(tuples.size(), 50);
+  std::set<int32_t> kept;
+  for (const auto &tuple : tuples) {
+    auto value = tuple.GetValue(&schema, 0).GetAs<int32_t>();
+    ASSERT_EQ(value % 10, 3);
+    ASSERT_EQ(tuple.GetRid(), rids[value]);
+    ASSERT_EQ(tuple.GetValue(&schema, 1).ToString(), std::string(value % 20, 'y'));
+    kept.insert(value);
+  }
+  ASSERT_EQ(kept.size(), 50);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, PaxTableTest) {
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 40}, Column{"c", TypeId::BIGINT}});
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  TableHeap table(bpm.get(), TableFormat::Pax, &schema);
+  const TupleMeta meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+
+  // every seventh tuple has nulls in b and c
+  auto make_tuple = [&](int i) {
+    bool null = i % 7 == 0;
+    return Tuple({ValueFactory::GetIntegerValue(i),
+                  null ? ValueFactory::GetNullValueByType(TypeId::VARCHAR)
+                       : ValueFactory::GetVarcharValue(std::string(i % 30, 'z')),
+                  null ? ValueFactory::GetNullValueByType(TypeId::BIGINT) : ValueFactory::GetBigIntValue(i * 3L)},
+                 &schema);
+  };
+  auto check_tuple = [&](const Tuple &tuple, int i) {
+    ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), i);
+    ASSERT_EQ(tuple.GetValue(&schema, 1).IsNull(), i % 7 == 0);
+    ASSERT_EQ(tuple.GetValue(&schema, 2).IsNull(), i % 7 == 0);
+    if (i % 7 != 0) {
+      ASSERT_EQ(tuple.GetValue(&schema, 1).ToString(), std::string(i % 30, 'z'));
+      ASSERT_EQ(tuple.GetValue(&schema, 2).GetAs<int64_t>(), i * 3L);
+    }
+  };
+
+  std::vector<Tuple> batch;
+  for (int i = 0; i < 1000; i++) {
+    batch.push_back(make_tuple(i));
+  }
+  auto rids = table.InsertTuples(meta, batch);
+  for (int i = 1000; i < 1200; i++) {
+    rids.push_back(*table.InsertTuple(meta, make_tuple(i)));
+  }
+  ASSERT_GT(CountPages(&table, bpm.get()), 1);
+  for (int i = 0; i < 1200; i++) {
+    auto [read_meta, tuple] = table.GetTuple(rids[i]);
+    ASSERT_EQ(tuple.GetRid(), rids[i]);
+    check_tuple(tuple, i);
+  }
+  {
+    auto guard = bpm->FetchPageRead(rids[14].GetPageId());
+    auto page = guard.As<PaxPage>();
+    ASSERT_TRUE(page->IsNull(schema, 1, rids[14].GetSlotNum()));
+    ASSERT_FALSE(page->IsNull(schema, 1, rids[15].GetSlotNum()));
+    ASSERT_EQ(page->GetValue(schema, 2, rids[15].GetSlotNum()).GetAs<int64_t>(), 45);
+  }
+
+  // a column read takes single columns out of the pages, and skips deleted tuples
+  for (int i = 0; i < 1200; i += 2) {
+    table.UpdateTupleMeta({INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[i]);
+  }
+  std::vector<std::vector<Value>> columns(2);
+  std::vector<RID> scanned;
+  auto iter = table.MakeIterator();
+  while (iter.NextPageColumns(schema, {2, 0}, &columns, &scanned)) {
+  }
+  ASSERT_EQ(scanned.size(), 600);
+  ASSERT_EQ(columns[0].size(), 600);
+  for (size_t i = 0; i < scanned.size(); i++) {
+    auto a = columns[1][i].GetAs<int32_t>();
+    ASSERT_EQ(a % 2, 1);
+    ASSERT_EQ(scanned[i], rids[a]);
+    ASSERT_EQ(columns[0][i].IsNull(), a % 7 == 0);
+  }
+
+  // vacuum drops the varchars of the deleted tuples, and the room goes to new ones
+  ASSERT_GT(table.Vacuum(), 0);
+  for (int i = 1; i < 1200; i += 2) {
+    check_tuple(table.GetTuple(rids[i]).second, i);
+  }
+  ASSERT_THROW(table.UpdateTupleMeta(meta, rids[2]), Exception);
+  std::vector<Tuple> tuples;
+  auto keep = [](const TupleView &view) { return view.GetValue(0).GetAs<int32_t>() < 100; };
+  auto view_iter = table.MakeIterator();
+  while (view_iter.NextPage(&tuples, &schema, keep)) {
+  }
+  ASSERT_EQ(tuples.size(), 50);
+  for (const auto &tuple : tuples) {
+    check_tuple(tuple, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, ZoneMapTest) {
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 100}, Column{"c", TypeId::INTEGER}});
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  TableHeap table(bpm.get(), TableFormat::Row, &schema);
+  const TupleMeta meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+
+  // a grows with the insert order, c is null in the first half
+  std::vector<RID> rids;
+  for (int i = 0; i < 2000; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(40, 'q')),
+                 i < 1000 ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(-i)},
+                &schema);
+    rids.push_back(*table.InsertTuple(meta, tuple));
+  }
+  auto pages = CountPages(&table, bpm.get());
+  ASSERT_GT(pages, 20);
+
+  // the summary of a page covers exactly the tuples in it
+  auto page_index = pages / 2;
+  int32_t min = INT32_MAX;
+  int32_t max = INT32_MIN;
+  uint32_t nulls = 0;
+  auto page_id = rids[0].GetPageId();
+  for (size_t i = 0; i < page_index; i++) {
+    page_id = bpm->FetchPageRead(page_id).As<TablePage>()->GetNextPageId();
+  }
+  for (int i = 0; i < 2000; i++) {
+    if (rids[i].GetPageId() == page_id) {
+      min = std::min(min, i);
+      max = std::max(max, i);
+      nulls += i < 1000 ? 1 : 0;
+    }
+  }
+  ASSERT_TRUE(table.PageMayMatch(page_index, [&](const PageZone &zone) {
+    EXPECT_TRUE(zone.GetColumn(0).tracked_);
+    EXPECT_FALSE(zone.GetColumn(1).tracked_);
+    EXPECT_EQ(zone.GetColumn(0).min_->GetAs<int32_t>(), min);
+    EXPECT_EQ(zone.GetColumn(0).max_->GetAs<int32_t>(), max);
+    EXPECT_EQ(zone.GetColumn(0).null_count_, 0);
+    EXPECT_EQ(zone.GetColumn(2).null_count_, nulls);
+    return true;
+  }));
+
+  // a scan for the last tuples only reads the pages that may hold them
+  size_t pages_read = 0;
+  std::vector<Tuple> tuples;
+  auto iter = table.MakeIterator();
+  iter.SetPageFilter([&](const PageZone &zone) { return zone.GetColumn(0).max_->GetAs<int32_t>() >= 1900; });
+  while (iter.NextPage(&tuples)) {
+    pages_read++;
+  }
+  ASSERT_LT(pages_read, pages / 5);
+  std::set<int32_t> found;
+  for (const auto &tuple : tuples) {
+    found.insert(tuple.GetValue(&schema, 0).GetAs<int32_t>());
+  }
+  for (int i = 1900; i < 2000; i++) {
+    ASSERT_EQ(found.count(i), 1);
+  }
+
+  // updates widen the summary, and a reopened table summarizes its pages again
+  Tuple updated({ValueFactory::GetIntegerValue(5000), ValueFactory::GetVarcharValue(std::string(40, 'q')),
+                 ValueFactory::GetIntegerValue(0)},
+                &schema);
+  table.UpdateTupleInPlaceUnsafe(meta, updated, rids[0]);
+  auto reopened = std::make_unique<TableHeap>(bpm.get(), table.GetFirstPageId(), table.GetFreeSpaceMapPageId(),
+                                              TableFormat::Row, &schema);
+  auto widened = [](const PageZone &zone) { return zone.GetColumn(0).max_->GetAs<int32_t>() == 5000; };
+  ASSERT_TRUE(table.PageMayMatch(0, widened));
+  ASSERT_TRUE(reopened->PageMayMatch(0, widened));
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, ToastTest) {
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 100000}, Column{"c", TypeId::VARCHAR, 10}});
+  const TupleMeta meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+  // every third tuple has a value in b that does not fit in a page
+  auto make_b = [](int i) { return std::string(i % 3 == 0 ? 10000 + i : 10 + i, static_cast<char>('a' + i % 26)); };
+  auto make_tuple = [&](int i) {
+    return Tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(make_b(i)),
+                  ValueFactory::GetVarcharValue(std::to_string(i))},
+                 &schema);
+  };
+
+  for (auto format : {TableFormat::Row, TableFormat::Pax}) {
+    auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+    auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+    TableHeap table(bpm.get(), format, &schema);
+    std::vector<RID> rids;
+    for (int i = 0; i < 30; i++) {
+      rids.push_back(*table.InsertTuple(meta, make_tuple(i)));
+    }
+    std::vector<Tuple> batch;
+    for (int i = 30; i < 60; i++) {
+      batch.push_back(make_tuple(i));
+    }
+    auto batch_rids = table.InsertTuples(meta, batch);
+    rids.insert(rids.end(), batch_rids.begin(), batch_rids.end());
+
+    // the row in the page only holds a pointer to the large value
+    if (format == TableFormat::Row) {
+      auto guard = bpm->FetchPageRead(rids[3].GetPageId());
+      ASSERT_LT(guard.As<TablePage>()->GetTuple(rids[3]).second.GetLength(), 100);
+    }
+    for (int i = 0; i < 60; i++) {
+      auto tuple = table.GetTuple(rids[i]).second;
+      ASSERT_EQ(tuple.GetValue(&schema, 1).ToString(), make_b(i));
+      ASSERT_EQ(tuple.GetValue(&schema, 2).ToString(), std::to_string(i));
+    }
+
+    // scans read the large values back, a filter only when it looks at them
+    std::vector<Tuple> tuples;
+    auto iter = table.MakeIterator();
+    auto keep = [](const TupleView &view) { return view.GetValue(0).GetAs<int32_t>() % 2 == 0; };
+    while (iter.NextPage(&tuples, &schema, keep)) {
+    }
+    ASSERT_EQ(tuples.size(), 30);
+    for (const auto &tuple : tuples) {
+      ASSERT_EQ(tuple.GetValue(&schema, 1).ToString(), make_b(tuple.GetValue(&schema, 0).GetAs<int32_t>()));
+    }
+    tuples.clear();
+    auto filter_iter = table.MakeIterator();
+    filter_iter.SetEqualityFilter({{1, ValueFactory::GetVarcharValue(make_b(9))}});
+    auto keep_b = [&](const TupleView &view) { return view.GetValue(1).ToString() == make_b(9); };
+    while (filter_iter.NextPage(&tuples, &schema, keep_b)) {
+    }
+    ASSERT_EQ(tuples.size(), 1);
+    ASSERT_EQ(tuples[0].GetRid(), rids[9]);
+    std::vector<std::vector<Value>> columns(2);
+    auto column_iter = table.MakeIterator();
+    while (column_iter.NextPageColumns(schema, {1, 2}, &columns)) {
+    }
+    ASSERT_EQ(columns[0].size(), 60);
+    for (size_t i = 0; i < columns[0].size(); i++) {
+      ASSERT_EQ(columns[0][i].ToString(), make_b(std::stoi(columns[1][i].ToString())));
+    }
+    auto tuple_iter = table.MakeIterator();
+    ASSERT_EQ(tuple_iter.GetTuple().second.GetValue(&schema, 1).ToString(), make_b(0));
+
+    // updates and vacuum free the overflow pages of the values they drop
+    Tuple updated({ValueFactory::GetIntegerValue(0), ValueFactory::GetVarcharValue(make_b(33)),
+                   ValueFactory::GetVarcharValue("0")},
+                  &schema);
+    table.UpdateTupleInPlaceUnsafe(meta, updated, rids[0]);
+    ASSERT_EQ(table.GetTuple(rids[0]).second.GetValue(&schema, 1).ToString(), make_b(33));
+    for (int i = 0; i < 60; i += 2) {
+      table.UpdateTupleMeta({INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[i]);
+    }
+    table.Vacuum();
+    for (int i = 1; i < 60; i += 2) {
+      ASSERT_EQ(table.GetTuple(rids[i]).second.GetValue(&schema, 1).ToString(), make_b(i));
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, ForwardingTest) {
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 1000}});
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  TableHeap table(bpm.get(), TableFormat::Row, &schema);
+  const TupleMeta meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+  auto make_tuple = [&](int i, size_t length) {
+    return Tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(length, 'f'))},
+                 &schema);
+  };
+  std::vector<RID> rids;
+  for (int i = 0; i < 100; i++) {
+    rids.push_back(*table.InsertTuple(meta, make_tuple(i, 100)));
+  }
+  auto first_page_id = rids[0].GetPageId();
+  auto is_forwarded = [&](RID rid) {
+    auto guard = bpm->FetchPageRead(rid.GetPageId());
+    return guard.As<TablePage>()->GetForward(rid).has_value();
+  };
+  auto check_scans = [&](size_t expected) {
+    std::vector<Tuple> tuples;
+    auto keep = [](const TupleView &view) { return view.GetValue(0).GetAs<int32_t>() >= 0; };
+    auto iter = table.MakeIterator();
+    while (iter.NextPage(&tuples, &schema, keep)) {
+    }
+    ASSERT_EQ(tuples.size(), expected);
+    std::set<int32_t> seen;
+    for (const auto &tuple : tuples) {
+      auto a = tuple.GetValue(&schema, 0).GetAs<int32_t>();
+      ASSERT_TRUE(seen.insert(a).second);
+      ASSERT_EQ(tuple.GetRid(), rids[a]);
+    }
+    size_t count = 0;
+    for (auto tuple_iter = table.MakeIterator(); !tuple_iter.IsEnd(); ++tuple_iter) {
+      auto [tuple_meta, tuple] = tuple_iter.GetTuple();
+      if (!tuple_meta.is_deleted_) {
+        ASSERT_EQ(tuple.GetRid(), rids[tuple.GetValue(&schema, 0).GetAs<int32_t>()]);
+        count++;
+      }
+    }
+    ASSERT_EQ(count, expected);
+    std::vector<std::vector<Value>> columns(1);
+    auto column_iter = table.MakeIterator();
+    while (column_iter.NextPageColumns(schema, {1}, &columns)) {
+    }
+    ASSERT_EQ(columns[0].size(), expected);
+  };
+
+  // a tuple that shrinks or grows within the room of its page stays in it
+  table.UpdateTupleInPlaceUnsafe(meta, make_tuple(0, 40), rids[0]);
+  table.UpdateTupleInPlaceUnsafe(meta, make_tuple(1, 150), rids[1]);
+  ASSERT_EQ(table.GetTuple(rids[0]).second.GetValue(&schema, 1).ToString(), std::string(40, 'f'));
+  ASSERT_EQ(table.GetTuple(rids[1]).second.GetValue(&schema, 1).ToString(), std::string(150, 'f'));
+  ASSERT_FALSE(is_forwarded(rids[1]));
+  for (int i = 2; i < 100; i++) {
+    ASSERT_EQ(table.GetTuple(rids[i]).second.GetValue(&schema, 1).ToString(), std::string(100, 'f'));
+  }
+
+  // one that outgrows it moves, and keeps its rid
+  table.UpdateTupleInPlaceUnsafe(meta, make_tuple(2, 900), rids[2]);
+  ASSERT_EQ(rids[2].GetPageId(), first_page_id);
+  ASSERT_TRUE(is_forwarded(rids[2]));
+  ASSERT_EQ(table.GetTuple(rids[2]).second.GetValue(&schema, 1).ToString(), std::string(900, 'f'));
+  check_scans(100);
+  table.UpdateTupleInPlaceUnsafe(meta, make_tuple(2, 950), rids[2]);
+  ASSERT_EQ(table.GetTuple(rids[2]).second.GetValue(&schema, 1).ToString(), std::string(950, 'f'));
+  check_scans(100);
+
+  // and comes back once it fits again
+  table.UpdateTupleInPlaceUnsafe(meta, make_tuple(2, 10), rids[2]);
+  ASSERT_FALSE(is_forwarded(rids[2]));
+  ASSERT_EQ(table.GetTuple(rids[2]).second.GetValue(&schema, 1).ToString(), std::string(10, 'f'));
+  check_scans(100);
+
+  // a moved tuple is deleted and vacuumed with its slot
+  table.UpdateTupleInPlaceUnsafe(meta, make_tuple(3, 900), rids[3]);
+  ASSERT_TRUE(is_forwarded(rids[3]));
+  table.UpdateTupleMeta({INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[3]);
+  table.Vacuum();
+  check_scans(99);
+  table.UpdateTupleInPlaceUnsafe(meta, make_tuple(4, 900), rids[4]);
+  auto reopened = std::make_unique<TableHeap>(bpm.get(), table.GetFirstPageId(), table.GetFreeSpaceMapPageId(),
+                                              TableFormat::Row, &schema);
+  ASSERT_EQ(reopened->GetTuple(rids[4]).second.GetValue(&schema, 1).ToString(), std::string(900, 'f'));
+
+  // a PAX page grows a varchar in its free space, and does not move the tuple
+  TableHeap pax_table(bpm.get(), TableFormat::Pax, &schema);
+  auto pax_rid = *pax_table.InsertTuple(meta, make_tuple(0, 10));
+  pax_table.UpdateTupleInPlaceUnsafe(meta, make_tuple(0, 500), pax_rid);
+  ASSERT_EQ(pax_table.GetTuple(pax_rid).second.GetValue(&schema, 1).ToString(), std::string(500, 'f'));
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, PaxEncodingTest) {
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 20}, Column{"c", TypeId::BIGINT}});
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  TableHeap table(bpm.get(), TableFormat::Pax, &schema);
+  const TupleMeta meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+  const std::vector<std::string> cities{"amsterdam-noord-xx", "berlin-kreuzberg-x", "copenhagen-norrebr"};
+
+  auto make_tuple = [&](int i, int64_t c) {
+    return Tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(cities[i % 3]),
+                  ValueFactory::GetBigIntValue(c)},
+                 &schema);
+  };
+  std::vector<RID> rids;
+  for (int i = 0; i < 1000; i++) {
+    rids.push_back(*table.InsertTuple(meta, make_tuple(i, 10L * i)));
+  }
+
+  // the integers are stored as small codes, and the varchars once per page, so a page fills every row it has
+  {
+    auto guard = bpm->FetchPageRead(rids[0].GetPageId());
+    auto page = guard.As<PaxPage>();
+    ASSERT_EQ(page->GetEncoding(0).encoding_, PaxEncoding::FrameOfReference);
+    ASSERT_EQ(page->GetEncoding(0).width_, 2);
+    ASSERT_EQ(page->GetEncoding(1).encoding_, PaxEncoding::Dictionary);
+    ASSERT_EQ(page->GetEncoding(2).encoding_, PaxEncoding::FrameOfReference);
+    ASSERT_EQ(page->GetNumTuples(), page->GetCapacity());
+  }
+
+  // a value too far from the base makes its column plain in that page
+  auto far_rid = *table.InsertTuple(meta, make_tuple(1000, 1L << 40));
+  rids.push_back(far_rid);
+  {
+    auto guard = bpm->FetchPageRead(far_rid.GetPageId());
+    auto page = guard.As<PaxPage>();
+    ASSERT_EQ(page->GetEncoding(2).encoding_, PaxEncoding::Plain);
+    ASSERT_EQ(page->GetEncoding(0).encoding_, PaxEncoding::FrameOfReference);
+  }
+  for (int i = 0; i <= 1000; i++) {
+    auto tuple = table.GetTuple(rids[i]).second;
+    ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), i);
+    ASSERT_EQ(tuple.GetValue(&schema, 1).ToString(), cities[i % 3]);
+    ASSERT_EQ(tuple.GetValue(&schema, 2).GetAs<int64_t>(), i == 1000 ? 1L << 40 : 10L * i);
+  }
+
+  // equality filters are matched on the codes and the offsets of the varchars
+  auto count_matches = [&](std::vector<std::pair<uint32_t, Value>> filter) {
+    std::vector<Tuple> tuples;
+    auto iter = table.MakeIterator();
+    iter.SetEqualityFilter(std::move(filter));
+    while (iter.NextPage(&tuples)) {
+    }
+    return tuples.size();
+  };
+  ASSERT_EQ(count_matches({{1, ValueFactory::GetVarcharValue(cities[1])}}), 334);
+  ASSERT_EQ(count_matches({{1, ValueFactory::GetVarcharValue("berlin")}}), 0);
+  ASSERT_EQ(count_matches({{0, ValueFactory::GetIntegerValue(700)}}), 1);
+  ASSERT_EQ(count_matches({{0, ValueFactory::GetIntegerValue(1 << 30)}}), 0);
+  ASSERT_EQ(count_matches({{2, ValueFactory::GetBigIntValue(1L << 40)}, {1, ValueFactory::GetVarcharValue(cities[1])}}),
+            1);
+  ASSERT_EQ(count_matches({{0, ValueFactory::GetNullValueByType(TypeId::INTEGER)}}), 0);
+
+  // an update may point a varchar at one the page has, and vacuum keeps the shared ones
+  table.UpdateTupleInPlaceUnsafe(meta, make_tuple(3, 30), rids[1]);
+  ASSERT_EQ(table.GetTuple(rids[1]).second.GetValue(&schema, 1).ToString(), cities[0]);
+  for (int i = 0; i < 1000; i += 3) {
+    table.UpdateTupleMeta({INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[i]);
+  }
+  table.Vacuum();
+  for (int i = 1; i <= 1000; i++) {
+    if (i % 3 != 0) {
+      ASSERT_EQ(table.GetTuple(rids[i]).second.GetValue(&schema, 1).ToString(), cities[i == 1 ? 0 : i % 3]);
+    }
+  }
+  ASSERT_EQ(count_matches({{1, ValueFactory::GetVarcharValue(cities[0])}}), 1);
+}
+
+}  // namespace bustub
@@ -42,6 +42,7 @@ static const size_t KEY_MODIFY_RANGE = 2048;
 struct BTreeTotalMetrics {
   uint64_t write_cnt_{0};
   uint64_t read_cnt_{0};
+  uint64_t read_ns_{0};
   uint64_t start_time_{0};
   std::mutex mutex_;
 
@@ -52,9 +53,10 @@ struct BTreeTotalMetrics {
     write_cnt_ += scan_cnt;
   }
 
-  void ReportRead(uint64_t get_cnt) {
+  void ReportRead(uint64_t get_cnt, uint64_t get_ns) {
     std::unique_lock<std::mutex> l(mutex_);
     read_cnt_ += get_cnt;
+    read_ns_ += get_ns;
   }
 
   void Report() {
@@ -66,6 +68,7 @@ struct BTreeTotalMetrics {
     fmt::print("<<< BEGIN\n");
     fmt::print("write: {}\n", write_per_sec);
     fmt::print("read: {}\n", read_per_sec);
+    fmt::print("read_latency_ns: {}\n", read_cnt_ == 0 ? 0 : read_ns_ / read_cnt_);
     fmt::print(">>> END\n");
   }
 };
@@ -157,6 +160,21 @@ auto main(int argc, char **argv) -> int {
     index.Insert(index_key, rid, nullptr);
   }
 
+  // uncontended lookups, the cost of a single root-to-leaf descent
+  {
+    bustub::GenericKey<8> index_key;
+    std::vector<bustub::RID> rids;
+    auto lookup_start = std::chrono::steady_clock::now();
+    for (size_t key = 0; key < TOTAL_KEYS; key++) {
+      rids.clear();
+      index_key.SetFromInteger(key);
+      index.GetValue(index_key, &rids);
+    }
+    auto lookup_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - lookup_start).count();
+    fmt::print(stderr, "[info] single thread lookup: {} ns/op\n", lookup_ns / TOTAL_KEYS);
+  }
+
   fmt::print(stderr, "[info] benchmark start\n");
 
   BTreeTotalMetrics total_metrics;
@@ -177,6 +195,7 @@ auto main(int argc, char **argv) -> int {
 
       bustub::GenericKey<8> index_key;
       std::vector<bustub::RID> rids;
+      uint64_t get_ns = 0;
 
       while (!metrics.ShouldFinish()) {
         auto base_key = dis(gen);
@@ -184,7 +203,10 @@ auto main(int argc, char **argv) -> int {
         for (auto key = base_key; key < key_end && cnt < KEY_MODIFY_RANGE; key++, cnt++) {
           rids.clear();
           index_key.SetFromInteger(key);
+          auto get_start = std::chrono::steady_clock::now();
           index.GetValue(index_key, &rids);
+          get_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - get_start)
+                        .count();
 
           if (!KeyWillVanish(key) && rids.empty()) {
             std::string msg = fmt::format("key not found: {}", key);
@@ -206,7 +228,7 @@ auto main(int argc, char **argv) -> int {
         }
       }
 
-      total_metrics.ReportRead(metrics.cnt_);
+      total_metrics.ReportRead(metrics.cnt_, get_ns);
     }));
   }
 